@@ -1,6 +1,9 @@
 // https://godbolt.org/z/zGafK8fz5
 #include "Application.hpp"
 #include <string_view>
+#include <string>
+#include <charconv>
+#include <chrono>
 #include <array>
 #include <expected>
 #include <bitset>
@@ -9,16 +12,30 @@
 #include <exception>
 #include <format>
 #include <filesystem>
+#include <memory>
+#include <limits>
+#include <utility>
 #include <cstdio>
 #include <cstdlib>
+#include <cstdint>
+#include <cstddef>
 #include <fmt/core.h>
 #include <spdlog/spdlog.h>
-#include <spdlog/sinks/basic_file_sink.h>
 #include <glib.h>
+#include "AsyncLogging.hpp"
+#include "BidirectionalMultimessageSimulation.hpp"
+#include "ChannelFaults.hpp"
+#include "ReliableTransport.hpp"
+#include "Scenario.hpp"
+#include "StatisticsPublisher.hpp"
+#include "Sweep.hpp"
+#include "Topology.hpp"
+#include "TrafficSource.hpp"
 #include "Util.hpp"
 
 
 using std::size_t;
+using simple_network_simulation::util::get_basic_logger;
 
 namespace simple_network_simulation
 {
@@ -28,28 +45,62 @@ namespace
 
 using std::string_view_literals::operator""sv;
 
-constexpr auto options_with_args_count { 5uz };
+constexpr auto options_with_args_count { 23uz };
 
 constexpr auto init_file_long_option { "--init-file="sv };
 constexpr auto layers_delays_on_long_option { "--layers-delays=on"sv };
 constexpr auto layers_delays_off_long_option { "--layers-delays=off"sv };
 constexpr auto channel_faults_on_long_option { "--channel-faults=on"sv };
 constexpr auto channel_faults_off_long_option { "--channel-faults=off"sv };
-
-constexpr auto options_without_args_count { 4uz };
+constexpr auto round_trips_long_option { "--round-trips="sv };
+constexpr auto time_budget_long_option { "--time-budget="sv };
+constexpr auto traffic_long_option { "--traffic="sv };
+constexpr auto nodes_long_option { "--nodes="sv };
+constexpr auto processes_long_option { "--processes="sv };
+constexpr auto threads_long_option { "--threads="sv };
+constexpr auto node_cpus_long_option { "--node-cpus="sv };
+constexpr auto forward_channel_long_option { "--forward-channel="sv };
+constexpr auto backward_channel_long_option { "--backward-channel="sv };
+constexpr auto arq_long_option { "--arq="sv };
+constexpr auto no_arq_option { "--arq=none"sv };
+constexpr auto reorder_fault_name { "reorder"sv };
+constexpr auto window_long_option { "--window="sv };
+constexpr auto trace_file_long_option { "--trace-file="sv };
+constexpr auto trace_size_long_option { "--trace-size="sv };
+constexpr auto stats_shm_long_option { "--stats-shm="sv };
+constexpr auto seed_long_option { "--seed="sv };
+constexpr auto sweep_long_option { "--sweep="sv };
+constexpr auto confidence_width_long_option { "--confidence-width="sv };
+constexpr auto replications_long_option { "--replications="sv };
+
+constexpr auto options_without_args_count { 9uz };
 
 constexpr auto layers_delays_on_short_option { "-d"sv };
 constexpr auto channel_faults_on_short_option { "-f"sv };
 constexpr auto display_help_option { "--help"sv };
 constexpr auto display_version_option { "--version"sv };
+constexpr auto quiet_option { "--quiet"sv };
+constexpr auto bench_option { "--bench"sv };
+constexpr auto pipeline_option { "--pipeline"sv };
+constexpr auto multiprocess_option { "--multiprocess"sv };
+constexpr auto real_time_option { "--real-time"sv };
 
 constexpr auto options_total_count { options_with_args_count + options_without_args_count };
 
 constexpr std::array supported_cli_options { init_file_long_option,
                                              layers_delays_on_long_option, layers_delays_off_long_option,
                                              channel_faults_on_long_option, channel_faults_off_long_option,
+                                             round_trips_long_option, time_budget_long_option, traffic_long_option,
+                                             nodes_long_option, processes_long_option, threads_long_option, node_cpus_long_option,
+                                             forward_channel_long_option, backward_channel_long_option,
+                                             arq_long_option, window_long_option,
+                                             trace_file_long_option, trace_size_long_option, stats_shm_long_option,
+                                             seed_long_option,
+                                             sweep_long_option, confidence_width_long_option, replications_long_option,
                                              layers_delays_on_short_option, channel_faults_on_short_option,
-                                             display_help_option, display_version_option };
+                                             display_help_option, display_version_option,
+                                             quiet_option, bench_option, pipeline_option, multiprocess_option,
+                                             real_time_option };
 
 static_assert( std::size( supported_cli_options ) == options_total_count );
 
@@ -61,6 +112,93 @@ constexpr auto options_without_args_end { std::next( options_without_args_begin,
 constexpr std::span supported_cli_options_with_args { options_with_args_begin, options_with_args_count };
 constexpr std::span supported_cli_options_without_args { options_without_args_begin, options_without_args_count };
 
+template <class Integer>
+[[ nodiscard ]] std::expected<Integer, std::errc>
+parse_option_argument( const std::string_view option, const std::string_view option_name ) noexcept
+{
+    const auto argument { option.substr( std::size( option_name ) ) };
+    const auto argument_end { std::data( argument ) + std::size( argument ) };
+
+    Integer value { };
+    const auto [ ptr, err_code ] { std::from_chars( std::data( argument ), argument_end, value ) };
+
+    if ( err_code != std::errc { } )
+    {
+        return std::unexpected { err_code };
+    }
+
+    if ( std::empty( argument ) || ptr != argument_end )
+    {
+        return std::unexpected { std::errc::invalid_argument };
+    }
+
+    return value;
+}
+
+void
+report_invalid_option_argument( const std::string_view option,
+                                const std::error_condition& initialization_result_code ) noexcept
+{
+    constexpr auto invalid_argument_message { "invalid argument for command-line option"sv };
+    constexpr auto guiding_message { "See ‘--help’ for more info on how to use the program"sv };
+
+    get_basic_logger( ).error( "{}", invalid_argument_message );
+    try
+    {
+        fmt::print( stderr, "\n{0}: error: {1}: {2} ‘{3}’\n{4}\n\n",
+                    application_name, initialization_result_code.value( ),
+                    invalid_argument_message, option, guiding_message );
+    }
+    catch ( const std::exception& ex )
+    {
+        get_basic_logger( ).error( "{}", ex.what( ) );
+    }
+}
+
+void
+report_invalid_option_combination( const std::string_view first_option, const std::string_view second_option,
+                                   const std::error_condition& initialization_result_code ) noexcept
+{
+    constexpr auto invalid_combination_message { "invalid combination of command-line options"sv };
+    constexpr auto guiding_message { "See ‘--help’ for more info on how to use the program"sv };
+
+    get_basic_logger( ).error( "{}", invalid_combination_message );
+    try
+    {
+        fmt::print( stderr, "\n{0}: error: {1}: {2} ‘{3}’ and ‘{4}’\n{5}\n\n",
+                    application_name, initialization_result_code.value( ),
+                    invalid_combination_message, first_option, second_option, guiding_message );
+    }
+    catch ( const std::exception& ex )
+    {
+        get_basic_logger( ).error( "{}", ex.what( ) );
+    }
+}
+
+void
+report_invalid_scenario( const std::string_view filename, const scenario_error_t& error ) noexcept
+{
+    constexpr auto invalid_scenario_message { "invalid scenario in initialization file"sv };
+
+    get_basic_logger( ).error( "{}", invalid_scenario_message );
+    try
+    {
+        // Without a line the file could not be read at all, and the reason lies with the system.
+        const auto location { error.line_num == 0 ? fmt::format( "‘{}’", filename )
+                                                  : fmt::format( "‘{}’, line {}", filename, error.line_num ) };
+        const auto reason { error.line_num == 0 ? std::make_error_code( error.error_code ).message( )
+                                                : std::string { error.reason } };
+
+        fmt::print( stderr, "\n{0}: error: {1}: {2} {3}: {4}\n\n",
+                    application_name, std::to_underlying( error.error_code ),
+                    invalid_scenario_message, location, reason );
+    }
+    catch ( const std::exception& ex )
+    {
+        get_basic_logger( ).error( "{}", ex.what( ) );
+    }
+}
+
 }
 
 void
@@ -69,10 +207,17 @@ display_help( )
     fmt::print( stdout,
 R"(Usage: {0} [OPTION]...
 Perform a bidirectional multi-message network
-simulation (between 4 processes across 2 nodes).
+simulation (between 4 processes across 2 nodes
+unless specified otherwise).
 Example: ./{0} --channel-faults=on
 
 Options:
+      --init-file=PATH        load the nodes, processes, ports, delays,
+                              connections, faults of the channel and
+                              payload scripts of the processes from the
+                              scenario file at PATH instead of generating
+                              them (see the README for its format)
+
   -d, --layers-delays=on      add delays to the execution of the layers by
                               putting them to sleep for short amounts of time
       --layers-delays=off     do not add delays to the execution of the layers
@@ -85,6 +230,118 @@ Options:
       --channel-faults=off    set the channel to have no faults
                               (enabled by default)
 
+      --quiet                 do not trace the layers on the console
+      --bench                 run the connections headless over and over and
+                              only report the aggregate throughput at the end
+      --pipeline              run the benchmark as a pipeline of one thread per
+                              layer, handing the messages and segments of
+                              the connections on through lock-free rings, so
+                              that the layers work on different connections
+                              at once (incompatible with --arq)
+      --multiprocess          run the benchmark with the odd-numbered nodes in
+                              this process and the even-numbered ones in a
+                              process of their own, handing the segments
+                              across through lock-free rings in shared
+                              memory under /dev/shm (incompatible with --arq
+                              and --trace-file)
+      --node-cpus=CPU1,CPU2   pin the two processes of --multiprocess to the
+                              cores CPU1 and CPU2
+      --round-trips=N         stop each benchmarked connection after N round
+                              trips (defaults to 1000000 if no budget is given)
+      --time-budget=SECONDS   stop the benchmark after SECONDS of wall-clock time
+      --traffic=SPEC          run the benchmark open-loop: send the requests of
+                              each connection on the schedule of a traffic
+                              source, whether or not the previous responses
+                              are back, for --time-budget (10 s by default),
+                              and report the latencies from the schedule as
+                              well as from the send; SPEC is a comma-
+                              separated list of KEY=VALUE pairs:
+                                source  cbr, poisson (the default) or onoff
+                                rate    requests per second per connection
+                                on      mean on period of onoff in ms (10)
+                                off     mean off period of onoff in ms (90)
+                              e.g. --traffic=source=poisson,rate=20000
+
+      --nodes=N               simulate N nodes, connected in pairs (node1 with
+                              node2, node3 with node4, ...); N must be even
+      --processes=M           run M processes on each node, each of which
+                              opens or accepts one connection with a process
+                              of the paired node
+      --threads=N             execute the connections on a pool of N worker
+                              threads (defaults to the number of hardware
+                              threads); a connection running in real time
+                              holds its worker while its layers sleep
+
+      --forward-channel=SPEC  impair the channel from the processes opening
+      --backward-channel=SPEC the connections to the ones accepting them (or
+                              the other way round) as per SPEC, a comma-
+                              separated list of KEY=PROBABILITY pairs:
+                                ber          flip each bit independently
+                                burst-enter  enter an error burst at a bit
+                                burst-exit   leave the burst at a bit
+                                burst-ber    flip each bit during a burst
+                                loss         lose a segment, which closes
+                                             its connection unless --arq
+                                             is given
+                                duplicate    deliver a segment twice
+                                reorder      swap a segment with the next,
+                                             which takes an --arq other
+                                             than none
+                              e.g. --forward-channel=ber=1e-4,loss=0.001
+      --arq=PROTOCOL          carry the messages over a reliable transport
+                              that acknowledges the segments and resends the
+                              lost and corrupt ones as per PROTOCOL, one of
+                              stop-and-wait, go-back-n or selective-repeat
+                              (or none, the default)
+      --window=N              keep up to N messages in flight per direction
+                              of a connection, at most and by default the
+                              widest window the protocol allows: 1 for
+                              stop-and-wait, 7 for go-back-n and 4 for
+                              selective-repeat
+
+      --trace-file=PATH       record every segment that the transport layers
+                              encode and decode and that crosses the channel
+                              into a binary trace at PATH, to be read with
+                              sns-trace-dump
+      --trace-size=MIB        cap the trace file at MIB mebibytes (256 by
+                              default); the segments past that are counted
+                              and dropped
+      --stats-shm=NAME        publish the counts of the events and the calls
+                              into the layers (and their latencies, if they
+                              are recorded) to the shared-memory segment
+                              NAME every 100 ms while the run goes on, to be
+                              watched with sns-top NAME
+
+      --seed=N                draw the faults of the channel from streams keyed
+                              on N, so that the same N reproduces the same
+                              faults and statistics on any number of threads
+                              (a random seed is drawn and reported otherwise)
+
+      --sweep=SPEC            run every combination of the parameters in SPEC,
+                              a comma-separated list of KEY=VALUES with the
+                              keys model (ber, burst, loss, duplicate or
+                              reorder), p (the probability that drives the
+                              model), delays (off or on), connections, arq
+                              and window; VALUES is a slash-separated list
+                              or a range FROM..TO, FROM..TO:STEP or
+                              FROM..TO:xFACTOR, e.g.
+                              --sweep=model=ber/loss,p=1e-4..1e-1:x10
+                              Each point runs independent replications in
+                              parallel and reports their mean goodput and
+                              round-trip latency with 95% confidence
+                              intervals and the undetected corruptions
+      --confidence-width=W    move on from a point of the sweep once the
+                              confidence interval of its goodput is at most
+                              W wide (defaults to 0.01)
+      --replications=N        run at most N replications per point of the
+                              sweep (defaults to 10000)
+
+      --real-time             let the layers' delays pass on the wall clock
+                              instead of on the simulated clock of the
+                              discrete-event engine (which executes the
+                              connections at full speed and reports the
+                              simulated timestamps and latencies)
+
       --help       display this help and exit
       --version    output version information and exit
 
@@ -118,13 +375,6 @@ Developed by Kasra Hashemi.
     util::flush_stdout( );
 }
 
-
-void
-set_layers_delays( const bool layers_delays_status ) noexcept;
-
-void
-set_channel_faults( const bool channel_faults_status ) noexcept;
-
 }
 
 [[ nodiscard ]] std::expected< decltype( supported_cli_options )::const_iterator,
@@ -381,7 +631,7 @@ initialize_program( const std::span<const char* const> command_line_arguments )
         {
             if ( pos != 0 )
             {
-                spdlog::get( "basic_logger" )->error( "{}", unrecognized_option_message );
+                get_basic_logger( ).error( "{}", unrecognized_option_message );
                 initialization_result_code = std::errc::invalid_argument;
                 try
                 {
@@ -391,7 +641,7 @@ initialize_program( const std::span<const char* const> command_line_arguments )
                 }
                 catch ( const std::exception& ex )
                 {
-                    spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+                    get_basic_logger( ).error( "{}", ex.what( ) );
                 }
 
                 break;
@@ -401,7 +651,7 @@ initialize_program( const std::span<const char* const> command_line_arguments )
                  std::empty( filename ) )
             {
                 constexpr auto no_filename_specified_message { "no init-file name/path specified"sv };
-                spdlog::get( "basic_logger" )->error( "{}", no_filename_specified_message );
+                get_basic_logger( ).error( "{}", no_filename_specified_message );
                 initialization_result_code = std::errc::invalid_argument;
                 constexpr auto instructing_message { "please specify an initialization file"sv };
                 try
@@ -412,54 +662,56 @@ initialize_program( const std::span<const char* const> command_line_arguments )
                 }
                 catch ( const std::exception& ex )
                 {
-                    spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+                    get_basic_logger( ).error( "{}", ex.what( ) );
                 }
 
                 break;
             }
             else
             {
-                std::filesystem::path filepath { };
                 try
                 {
-                    filepath = std::filesystem::path { filename };
-
-                    if ( !std::filesystem::exists( filepath ) )
-                    {
-                    }
-                    else if ( !std::filesystem::is_regular_file( filepath ) )
-                    {
-                    }
-                    else if ( !filepath.has_filename( ) )
-                    {
-                    }
-                    else if ( filepath.extension() != "" && filepath.extension() != ".txt" )
-                    {
-                    }
-                    else
+                    if ( auto scenario { sns::load_scenario( std::filesystem::path { filename } ) };
+                         scenario.has_value( ) )
                     {
-                        std::ifstream file_stream { filepath };
-                        if ( !file_stream.is_open( ) )
+                        if ( scenario->forward_fault_model.has_value( ) )
                         {
+                            sns::set_channel_fault_model( sns::channel_direction_t::forward,
+                                                          *scenario->forward_fault_model );
                         }
 
-                        
+                        if ( scenario->backward_fault_model.has_value( ) )
+                        {
+                            sns::set_channel_fault_model( sns::channel_direction_t::backward,
+                                                          *scenario->backward_fault_model );
+                        }
+
+                        sns::set_topology( std::move( scenario->topology ) );
+                    }
+                    else
+                    {
+                        initialization_result_code = scenario.error( ).error_code;
+                        report_invalid_scenario( filename, scenario.error( ) );
                     }
                 }
                 catch ( const std::exception& ex )
                 {
-                    spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+                    get_basic_logger( ).error( "{}", ex.what( ) );
+                    initialization_result_code = std::errc::not_enough_memory;
                     try
                     {
                         fmt::print( stderr, "\nSomething went wrong!\n\n" );
                     }
                     catch ( const std::exception& exc )
                     {
-                        spdlog::get( "basic_logger" )->error( "{}", exc.what( ) );
+                        get_basic_logger( ).error( "{}", exc.what( ) );
                     }
                 }
 
-                break;
+                if ( initialization_result_code )
+                {
+                    break;
+                }
             }
         }
         else if ( option == layers_delays_on_short_arg || option == layers_delays_on_long_arg )
@@ -478,11 +730,323 @@ initialize_program( const std::span<const char* const> command_line_arguments )
         {
             sns::set_channel_faults( false );
         }
+        else if ( option == quiet_option )
+        {
+            sns::set_tracing( false );
+        }
+        else if ( option == real_time_option )
+        {
+            sns::set_virtual_time( false );
+        }
+        else if ( option == bench_option )
+        {
+            sns::set_tracing( false );
+            sns::set_execution_mode( sns::execution_mode_t::benchmark );
+        }
+        else if ( option == multiprocess_option )
+        {
+            sns::set_tracing( false );
+            sns::set_execution_mode( sns::execution_mode_t::multiprocess_benchmark );
+        }
+        else if ( option == pipeline_option )
+        {
+            sns::set_tracing( false );
+            sns::set_execution_mode( sns::execution_mode_t::pipelined_benchmark );
+        }
+        else if ( option.starts_with( traffic_long_option ) )
+        {
+            if ( const auto traffic_model { sns::parse_traffic_model( option.substr( std::size( traffic_long_option ) ) ) };
+                 traffic_model.has_value( ) )
+            {
+                sns::set_tracing( false );
+                sns::set_execution_mode( sns::execution_mode_t::open_loop_benchmark );
+                sns::set_traffic_model( *traffic_model );
+            }
+            else
+            {
+                initialization_result_code = traffic_model.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( round_trips_long_option ) )
+        {
+            if ( const auto round_trips { parse_option_argument<std::uint64_t>( option, round_trips_long_option ) };
+                 round_trips.has_value( ) )
+            {
+                sns::set_benchmark_round_trips_budget( *round_trips );
+            }
+            else
+            {
+                initialization_result_code = round_trips.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( nodes_long_option ) )
+        {
+            const auto node_count { parse_option_argument<std::uint32_t>( option, nodes_long_option ) };
+            const auto validation_result { node_count.has_value( ) ? sns::validate_node_count( *node_count )
+                                                                   : node_count.error( ) };
+
+            if ( validation_result == std::errc { } )
+            {
+                sns::set_node_count( *node_count );
+            }
+            else
+            {
+                initialization_result_code = validation_result;
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( processes_long_option ) )
+        {
+            const auto process_count { parse_option_argument<std::uint32_t>( option, processes_long_option ) };
+            const auto validation_result { process_count.has_value( ) ?
+                                           sns::validate_processes_per_node( *process_count ) : process_count.error( ) };
+
+            if ( validation_result == std::errc { } )
+            {
+                sns::set_processes_per_node( *process_count );
+            }
+            else
+            {
+                initialization_result_code = validation_result;
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( node_cpus_long_option ) )
+        {
+            const auto argument { option.substr( std::size( node_cpus_long_option ) ) };
+            const auto separator_pos { argument.find( ',' ) };
+            const auto first_cpu { parse_option_argument<std::uint32_t>( argument.substr( 0, separator_pos ), ""sv ) };
+            const auto second_cpu { separator_pos == std::string_view::npos
+                                    ? std::expected<std::uint32_t, std::errc> { std::unexpected { std::errc::invalid_argument } }
+                                    : parse_option_argument<std::uint32_t>( argument.substr( separator_pos + 1 ), ""sv ) };
+
+            if ( first_cpu.has_value( ) && second_cpu.has_value( ) )
+            {
+                sns::set_node_cpus( { *first_cpu, *second_cpu } );
+            }
+            else
+            {
+                initialization_result_code = first_cpu.has_value( ) ? second_cpu.error( ) : first_cpu.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( threads_long_option ) )
+        {
+            if ( const auto thread_count { parse_option_argument<std::size_t>( option, threads_long_option ) };
+                 thread_count.has_value( ) && *thread_count > 0 )
+            {
+                sns::set_thread_count( *thread_count );
+            }
+            else
+            {
+                initialization_result_code = thread_count.has_value( ) ? std::errc::argument_out_of_domain
+                                                                       : thread_count.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( forward_channel_long_option ) ||
+                  option.starts_with( backward_channel_long_option ) )
+        {
+            const bool is_forward { option.starts_with( forward_channel_long_option ) };
+            const auto channel_long_option { is_forward ? forward_channel_long_option : backward_channel_long_option };
+            const auto specification { option.substr( std::size( channel_long_option ) ) };
+
+            if ( const auto fault_model { sns::parse_channel_fault_model( specification ) };
+                 fault_model.has_value( ) )
+            {
+                sns::set_channel_fault_model( is_forward ? sns::channel_direction_t::forward
+                                                         : sns::channel_direction_t::backward, *fault_model );
+            }
+            else
+            {
+                initialization_result_code = fault_model.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( arq_long_option ) )
+        {
+            if ( const auto arq_protocol { sns::parse_arq_protocol( option.substr( std::size( arq_long_option ) ) ) };
+                 arq_protocol.has_value( ) )
+            {
+                sns::set_arq_protocol( *arq_protocol );
+            }
+            else
+            {
+                initialization_result_code = arq_protocol.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( window_long_option ) )
+        {
+            const auto window_size { parse_option_argument<std::uint32_t>( option, window_long_option ) };
+            const auto validation_result { window_size.has_value( ) ? sns::validate_arq_window_size( *window_size )
+                                                                    : window_size.error( ) };
+
+            if ( validation_result == std::errc { } )
+            {
+                sns::set_arq_window_size( *window_size );
+            }
+            else
+            {
+                initialization_result_code = validation_result;
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( sweep_long_option ) )
+        {
+            if ( auto sweep { sns::parse_sweep_specification( option.substr( std::size( sweep_long_option ) ) ) };
+                 sweep.has_value( ) )
+            {
+                sns::set_tracing( false );
+                sns::set_execution_mode( sns::execution_mode_t::sweep );
+                sns::set_sweep_specification( std::move( *sweep ) );
+            }
+            else
+            {
+                initialization_result_code = sweep.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( confidence_width_long_option ) )
+        {
+            if ( const auto width { parse_option_argument<double>( option, confidence_width_long_option ) };
+                 width.has_value( ) && *width > 0.0 )
+            {
+                sns::set_sweep_confidence_width( *width );
+            }
+            else
+            {
+                initialization_result_code = width.has_value( ) ? std::errc::argument_out_of_domain : width.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( replications_long_option ) )
+        {
+            if ( const auto replication_count { parse_option_argument<std::uint32_t>( option, replications_long_option ) };
+                 replication_count.has_value( ) && *replication_count > 0 )
+            {
+                sns::set_sweep_max_replication_count( *replication_count );
+            }
+            else
+            {
+                initialization_result_code = replication_count.has_value( ) ? std::errc::argument_out_of_domain
+                                                                            : replication_count.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( seed_long_option ) )
+        {
+            if ( const auto seed { parse_option_argument<std::uint64_t>( option, seed_long_option ) };
+                 seed.has_value( ) )
+            {
+                sns::set_random_seed( *seed );
+            }
+            else
+            {
+                initialization_result_code = seed.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( trace_file_long_option ) )
+        {
+            if ( const auto path { option.substr( std::size( trace_file_long_option ) ) };
+                 std::empty( path ) == false )
+            {
+                sns::set_binary_trace_path( path );
+            }
+            else
+            {
+                initialization_result_code = std::errc::invalid_argument;
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( stats_shm_long_option ) )
+        {
+            // The name of a segment takes a single leading slash, if any, and no other.
+            if ( const auto name { option.substr( std::size( stats_shm_long_option ) ) };
+                 std::empty( name ) == false && name != "/"sv && name.find( '/', 1 ) == std::string_view::npos )
+            {
+                sns::set_statistics_region_name( name );
+            }
+            else
+            {
+                initialization_result_code = std::errc::invalid_argument;
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( trace_size_long_option ) )
+        {
+            constexpr auto max_trace_size_mib { std::numeric_limits<std::size_t>::max( ) >> 20 };
+
+            if ( const auto size_mib { parse_option_argument<std::size_t>( option, trace_size_long_option ) };
+                 size_mib.has_value( ) && *size_mib > 0 && *size_mib <= max_trace_size_mib )
+            {
+                sns::set_binary_trace_size( *size_mib << 20 );
+            }
+            else
+            {
+                initialization_result_code = size_mib.has_value( ) ? std::errc::argument_out_of_domain
+                                                                    : size_mib.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
+        else if ( option.starts_with( time_budget_long_option ) )
+        {
+            using seconds_rep = std::chrono::seconds::rep;
+
+            if ( const auto seconds { parse_option_argument<seconds_rep>( option, time_budget_long_option ) };
+                 seconds.has_value( ) && *seconds >= 0 )
+            {
+                sns::set_benchmark_time_budget( std::chrono::seconds { *seconds } );
+            }
+            else
+            {
+                initialization_result_code = seconds.has_value( ) ? std::errc::argument_out_of_domain
+                                                                  : seconds.error( );
+                report_invalid_option_argument( option, initialization_result_code );
+
+                break;
+            }
+        }
         else if ( option == display_version_arg )
         {
             if ( std::size( command_line_options ) > 1 )
             {
-                spdlog::get( "basic_logger" )->error( "{}", invalid_combination_message );
+                get_basic_logger( ).error( "{}", invalid_combination_message );
                 initialization_result_code = std::errc::invalid_argument;
                 try
                 {
@@ -492,7 +1056,7 @@ initialize_program( const std::span<const char* const> command_line_arguments )
                 }
                 catch ( const std::exception& ex )
                 {
-                    spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+                    get_basic_logger( ).error( "{}", ex.what( ) );
                 }
 
                 break;
@@ -504,14 +1068,14 @@ initialize_program( const std::span<const char* const> command_line_arguments )
             }
             catch ( const std::exception& ex )
             {
-                spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+                get_basic_logger( ).error( "{}", ex.what( ) );
                 try
                 {
                     fmt::print( stderr, "\nSomething went wrong!\n\n" );
                 }
                 catch ( const std::exception& exc )
                 {
-                    spdlog::get( "basic_logger" )->error( "{}", exc.what( ) );
+                    get_basic_logger( ).error( "{}", exc.what( ) );
                 }
 
                 initialization_result_code = std::errc::io_error;
@@ -528,14 +1092,14 @@ initialize_program( const std::span<const char* const> command_line_arguments )
             }
             catch ( const std::exception& ex )
             {
-                spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+                get_basic_logger( ).error( "{}", ex.what( ) );
                 try
                 {
                     fmt::print( stderr, "\nSomething went wrong!\n\n" );
                 }
                 catch ( const std::exception& exc )
                 {
-                    spdlog::get( "basic_logger" )->error( "{}", exc.what( ) );
+                    get_basic_logger( ).error( "{}", exc.what( ) );
                 }
 
                 initialization_result_code = std::errc::io_error;
@@ -545,7 +1109,7 @@ initialize_program( const std::span<const char* const> command_line_arguments )
         }
         else
         {
-            spdlog::get( "basic_logger" )->error( "{}", unrecognized_option_message );
+            get_basic_logger( ).error( "{}", unrecognized_option_message );
             initialization_result_code = std::errc::invalid_argument;
             try
             {
@@ -555,13 +1119,51 @@ initialize_program( const std::span<const char* const> command_line_arguments )
             }
             catch ( const std::exception& ex )
             {
-                spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+                get_basic_logger( ).error( "{}", ex.what( ) );
             }
 
             break;
         }
     }
 
+    namespace sns = simple_network_simulation;
+
+    const auto execution_mode { sns::get_execution_mode( ) };
+
+    // The pipeline and the multiprocess benchmark carry the plain dialogue, one message in
+    // flight per connection, which leaves no room for the windows of the reliable transport.
+    if ( !initialization_result_code &&
+         ( execution_mode == sns::execution_mode_t::pipelined_benchmark ||
+           execution_mode == sns::execution_mode_t::multiprocess_benchmark ) &&
+         sns::get_arq_protocol( ) != sns::arq_protocol_t::none )
+    {
+        initialization_result_code = std::errc::invalid_argument;
+        report_invalid_option_combination( execution_mode == sns::execution_mode_t::pipelined_benchmark
+                                           ? pipeline_option : multiprocess_option,
+                                           arq_long_option, initialization_result_code );
+    }
+
+    // --window is parsed before the protocol is known, so that it can only be checked against
+    // the protocol here. A sweep skips the windows that are too wide for its protocols.
+    if ( !initialization_result_code && execution_mode != sns::execution_mode_t::sweep &&
+         sns::get_arq_window_size( ) > sns::get_max_arq_window_size( sns::get_arq_protocol( ) ) )
+    {
+        initialization_result_code = std::errc::value_too_large;
+        report_invalid_option_combination( window_long_option, arq_long_option, initialization_result_code );
+    }
+
+    // Without a reliable transport a connection has a single segment in flight, which
+    // nothing can overtake, so a reordering channel would only report reorderings that
+    // never happen. A sweep pairs its reordering points with the reliable transports only.
+    if ( !initialization_result_code && execution_mode != sns::execution_mode_t::sweep &&
+         sns::get_arq_protocol( ) == sns::arq_protocol_t::none &&
+         ( sns::get_channel_fault_model( sns::channel_direction_t::forward ).reordering_probability > 0.0 ||
+           sns::get_channel_fault_model( sns::channel_direction_t::backward ).reordering_probability > 0.0 ) )
+    {
+        initialization_result_code = std::errc::invalid_argument;
+        report_invalid_option_combination( reorder_fault_name, no_arq_option, initialization_result_code );
+    }
+
     return initialization_result_code;
 }
 
@@ -572,7 +1174,7 @@ register_exit_handlers( ) noexcept
 
     constexpr auto quick_exit_handler { [ ]
                                         {
-                                            spdlog::get( "basic_logger" )->critical(
+                                            get_basic_logger( ).critical(
                                               "Program terminated (exit code: {})", exit_code );
                                             try
                                             {
@@ -581,7 +1183,7 @@ register_exit_handlers( ) noexcept
                                             }
                                             catch ( const std::exception& ex )
                                             {
-                                                spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+                                                get_basic_logger( ).error( "{}", ex.what( ) );
                                             }
 
                                             try
@@ -590,13 +1192,13 @@ register_exit_handlers( ) noexcept
                                             }
                                             catch ( const std::system_error& se )
                                             {
-                                                spdlog::get( "basic_logger" )->critical( "{}", se.what( ) );
-                                                spdlog::get( "basic_logger" )->flush( );
+                                                get_basic_logger( ).critical( "{}", se.what( ) );
+                                                get_basic_logger( ).flush( );
                                                 spdlog::shutdown( );
                                                 throw;
                                             }
 
-                                            spdlog::get( "basic_logger" )->flush( );
+                                            get_basic_logger( ).flush( );
                                             spdlog::shutdown( );
                                         } };
 
@@ -606,14 +1208,14 @@ register_exit_handlers( ) noexcept
                                         {
                                             if ( exit_code == EXIT_SUCCESS )
                                             {
-                                                spdlog::get( "basic_logger" )->info(
+                                                get_basic_logger( ).info(
                                                   "Program execution ended (exit code: {})", exit_code );
                                                 fmt::print(
                                                   "Program execution ended (exit code: {})\n\n", exit_code );
                                             }
                                             else
                                             {
-                                                spdlog::get( "basic_logger" )->error(
+                                                get_basic_logger( ).error(
                                                   "Program exited abnormally (exit code: {})", exit_code );
                                                 fmt::print(
                                                   "Program exited abnormally (exit code: {})\n\n", exit_code );
@@ -621,7 +1223,7 @@ register_exit_handlers( ) noexcept
                                         }
                                         catch ( const std::exception& ex )
                                         {
-                                            spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+                                            get_basic_logger( ).error( "{}", ex.what( ) );
                                         }
 
                                         try
@@ -630,13 +1232,13 @@ register_exit_handlers( ) noexcept
                                         }
                                         catch ( const std::system_error& se )
                                         {
-                                            spdlog::get( "basic_logger" )->critical( "{}", se.what( ) );
-                                            spdlog::get( "basic_logger" )->flush( );
+                                            get_basic_logger( ).critical( "{}", se.what( ) );
+                                            get_basic_logger( ).flush( );
                                             spdlog::shutdown( );
                                             throw;
                                         }
 
-                                        spdlog::get( "basic_logger" )->flush( );
+                                        get_basic_logger( ).flush( );
                                     } };
 
     bool is_registration_successful;
@@ -657,7 +1259,7 @@ register_exit_handlers( ) noexcept
     }
     catch ( const std::system_error& se )
     {
-        spdlog::get( "basic_logger" )->error( "{}", se.what( ) );
+        get_basic_logger( ).error( "{}", se.what( ) );
         try
         {
             fmt::print( stderr, "\nSomething went wrong during program startup!\n\n" );
@@ -665,9 +1267,9 @@ register_exit_handlers( ) noexcept
         }
         catch ( const std::exception& ex )
         {
-            spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+            get_basic_logger( ).error( "{}", ex.what( ) );
         }
-        spdlog::get( "basic_logger" )->flush( );
+        get_basic_logger( ).flush( );
 
         is_registration_successful = false;
     }
@@ -721,7 +1323,10 @@ register_loggers( ) noexcept( false )
         log_file_path /= app_logs_dir;
         log_file_path /= log_file_name;
 
-        auto logger { spdlog::basic_logger_st( "basic_logger", log_file_path, false, handlers ) };
+        using simple_network_simulation::util::AsyncFileSink;
+        const auto logger { std::make_shared<spdlog::logger>( "basic_logger",
+                                                              std::make_shared<AsyncFileSink>( log_file_path, false,
+                                                                                               handlers ) ) };
 
 #if SNS_DEBUG == 0
         logger->set_level( spdlog::level::info );
@@ -730,6 +1335,7 @@ register_loggers( ) noexcept( false )
         logger->set_level( spdlog::level::debug );
         logger->set_pattern( "[%Y-%m-%d (%a) %T.%f %z] [%n] [thread %t] [%l] [%@] %v" );
 #endif
+        simple_network_simulation::util::register_basic_logger( logger );
         is_registration_successful = true;
     }
     catch ( const std::exception& ex )
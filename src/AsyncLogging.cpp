@@ -0,0 +1,178 @@
+#include "AsyncLogging.hpp"
+#include <chrono>
+#include <algorithm>
+#include <utility>
+#include <stop_token>
+#include <condition_variable>
+#include <spdlog/spdlog.h>
+
+
+namespace simple_network_simulation::util
+{
+
+namespace
+{
+
+using std::chrono_literals::operator""ms;
+
+// The drainer goes over the rings again straight away as long as it finds records in
+// them. Otherwise it waits this long, unless a thread finds its ring full before that.
+constexpr auto drain_interval { 10ms };
+
+constinit spdlog::logger* basic_logger { };
+
+}
+
+
+AsyncFileSink::AsyncFileSink( const spdlog::filename_t& filename, const bool truncate,
+                              const spdlog::file_event_handlers& event_handlers )
+    : m_file_sink { filename, truncate, event_handlers },
+      m_drainer { [ this ]( const std::stop_token stop_token )
+                  {
+                      run_drainer( stop_token );
+                  } }
+{
+}
+
+AsyncFileSink::~AsyncFileSink( )
+{
+    m_drainer.request_stop( );
+    m_drainer.join( );
+
+    const std::lock_guard lock { m_file_sink_mutex };
+    drain_rings( );
+    m_file_sink.flush( );
+}
+
+void
+AsyncFileSink::log( const spdlog::details::log_msg& msg )
+{
+    log_record_t record;
+    record.time = msg.time;
+    record.source = msg.source;
+    record.logger_name = msg.logger_name;
+    record.thread_id = msg.thread_id;
+    record.level = msg.level;
+    record.payload_size = static_cast<std::uint32_t>( std::min( msg.payload.size( ), max_payload_size ) );
+    std::copy_n( msg.payload.data( ), record.payload_size, std::begin( record.payload ) );
+
+    auto& ring { get_thread_ring( ) };
+
+    while ( ring.try_push( record ) == false )
+    {
+        {
+            const std::lock_guard lock { m_drainer_mutex };
+            m_is_drain_requested = true;
+        }
+
+        m_drainer_cv.notify_one( );
+        std::this_thread::yield( );
+    }
+}
+
+void
+AsyncFileSink::flush( )
+{
+    const std::lock_guard lock { m_file_sink_mutex };
+    drain_rings( );
+    m_file_sink.flush( );
+}
+
+void
+AsyncFileSink::set_pattern( const std::string& pattern )
+{
+    const std::lock_guard lock { m_file_sink_mutex };
+    m_file_sink.set_pattern( pattern );
+}
+
+void
+AsyncFileSink::set_formatter( std::unique_ptr<spdlog::formatter> sink_formatter )
+{
+    const std::lock_guard lock { m_file_sink_mutex };
+    m_file_sink.set_formatter( std::move( sink_formatter ) );
+}
+
+[[ nodiscard ]] AsyncFileSink::log_ring_t&
+AsyncFileSink::get_thread_ring( )
+{
+    thread_local const AsyncFileSink* ring_owner { };
+    thread_local log_ring_t* ring { };
+
+    if ( ring_owner != this ) [[ unlikely ]]
+    {
+        const std::lock_guard lock { m_rings_mutex };
+        ring = m_rings.emplace_back( std::make_unique<log_ring_t>( ) ).get( );
+        ring_owner = this;
+    }
+
+    return *ring;
+}
+
+bool
+AsyncFileSink::drain_rings( )
+{
+    const std::lock_guard lock { m_rings_mutex };
+
+    bool is_any_drained { };
+    log_record_t record;
+
+    for ( const auto& ring : m_rings )
+    {
+        while ( ring->try_pop( record ) )
+        {
+            spdlog::details::log_msg msg { record.time, record.source, record.logger_name, record.level,
+                                           spdlog::string_view_t { record.payload.data( ), record.payload_size } };
+            msg.thread_id = record.thread_id;
+
+            m_file_sink.log( msg );
+            is_any_drained = true;
+        }
+    }
+
+    return is_any_drained;
+}
+
+void
+AsyncFileSink::run_drainer( const std::stop_token stop_token )
+{
+    while ( stop_token.stop_requested( ) == false )
+    {
+        bool is_any_drained { };
+
+        {
+            const std::lock_guard lock { m_file_sink_mutex };
+            is_any_drained = drain_rings( );
+        }
+
+        if ( is_any_drained == false )
+        {
+            std::unique_lock lock { m_drainer_mutex };
+            m_drainer_cv.wait_for( lock, stop_token, drain_interval,
+                                   [ this ] { return std::exchange( m_is_drain_requested, false ); } );
+        }
+    }
+}
+
+void
+register_basic_logger( std::shared_ptr<spdlog::logger> logger )
+{
+    spdlog::register_logger( logger );
+
+    basic_logger = logger.get( );
+}
+
+[[ nodiscard ]] spdlog::logger&
+get_basic_logger( ) noexcept
+{
+    return *basic_logger;
+}
+
+}
+
+// The floating-point formatting of fmt, which spdlog instantiates here, does signed
+// arithmetic that GCC assumes does not overflow. It reports that under -Wstrict-overflow
+// against the end of the file, where it compiles those templates, so the warning is only
+// turned off from there on.
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic ignored "-Wstrict-overflow"
+#endif
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <stop_token>
+#include <condition_variable>
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <spdlog/logger.h>
+#include <spdlog/sinks/sink.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include "SpscRing.hpp"
+
+
+namespace simple_network_simulation::util
+{
+
+// A file sink that any number of threads can log to without taking a lock or touching
+// the file: each thread copies its records into a lock-free ring of its own, and a
+// background thread drains the rings into the file, formatting the records on its way.
+// A thread only waits, and wakes the drainer up, when its ring is full, i.e. when it
+// logs faster than the file takes the records in.
+class AsyncFileSink final : public spdlog::sinks::sink
+{
+public:
+    // The longer messages are truncated to this many characters.
+    static constexpr auto max_payload_size { 256uz };
+
+    AsyncFileSink( const spdlog::filename_t& filename, const bool truncate,
+                   const spdlog::file_event_handlers& event_handlers );
+
+    AsyncFileSink( const AsyncFileSink& ) = delete;
+    AsyncFileSink& operator=( const AsyncFileSink& ) = delete;
+
+    // Writes out whatever the threads logged before the sink went away.
+    ~AsyncFileSink( ) override;
+
+    void
+    log( const spdlog::details::log_msg& msg ) override;
+
+    // Writes out every record logged so far and flushes the file.
+    void
+    flush( ) override;
+
+    void
+    set_pattern( const std::string& pattern ) override;
+
+    void
+    set_formatter( std::unique_ptr<spdlog::formatter> sink_formatter ) override;
+
+private:
+    // A log message with its payload copied in, so that it outlives the call that logged it.
+    struct log_record_t
+    {
+        spdlog::log_clock::time_point time;
+        spdlog::source_loc source;
+        spdlog::string_view_t logger_name;  // the name of a logger outlives its records
+        std::size_t thread_id;
+        spdlog::level::level_enum level;
+        std::uint32_t payload_size;
+        std::array<char, max_payload_size> payload;
+    };
+
+    using log_ring_t = SpscRing<log_record_t, 64>;
+
+    // Registers a ring for the calling thread the first time it logs.
+    [[ nodiscard ]] log_ring_t&
+    get_thread_ring( );
+
+    // Moves the records from the rings into the file; returns whether there were any.
+    // The caller must hold m_file_sink_mutex, which makes it the only consumer of the rings.
+    bool
+    drain_rings( );
+
+    void
+    run_drainer( const std::stop_token stop_token );
+
+    std::mutex m_file_sink_mutex;
+    spdlog::sinks::basic_file_sink_st m_file_sink;
+    std::mutex m_rings_mutex;
+    std::vector< std::unique_ptr<log_ring_t> > m_rings;
+    std::mutex m_drainer_mutex;
+    std::condition_variable_any m_drainer_cv;
+    bool m_is_drain_requested { };
+    std::jthread m_drainer;
+};
+
+// Registers the logger that the whole program logs to and keeps a handle to it, so that
+// logging does not look it up in the registry of spdlog, under its mutex, every time.
+void
+register_basic_logger( std::shared_ptr<spdlog::logger> logger );
+
+// Only valid once register_basic_logger( ) has returned.
+[[ nodiscard ]] spdlog::logger&
+get_basic_logger( ) noexcept;
+
+}
@@ -0,0 +1,469 @@
+
+#include <string_view>
+#include <string>
+#include <vector>
+#include <array>
+// The sort of libstdc++ does signed iterator arithmetic in its heap that GCC assumes does
+// not overflow, and reports it under -Wstrict-overflow against the lines of the header that
+// it compiles out of line, so the header is included with the warning off.
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wstrict-overflow"
+#endif
+#include <algorithm>
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic pop
+#endif
+#include <numeric>
+#include <chrono>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+#include <exception>
+#include <utility>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <fmt/core.h>
+#include "BidirectionalMultimessageSimulation.hpp"
+#include "ChannelFaults.hpp"
+#include "ParityKernels.hpp"
+#include "Topology.hpp"
+
+
+namespace sns = simple_network_simulation;
+
+namespace
+{
+
+using std::string_view_literals::operator""sv;
+using std::chrono_literals::operator""ms;
+
+constexpr auto tool_name { "sns-bench"sv };
+
+constexpr auto repetitions_long_option { "--repetitions="sv };
+constexpr auto json_long_option { "--json="sv };
+constexpr auto filter_long_option { "--filter="sv };
+
+constexpr auto default_repetition_count { 15u };
+
+// Each benchmark first runs for the warm-up time, which also tells how many operations
+// fit into a repetition of about the repetition time.
+constexpr auto warm_up_time { 100ms };
+constexpr auto repetition_time { 20ms };
+
+constexpr auto faulty_channel_specification { "ber=1e-3,loss=1e-3,duplicate=1e-3"sv };
+
+// As many segments as the largest batch of the reliable transport.
+constexpr auto parity_batch_segment_count { 2uz * sns::sequence_num_modulus };
+
+struct benchmark_options_t
+{
+    std::uint32_t repetition_count { default_repetition_count };
+    std::string_view json_path;
+    std::string_view filter;
+};
+
+struct benchmark_result_t
+{
+    std::string name;
+    std::uint64_t operations_per_repetition;
+    double mean_ns;
+    double standard_deviation_ns;
+    double min_ns;
+    double median_ns;
+    double max_ns;
+};
+
+// Hides a value from the optimizer, which can then neither fold the computations that it
+// feeds into nor drop the ones that produce it.
+template <class Value>
+void inline
+launder( Value& value ) noexcept
+{
+    asm volatile( "" : "+m"( value ) : : "memory" );
+}
+
+template <class Operation>
+[[ nodiscard ]] std::chrono::nanoseconds
+time_operations( const std::uint64_t operation_count, Operation& operation )
+{
+    using std::chrono::steady_clock;
+
+    const auto start_time { steady_clock::now( ) };
+
+    for ( auto operation_idx { 0uz }; operation_idx < operation_count; ++operation_idx )
+    {
+        operation( );
+    }
+
+    return steady_clock::now( ) - start_time;
+}
+
+template <class Operation>
+[[ nodiscard ]] benchmark_result_t
+run_benchmark( const std::string_view name, const std::uint32_t repetition_count, Operation&& operation )
+{
+    auto warm_up_operation_count { 0uz };
+    std::chrono::nanoseconds warm_up_elapsed_time { };
+
+    for ( auto batch_size { 1uz }; warm_up_elapsed_time < warm_up_time; batch_size *= 2 )
+    {
+        warm_up_elapsed_time += time_operations( batch_size, operation );
+        warm_up_operation_count += batch_size;
+    }
+
+    const auto operations_per_repetition { std::max( std::uint64_t { 1 },
+                                                     static_cast<std::uint64_t>( repetition_time * warm_up_operation_count /
+                                                                                 warm_up_elapsed_time ) ) };
+
+    std::vector<double> ns_per_operation( repetition_count );
+
+    for ( auto& sample : ns_per_operation )
+    {
+        const std::chrono::duration<double, std::nano> elapsed_time { time_operations( operations_per_repetition,
+                                                                                       operation ) };
+        sample = elapsed_time.count( ) / static_cast<double>( operations_per_repetition );
+    }
+
+    const auto sample_count { static_cast<double>( std::size( ns_per_operation ) ) };
+    const auto mean { std::reduce( std::cbegin( ns_per_operation ), std::cend( ns_per_operation ) ) / sample_count };
+    const auto squared_deviation_sum { std::transform_reduce( std::cbegin( ns_per_operation ),
+                                                              std::cend( ns_per_operation ), 0.0, std::plus { },
+                                                              [ mean ]( const double sample )
+                                                              { return ( sample - mean ) * ( sample - mean ); } ) };
+
+    std::ranges::sort( ns_per_operation );
+
+    const auto middle_idx { std::size( ns_per_operation ) / 2 };
+    const auto median { std::size( ns_per_operation ) % 2 == 1
+                        ? ns_per_operation[ middle_idx ]
+                        : ( ns_per_operation[ middle_idx - 1 ] + ns_per_operation[ middle_idx ] ) / 2.0 };
+
+    return benchmark_result_t { std::string { name }, operations_per_repetition, mean,
+                                sample_count > 1.0 ? std::sqrt( squared_deviation_sum / ( sample_count - 1.0 ) ) : 0.0,
+                                ns_per_operation.front( ), median, ns_per_operation.back( ) };
+}
+
+// The two processes of the first connection of the default topology, along with what
+// they send each other.
+struct benchmark_fixture_t
+{
+    sns::topology_t topology;
+    const sns::node_t* initiator_node;
+    const sns::node_t* responder_node;
+    sns::process_context_t initiator;
+    sns::process_context_t responder;
+    sns::message_t request;
+    sns::message_t response;
+};
+
+[[ nodiscard ]] benchmark_fixture_t
+make_benchmark_fixture( )
+{
+    benchmark_fixture_t fixture { sns::generate_topology( sns::default_node_count, sns::default_processes_per_node ),
+                                  nullptr, nullptr, { }, { }, { }, { } };
+
+    const auto& topology { fixture.topology };
+    const auto& connection { topology.connections.front( ) };
+    const auto& initiator_process { topology.processes[ connection.initiator_process_idx ] };
+    const auto& responder_process { topology.processes[ connection.responder_process_idx ] };
+    const auto& protocol { topology.protocols[ connection.protocol_idx ] };
+
+    fixture.initiator_node = &topology.nodes[ initiator_process.node_idx ];
+    fixture.responder_node = &topology.nodes[ responder_process.node_idx ];
+    fixture.initiator = { &initiator_process, fixture.initiator_node, &protocol,
+                          responder_process.port_num, 0, sns::process_role_t::initiator };
+    fixture.responder = { &responder_process, fixture.responder_node, &protocol,
+                          initiator_process.port_num, 0, sns::process_role_t::responder };
+
+    fixture.request = sns::application_process( fixture.initiator, { sns::message_t { }, true } );
+    fixture.response = sns::application_process( fixture.responder, { fixture.request, true } );
+
+    return fixture;
+}
+
+// Keeps the opening process away from its last request, which the accepting process
+// answers with the closing payload, so that the dialogue goes on for as long as needed.
+void inline
+rewind_dialogue( sns::process_context_t& initiator ) noexcept
+{
+    initiator.request_counter %= initiator.protocol->request_count - 1;
+}
+
+[[ nodiscard ]] std::vector<benchmark_result_t>
+run_benchmarks( const benchmark_options_t& options )
+{
+    std::vector<benchmark_result_t> results;
+
+    const auto run { [ &options, &results ]( const std::string_view name, auto&& operation )
+                     {
+                         if ( name.find( options.filter ) == std::string_view::npos )
+                         {
+                             return;
+                         }
+
+                         results.push_back( run_benchmark( name, options.repetition_count, operation ) );
+
+                         const auto& result { results.back( ) };
+                         fmt::print( stderr, "{:<28} {:>12.2f} ns/op {:>16.0f} ops/s  (±{:.2f} ns)\n",
+                                     result.name, result.mean_ns, 1e9 / result.mean_ns,
+                                     result.standard_deviation_ns );
+                     } };
+
+    auto fixture { make_benchmark_fixture( ) };
+    auto& [ topology, initiator_node, responder_node, initiator, responder, request, response ] { fixture };
+
+    run( "application_process/opener"sv, [ & ]
+         {
+             rewind_dialogue( initiator );
+
+             std::pair incoming_message { response, true };
+             launder( incoming_message );
+
+             auto message { sns::application_process( initiator, incoming_message ) };
+             launder( message );
+         } );
+
+    run( "application_process/acceptor"sv, [ & ]
+         {
+             std::pair incoming_message { request, true };
+             launder( incoming_message );
+
+             auto message { sns::application_process( responder, incoming_message ) };
+             launder( message );
+         } );
+
+    run( "transport_to_channel"sv, [ & ]
+         {
+             auto message { request };
+             launder( message );
+
+             auto segment { sns::transport_to_channel( *initiator_node, *responder_node, message ) };
+             launder( segment );
+         } );
+
+    const auto request_segment { sns::transport_to_channel( *initiator_node, *responder_node, request ) };
+
+    run( "transport_from_channel"sv, [ & ]
+         {
+             auto segment { request_segment };
+             launder( segment );
+
+             auto integrity { sns::segment_integrity_t::intact };
+             auto message { sns::transport_from_channel( *responder_node, *initiator_node, segment, integrity ) };
+             launder( message );
+             launder( integrity );
+         } );
+
+    auto clean_channel_stream { sns::make_channel_stream( 0, 0 ) };
+
+    run( "channel/clean"sv, [ & ]
+         {
+             auto segment { request_segment };
+             launder( segment );
+
+             auto delivery { sns::channel( segment, sns::channel_direction_t::forward, clean_channel_stream ) };
+             launder( delivery );
+         } );
+
+    const auto faulty_channel_model { sns::parse_channel_fault_model( faulty_channel_specification ) };
+    sns::set_channel_fault_model( sns::channel_direction_t::forward, faulty_channel_model.value( ) );
+    auto faulty_channel_stream { sns::make_channel_stream( 0, 0 ) };
+    sns::set_channel_fault_model( sns::channel_direction_t::forward, sns::channel_fault_model_t { } );
+
+    run( "channel/faulty"sv, [ & ]
+         {
+             auto segment { request_segment };
+             launder( segment );
+
+             auto delivery { sns::channel( segment, sns::channel_direction_t::forward, faulty_channel_stream ) };
+             launder( delivery );
+         } );
+
+    // A batch of the reliable transport through each of the parity kernels that the CPU
+    // supports, one segment out of eight of it corrupted for the verification.
+    std::array<sns::segment_t, parity_batch_segment_count> parity_batch;
+    std::array<bool, parity_batch_segment_count> are_intact;
+
+    for ( auto segment_idx { 0uz }; segment_idx < parity_batch_segment_count; ++segment_idx )
+    {
+        const auto payload { sns::payload_t { static_cast<std::uint8_t>( segment_idx ) } };
+        parity_batch[ segment_idx ] = sns::encode_segment( payload, 0, 0 );
+        parity_batch[ segment_idx ].bits ^= static_cast<sns::segment_word_t>( segment_idx % 8 == 0 ? 1 : 0 );
+    }
+
+    for ( const auto& kernels : sns::get_supported_parity_kernels( ) )
+    {
+        run( fmt::format( "parity/generate/{}", kernels.name ), [ & ]
+             {
+                 auto batch { parity_batch };
+                 launder( batch );
+
+                 kernels.generate( std::data( batch ), std::size( batch ) );
+                 launder( batch );
+             } );
+
+        run( fmt::format( "parity/verify/{}", kernels.name ), [ & ]
+             {
+                 launder( parity_batch );
+
+                 auto corrupt_count { kernels.verify( std::data( parity_batch ), std::data( are_intact ),
+                                                      std::size( parity_batch ) ) };
+                 launder( are_intact );
+                 launder( corrupt_count );
+             } );
+    }
+
+    // Every layer of both nodes once, from the request leaving the opening process to its
+    // response being delivered back to it, over a clean channel.
+    auto round_trip_channel_stream { sns::make_channel_stream( 0, 0 ) };
+    std::pair delivered_response { response, true };
+    auto integrity { sns::segment_integrity_t::intact };
+
+    run( "round_trip"sv, [ & ]
+         {
+             rewind_dialogue( initiator );
+             launder( delivered_response );
+
+             const auto outgoing_request { sns::application_process( initiator, delivered_response ) };
+             const auto request_delivery { sns::channel( sns::transport_to_channel( *initiator_node, *responder_node,
+                                                                                    outgoing_request ),
+                                                         sns::channel_direction_t::forward,
+                                                         round_trip_channel_stream ) };
+             const auto delivered_request { sns::transport_from_channel( *responder_node, *initiator_node,
+                                                                         request_delivery.segments[ 0 ], integrity ) };
+
+             const auto outgoing_response { sns::application_process( responder, delivered_request ) };
+             const auto response_delivery { sns::channel( sns::transport_to_channel( *responder_node, *initiator_node,
+                                                                                     outgoing_response ),
+                                                          sns::channel_direction_t::backward,
+                                                          round_trip_channel_stream ) };
+             delivered_response = sns::transport_from_channel( *initiator_node, *responder_node,
+                                                               response_delivery.segments[ 0 ], integrity );
+         } );
+
+    // A whole connection as the simulator runs it, from its opening to its closing, with
+    // the coroutine hand-offs between the layers.
+    run( "connection"sv, [ & ]
+         {
+             auto statistics { sns::execute_connection( topology, 0 ) };
+             launder( statistics );
+         } );
+
+    return results;
+}
+
+[[ nodiscard ]] std::string
+format_json_report( const benchmark_options_t& options, const std::vector<benchmark_result_t>& results )
+{
+    auto report { fmt::format( "{{\n"
+                                 "  \"tool\": \"{}\",\n"
+                                 "  \"compiler\": \"{}\",\n"
+                                 "  \"segment_check\": \"{}\",\n"
+                                 "  \"segment_bit_count\": {},\n"
+                                 "  \"repetitions\": {},\n"
+                                 "  \"results\": [",
+                                 tool_name, __VERSION__, sns::segment_check_t::name, sns::segment_bit_count,
+                                 options.repetition_count ) };
+
+    for ( auto separator { ""sv }; const auto& result : results )
+    {
+        report += fmt::format( "{}\n    {{ \"name\": \"{}\", \"operations_per_repetition\": {}, "
+                               "\"ns_per_op\": {{ \"mean\": {:.3f}, \"stddev\": {:.3f}, \"min\": {:.3f}, "
+                               "\"median\": {:.3f}, \"max\": {:.3f} }}, \"ops_per_sec\": {:.1f} }}",
+                               separator, result.name, result.operations_per_repetition, result.mean_ns,
+                               result.standard_deviation_ns, result.min_ns, result.median_ns, result.max_ns,
+                               1e9 / result.mean_ns );
+        separator = ","sv;
+    }
+
+    report += "\n  ]\n}\n";
+
+    return report;
+}
+
+[[ nodiscard ]] bool
+parse_options( const int argc, const char* const* const argv, benchmark_options_t& options_OUT ) noexcept
+{
+    for ( auto arg_idx { 1 }; arg_idx < argc; ++arg_idx )
+    {
+        const std::string_view option { argv[ arg_idx ] };
+
+        if ( option.starts_with( repetitions_long_option ) )
+        {
+            const auto argument { option.substr( std::size( repetitions_long_option ) ) };
+            const auto argument_end { std::data( argument ) + std::size( argument ) };
+            const auto [ ptr, err_code ] { std::from_chars( std::data( argument ), argument_end,
+                                                            options_OUT.repetition_count ) };
+
+            if ( err_code != std::errc { } || ptr != argument_end || options_OUT.repetition_count == 0 )
+            {
+                return false;
+            }
+        }
+        else if ( option.starts_with( json_long_option ) )
+        {
+            options_OUT.json_path = option.substr( std::size( json_long_option ) );
+        }
+        else if ( option.starts_with( filter_long_option ) )
+        {
+            options_OUT.filter = option.substr( std::size( filter_long_option ) );
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+
+int main( const int argc, const char* const* const argv )
+{
+    benchmark_options_t options { };
+
+    if ( parse_options( argc, argv, options ) == false )
+    {
+        fmt::print( stderr, "Usage: {} [--repetitions=N] [--json=PATH] [--filter=TEXT]\n"
+                            "Time the layers of the simulator, with the tracing off, and print the mean, the\n"
+                            "spread and the throughput of each of them over N repetitions ({} by default),\n"
+                            "as JSON to PATH (or to stdout), for the benchmarks whose names contain TEXT.\n",
+                    tool_name, default_repetition_count );
+
+        return EXIT_FAILURE;
+    }
+
+    sns::set_tracing( false );
+
+    try
+    {
+        const auto results { run_benchmarks( options ) };
+
+        const auto report { format_json_report( options, results ) };
+
+        if ( std::empty( options.json_path ) )
+        {
+            fmt::print( "{}", report );
+        }
+        else
+        {
+            std::ofstream file { std::string { options.json_path } };
+            file.exceptions( std::ios::failbit | std::ios::badbit );
+            file << report;
+        }
+    }
+    catch ( const std::exception& ex )
+    {
+        fmt::print( stderr, "{}: {}\n", tool_name, ex.what( ) );
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -1,18 +1,66 @@
 
 #include "BidirectionalMultimessageSimulation.hpp"
 #include <chrono>
+#include <algorithm>
 #include <string_view>
-#include <random>
 #include <utility>
 #include <thread>
+#include <functional>
+#include <coroutine>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <array>
+#include <span>
+#include <bit>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <cerrno>
+#include <cstdlib>
 #include <cstddef>
 #include <cstdint>
 #include <fmt/core.h>
+#include "BinaryTrace.hpp"
+#include "ChannelFaults.hpp"
+#include "Coroutine.hpp"
+#include "EventCounters.hpp"
+#include "EventScheduler.hpp"
 #include "Formatters.hpp"
-
+#include "LatencyHistogram.hpp"
+#include "ParityKernels.hpp"
+#include "PlatformMacros.hpp"
+#include "Random.hpp"
+#include "ReliableTransport.hpp"
+#include "SharedMemory.hpp"
+#include "SpscRing.hpp"
+#include "ThreadPool.hpp"
+#include "TrafficSource.hpp"
+
+#if SNS_LATENCY_HISTOGRAMS == 1
+#   include "ScopedTimer.hpp"
+#endif
+
+#if PLATFORM_NAME == OS_GNULINUX
+#   include <pthread.h>
+#   include <sched.h>
+#endif
+
+#if PLATFORM_NAME != OS_WINDOWS
+#   include <csignal>
+#   include <sys/wait.h>
+#   include <unistd.h>
+#endif
+
+
+#ifndef SNS_TRACING
+#   define SNS_TRACING 1
+#endif
 
 using std::uint8_t;
 using std::uint32_t;
+using std::uint64_t;
 using std::size_t;
 
 namespace simple_network_simulation
@@ -22,28 +70,66 @@ namespace
 {
 
 constinit bool is_channel_faulty;
+constinit bool is_tracing_enabled { true };
+constinit bool is_virtual_time_enabled { true };
+constinit bool are_layers_delays_enabled;
+
+constinit auto current_execution_mode { execution_mode_t::interactive };
+
+constexpr auto benchmark_default_round_trips_budget { uint64_t { 1'000'000 } };
+
+// A zero budget means that the corresponding limit is not in effect.
+constinit auto benchmark_round_trips_budget { uint64_t { 0 } };
+constinit auto benchmark_time_budget { std::chrono::seconds { 0 } };
+
+// Large enough to amortize the submission of a task, small enough to keep the
+// connections interleaved and the workers balanced.
+constexpr auto benchmark_round_trips_per_task { 64uz };
+
+// A zero count means as many worker threads as the hardware runs concurrently.
+constinit auto configured_thread_count { 0uz };
 
 using std::chrono_literals::operator""ms;
 
-constexpr auto node1_process1_application_layer_default_delay { 450ms };
-constexpr auto node1_process2_application_layer_default_delay { 500ms };
-constexpr auto node2_process1_application_layer_default_delay { 550ms };
-constexpr auto node2_process2_application_layer_default_delay { 440ms };
-constexpr auto node1_transport_to_layer_default_delay         { 990ms };
-constexpr auto node1_transport_from_layer_default_delay       { 1110ms };
-constexpr auto node2_transport_to_layer_default_delay         { 1010ms };
-constexpr auto node2_transport_from_layer_default_delay       { 1070ms };
-constexpr auto channel_default_delay                          { 1500ms };
-
-constinit auto node1_process1_application_layer_delay { 0ms };
-constinit auto node1_process2_application_layer_delay { 0ms };
-constinit auto node2_process1_application_layer_delay { 0ms };
-constinit auto node2_process2_application_layer_delay { 0ms };
-constinit auto node1_transport_to_layer_delay         { 0ms };
-constinit auto node1_transport_from_layer_delay       { 0ms };
-constinit auto node2_transport_to_layer_delay         { 0ms };
-constinit auto node2_transport_from_layer_delay       { 0ms };
-constinit auto channel_delay                          { 0ms };
+// The delays of the application and transport layers are part of the topology.
+constexpr auto channel_default_delay { 1500ms };
+
+constexpr auto channel_random_words_per_block { 64uz };
+
+// The pipelined benchmark hands the items of its connections from one stage to the next
+// through rings of this many items. It never has more connections in flight than that,
+// each with a single item somewhere in the loop of stages, so a full ring always drains.
+constexpr auto pipeline_ring_capacity { 1024uz };
+
+// The two sides hand their segments to each other through a pair of rings of this many
+// records in shared memory. Each side keeps fewer connections open than half of that,
+// each with a single record in flight, so a ring never fills up.
+constexpr auto node_link_ring_capacity { 4096uz };
+constexpr auto max_open_connections_per_side { static_cast<uint32_t>( node_link_ring_capacity / 2 - 1 ) };
+
+// A side that finds its ring empty this many times in a row checks that the other side is
+// still running before it goes on waiting.
+constexpr auto node_link_liveness_check_interval { 1uz << 16 };
+
+// The cores that the sides are pinned to, if any.
+constinit std::optional<std::array<uint32_t, node_side_count>> node_cpus { };
+
+constexpr auto binary_trace_default_size { 256uz * 1024 * 1024 };
+
+// An empty path means that no binary trace is recorded.
+constinit std::string binary_trace_path { };
+constinit auto binary_trace_size { binary_trace_default_size };
+
+// The writer of the binary trace of the ongoing run, if it records one, and the connection
+// whose events the calling thread is recording.
+constinit BinaryTraceWriter* binary_trace_writer { };
+thread_local constinit uint32_t traced_connection_num { };
+
+// A connection over the reliable transport gives up once no message has got through it
+// for this many round trips in a row, be it because the channel is down or because a
+// corruption that went undetected ( a forged acknowledgement, say ) has left its ends
+// out of step for good.
+constexpr auto max_stalled_round_trip_count { 16u };
 
 namespace ui_strings
 {
@@ -67,679 +153,2501 @@ constexpr auto channel_text_tail { "~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~"
 
 }
 
-}
-
-
-[[ nodiscard ]] message_t
-node1_process1( const uint32_t process_num,
-                const std::pair<message_t, bool>& incoming_message )
+// Every trace line of the layers goes through here so that the headless modes pay
+// for a single predictable branch instead of a formatted write to stdout per hop.
+// Building with -DSNS_TRACING=0 removes the tracing from the binary altogether.
+template <class... Args>
+void inline
+trace( [[ maybe_unused ]] const fmt::format_string<Args...> format, [[ maybe_unused ]] Args&&... args )
 {
-    message_t message;
-    message.source_port_num = process_num;
-
-    const auto& [ received_message, is_intact ] { incoming_message };
-
-    if ( is_intact )
+#if SNS_TRACING == 1
+    if ( is_tracing_enabled ) [[ likely ]]
     {
-        fmt::print( "{0}node1_process1 received message: <{1}> from source #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    received_message.payload.data,
-                    received_message.source_port_num,
-                    ui_strings::application_layer_text_tail );
-
-        if ( received_message.payload.data == 0b1001'1111 ) [[ unlikely ]]
+        if ( is_virtual_time_enabled && are_layers_delays_enabled )
         {
-            message.destination_port_num = 0;
-        }
-        else
-        {
-            message.destination_port_num = 7002;
-
-            thread_local auto node1_process1_request_counter { 0uz };
-
-            switch ( node1_process1_request_counter )
-            {
-                case 0 :
-                    message.payload.data = 0b0000'0000;
-                    break;
-                case 1 :
-                    message.payload.data = 0b0000'0001;
-                    break;
-                case 2 :
-                    message.payload.data = 0b0000'0010;
-                    break;
-                case 3 :
-                    message.payload.data = 0b0000'0011;
-                    break;
-                default :
-                    message.payload.data = 0b0000'0111;
-            }
-
-            ++node1_process1_request_counter;
+            const std::chrono::duration<double> simulated_time { des::simulation_clock::now( ).time_since_epoch( ) };
+            fmt::print( "[simulated time: {:.6f} s]\n", simulated_time.count( ) );
         }
 
-        std::this_thread::sleep_for( node1_process1_application_layer_delay );
-
-        fmt::print( "{0}node1_process1 is sending message: <{1}> to destination #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    message.payload.data,
-                    message.destination_port_num,
-                    ui_strings::application_layer_text_tail );
+        fmt::print( format, std::forward<Args>( args )... );
     }
-    else
-    {
-        fmt::print( "{0}node1_process1 received corrupt message: <{1}>\n\n{2}",
-                    ui_strings::application_layer_text_head,
-                    received_message.payload.data,
-                    ui_strings::application_layer_text_tail );
+#endif
+}
 
-        message.destination_port_num = 0;
+// Appends an event to the binary trace, if one is being recorded, at the cost of a single
+// predictable branch otherwise.
+void inline
+record_trace_event( const trace_event_t event, const uint32_t node_num, const segment_t segment,
+                    const uint8_t detail ) noexcept
+{
+    if ( binary_trace_writer == nullptr ) [[ likely ]]
+    {
+        return;
+    }
 
-        std::this_thread::sleep_for( node1_process1_application_layer_delay );
+    const auto simulated_time { std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    des::simulation_clock::now( ).time_since_epoch( ) ) };
 
-        fmt::print( "{0}node1_process1 is sending message: <{1}> to destination #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    message.payload.data,
-                    message.destination_port_num,
-                    ui_strings::application_layer_text_tail );
-    }
+    trace_record_t record { };
+    record.simulated_time_ns = static_cast<uint64_t>( simulated_time.count( ) );
+    record.segment_bits = segment.bits;
+    record.connection_num = traced_connection_num;
+    record.node_num = node_num;
+    record.event = event;
+    record.detail = detail;
 
-    return message;
+    binary_trace_writer->record( record );
 }
 
-[[ nodiscard ]] message_t
-node1_process2( const uint32_t process_num,
-                const std::pair<message_t, bool>& incoming_message )
+// Records the binary trace of a run, if one is requested, for as long as it lives. The
+// writer must only go away once the threads that record to it have been joined.
+class [[ nodiscard ]] BinaryTraceScope
 {
-    message_t message;
-    message.source_port_num = process_num;
-
-    const auto& [ received_message, is_intact ] { incoming_message };
-
-    if ( is_intact )
+public:
+    BinaryTraceScope( )
     {
-        fmt::print( "{0}node1_process2 received message: <{1}> from source #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    received_message.payload.data,
-                    received_message.source_port_num,
-                    ui_strings::application_layer_text_tail );
-
-        if ( received_message.payload.data == 0b1000'1111 ) [[ unlikely ]]
+        if ( std::empty( binary_trace_path ) == false )
         {
-            message.destination_port_num = 0;
+            binary_trace_writer = &m_writer.emplace( binary_trace_path, binary_trace_size,
+                                                     static_cast<uint32_t>( segment_bit_count ) );
         }
-        else
-        {
-            message.destination_port_num = 7001;
+    }
 
-            thread_local auto node1_process2_request_counter { 0uz };
+    BinaryTraceScope( const BinaryTraceScope& ) = delete;
+    BinaryTraceScope& operator=( const BinaryTraceScope& ) = delete;
 
-            switch ( node1_process2_request_counter )
-            {
-                case 0 :
-                    message.payload.data = 0b1010'1010;
-                    break;
-                case 1 :
-                    message.payload.data = 0b1010'1011;
-                    break;
-                case 2 :
-                    message.payload.data = 0b1010'1100;
-                    break;
-                case 3 :
-                    message.payload.data = 0b1010'1101;
-                    break;
-                default :
-                    message.payload.data = 0b1010'1111;
-            }
+    ~BinaryTraceScope( )
+    {
+        binary_trace_writer = nullptr;
+    }
 
-            ++node1_process2_request_counter;
-        }
+private:
+    std::optional<BinaryTraceWriter> m_writer;
+};
 
-        std::this_thread::sleep_for( node1_process2_application_layer_delay );
+// Lets the time spent in a layer pass: on the simulated timeline of the calling
+// thread by default, or on the wall clock if the simulation runs in real time.
+void inline
+elapse( const std::chrono::milliseconds delay )
+{
+    if ( are_layers_delays_enabled == false )
+    {
+        return;
+    }
 
-        fmt::print( "{0}node1_process2 is sending message: <{1}> to destination #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    message.payload.data,
-                    message.destination_port_num,
-                    ui_strings::application_layer_text_tail );
+    if ( is_virtual_time_enabled ) [[ likely ]]
+    {
+        des::simulation_clock::advance( delay );
     }
     else
     {
-        fmt::print( "{0}node1_process2 received corrupt message: <{1}>\n\n{2}",
-                    ui_strings::application_layer_text_head,
-                    received_message.payload.data,
-                    ui_strings::application_layer_text_tail );
-
-        message.destination_port_num = 0;
-
-        std::this_thread::sleep_for( node1_process2_application_layer_delay );
-
-        fmt::print( "{0}node1_process2 is sending message: <{1}> to destination #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    message.payload.data,
-                    message.destination_port_num,
-                    ui_strings::application_layer_text_tail );
+        std::this_thread::sleep_for( delay );
     }
-
-    return message;
 }
 
-[[ nodiscard ]] message_t
-node2_process1( const uint32_t process_num,
-                const std::pair<message_t, bool>& incoming_message )
+#if SNS_LATENCY_HISTOGRAMS == 1
+// Records the wall-clock time taken by a call into a layer for the connection that the
+// calling thread executes.
+struct layer_latency_recorder_t
 {
-    message_t message;
-    message.source_port_num = process_num;
-
-    const auto& [ received_message, is_intact ] { incoming_message };
+    latency_layer_t layer;
 
-    if ( is_intact )
+    void
+    operator( )( const std::chrono::nanoseconds latency ) const noexcept
     {
-        fmt::print( "{0}node2_process1 received message: <{1}> from source #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    received_message.payload.data,
-                    received_message.source_port_num,
-                    ui_strings::application_layer_text_tail );
+        record_layer_latency( layer, traced_connection_num, latency );
+    }
+};
 
-        message.destination_port_num = 5002;
+using layer_timer_t = util::ScopedTimer<std::chrono::nanoseconds, std::chrono::steady_clock, layer_latency_recorder_t>;
+#else
+struct layer_timer_t { };
+#endif
 
-        switch ( received_message.payload.data.to_ullong( ) )
-        {
-            case 0b1010'1010 :
-                message.payload.data = 0b0100'0000;
-                break;
-            case 0b1010'1011 :
-                message.payload.data = 0b1000'0001;
-                break;
-            case 0b1010'1100 :
-                message.payload.data = 0b1100'0010;
-                break;
-            case 0b1010'1101 :
-                message.payload.data = 0b1110'0011;
-                break;
-            default :
-                message.payload.data = 0b1000'1111;
-        }
+// Indexed by latency_layer_t.
+constexpr std::array layer_call_counters { event_counter_t::application_calls, event_counter_t::transport_to_channel_calls,
+                                           event_counter_t::channel_calls, event_counter_t::transport_from_channel_calls };
 
-        std::this_thread::sleep_for( node2_process1_application_layer_delay );
+// Counts a call into a layer and times it for as long as the returned timer lives, which
+// does nothing at all unless the latency histograms are compiled in.
+[[ nodiscard ]] layer_timer_t inline
+time_layer( const latency_layer_t layer )
+{
+    count_event( layer_call_counters[ std::to_underlying( layer ) ] );
 
-        fmt::print( "{0}node2_process1 is sending message: <{1}> to destination #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    message.payload.data,
-                    message.destination_port_num,
-                    ui_strings::application_layer_text_tail );
-    }
-    else
-    {
-        fmt::print( "{0}node2_process1 received corrupt message: <{1}>\n\n{2}",
-                    ui_strings::application_layer_text_head,
-                    received_message.payload.data,
-                    ui_strings::application_layer_text_tail );
+#if SNS_LATENCY_HISTOGRAMS == 1
+    return layer_timer_t { layer_latency_recorder_t { layer } };
+#else
+    return layer_timer_t { };
+#endif
+}
 
-        message.destination_port_num = 0;
+// Flips one random bit in half of the segments on average, and returns how many it
+// flipped. Each segment consumes one random word: its lowest bit tosses the coin and the
+// others pick the bit to flip.
+[[ nodiscard ]] uint64_t
+inject_channel_faults( const std::span<segment_t> segments, util::Philox4x32& generator ) noexcept
+{
+    std::array<uint32_t, channel_random_words_per_block> random_words;
+    auto flipped_bit_count { uint64_t { 0 } };
 
-        std::this_thread::sleep_for( node2_process1_application_layer_delay );
+    for ( auto first_idx { 0uz }; first_idx < std::size( segments ); first_idx += std::size( random_words ) )
+    {
+        const auto block { segments.subspan( first_idx, std::min( std::size( random_words ),
+                                                                  std::size( segments ) - first_idx ) ) };
+        const auto block_random_words { std::span { random_words }.first( std::size( block ) ) };
+        generator.fill( block_random_words );
 
-        fmt::print( "{0}node2_process1 is sending message: <{1}> to destination #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    message.payload.data,
-                    message.destination_port_num,
-                    ui_strings::application_layer_text_tail );
+        for ( auto idx { 0uz }; idx < std::size( block ); ++idx )
+        {
+            const auto random_word { block_random_words[ idx ] };
+            const auto bit_idx { ( uint64_t { random_word >> 1 } * segment_bit_count ) >> 31 };
+            block[ idx ].bits ^= static_cast<segment_word_t>( static_cast<segment_word_t>( random_word & 1u ) << bit_idx );
+            flipped_bit_count += random_word & 1u;
+        }
     }
 
-    return message;
+    return flipped_bit_count;
 }
 
-[[ nodiscard ]] message_t
-node2_process2( const uint32_t process_num,
-                const std::pair<message_t, bool>& incoming_message )
+// There is a single segment in flight per direction of a connection, so any segment
+// that arrives after it is a stray copy which the transport drops on the floor.
+void
+discard_duplicate_segment( const node_t& node, const segment_t segment )
 {
-    message_t message;
-    message.source_port_num = process_num;
+    trace( "{0}node{1}_transport discarded duplicate segment: <{2}>\n\n{3}",
+           ui_strings::transport_layer_text_head,
+           node.node_num,
+           segment,
+           ui_strings::transport_layer_text_tail );
+}
 
-    const auto& [ received_message, is_intact ] { incoming_message };
+[[ nodiscard ]] segment_integrity_t
+get_segment_integrity( const decoded_segment_t& decoded_segment ) noexcept
+{
+    return decoded_segment.is_intact == false ? segment_integrity_t::corrupt
+           : decoded_segment.is_corrected     ? segment_integrity_t::corrected
+                                              : segment_integrity_t::intact;
+}
 
-    if ( is_intact )
+// Tallies a segment that came out of the channel against the segments that went in,
+// and returns whether the transport passes it on.
+bool
+count_arrival( connection_statistics_t& statistics, const segment_integrity_t integrity,
+               const std::span<const segment_t> sent_segments, const segment_t arrived_segment ) noexcept
+{
+    if ( integrity == segment_integrity_t::corrupt )
     {
-        fmt::print( "{0}node2_process2 received message: <{1}> from source #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    received_message.payload.data,
-                    received_message.source_port_num,
-                    ui_strings::application_layer_text_tail );
-
-        message.destination_port_num = 5001;
-
-        switch ( received_message.payload.data.to_ullong( ) )
-        {
-            case 0b0000'0000 :
-                message.payload.data = 0b1001'1000;
-                break;
-            case 0b0000'0001 :
-                message.payload.data = 0b1010'1000;
-                break;
-            case 0b0000'0010 :
-                message.payload.data = 0b1011'1000;
-                break;
-            case 0b0000'0011 :
-                message.payload.data = 0b1111'1000;
-                break;
-            default :
-                message.payload.data = 0b1001'1111;
-        }
+        ++statistics.corruption_count;
+        count_corruption( traced_connection_num, true );
 
-        std::this_thread::sleep_for( node2_process2_application_layer_delay );
+        return false;
+    }
 
-        fmt::print( "{0}node2_process2 is sending message: <{1}> to destination #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    message.payload.data,
-                    message.destination_port_num,
-                    ui_strings::application_layer_text_tail );
+    if ( integrity == segment_integrity_t::corrected )
+    {
+        ++statistics.correction_count;
+        count_corruption( traced_connection_num, true );
     }
-    else
+    else if ( std::ranges::find( sent_segments, arrived_segment.bits, &segment_t::bits ) ==
+              std::cend( sent_segments ) )
     {
-        fmt::print( "{0}node2_process2 received corrupt message: <{1}>\n\n{2}",
-                    ui_strings::application_layer_text_head,
-                    received_message.payload.data,
-                    ui_strings::application_layer_text_tail );
-
-        message.destination_port_num = 0;
+        // The check let a corrupted segment through.
+        ++statistics.undetected_corruption_count;
+        count_corruption( traced_connection_num, false );
+    }
 
-        std::this_thread::sleep_for( node2_process2_application_layer_delay );
+    return true;
+}
 
-        fmt::print( "{0}node2_process2 is sending message: <{1}> to destination #{2}\n\n{3}",
-                    ui_strings::application_layer_text_head,
-                    message.payload.data,
-                    message.destination_port_num,
-                    ui_strings::application_layer_text_tail );
+void
+count_delivery( connection_statistics_t& statistics, const segment_integrity_t integrity,
+                const segment_t sent_segment, const segment_t delivered_segment ) noexcept
+{
+    if ( count_arrival( statistics, integrity, std::span { &sent_segment, 1uz }, delivered_segment ) )
+    {
+        ++statistics.delivered_message_count;
     }
+}
 
-    return message;
+// Ports that do not belong to a node are mapped to its first port.
+[[ nodiscard ]] uint32_t
+get_port_idx( const node_t& port_node, const uint32_t port_num ) noexcept
+{
+    const auto port_idx { port_num - port_node.first_port_num };
+
+    return port_idx < port_node.process_count ? port_idx : 0u;
 }
 
-[[ nodiscard ]] segment_t
-channel( segment_t segment )
+// A batch of the reliable transport holds the acknowledgements owed and a window of data
+// segments, and what comes out of the channel may be up to twice as long.
+constexpr auto max_reliable_batch_size { 2uz * sequence_num_modulus };
+constexpr auto max_arrived_batch_size { 2 * max_reliable_batch_size };
+
+// One end of a connection over the reliable transport.
+struct [[ nodiscard ]] reliable_endpoint_t
 {
-    fmt::print( "{0}channel received: <{1}>\n\n{2}",
-                ui_strings::channel_text_head,
-                segment.data,
-                ui_strings::channel_text_tail );
+    const process_context_t* context;
+    const node_t* node;
+    const node_t* peer_node;
+    ArqSender sender;
+    ArqReceiver receiver;
+};
+
+// Carries a batch of segments across the channel and tallies what befell it on the way.
+[[ nodiscard ]] size_t
+carry_segments( const std::span<const segment_t> segments, const std::span<segment_t> delivered_OUT,
+                const channel_direction_t direction, channel_stream_t& stream, connection_statistics_t& statistics )
+{
+    const auto& counters { stream.fault_injectors[ std::to_underlying( direction ) ].get_counters( ) };
+    const auto previous_counters { counters };
 
-    thread_local std::random_device rand_dev { };
-    thread_local std::mt19937 mtgen { rand_dev( ) };
-    thread_local std::uniform_int_distribution<uint8_t> uniform_50_50_dist { 1, 2 };
-    thread_local std::uniform_int_distribution<size_t> uniform_dist_for_bit_select { 0, segment.data.size( ) - 1 };
+    const auto delivered_count { channel( segments, delivered_OUT, direction, stream ) };
 
-    if ( is_channel_faulty && uniform_50_50_dist( mtgen ) == 1 )
-    {
-        const auto random_index { uniform_dist_for_bit_select( mtgen ) };
-        segment.data.flip( random_index );
-    }
+    statistics.segment_count += std::size( segments );
+    statistics.loss_count += counters.loss_count - previous_counters.loss_count;
+    statistics.duplicate_count += counters.duplication_count - previous_counters.duplication_count;
 
-    std::this_thread::sleep_for( channel_delay );
+    return delivered_count;
+}
 
-    fmt::print( "{0}channel is sending: <{1}>\n\n{2}",
-                ui_strings::channel_text_head,
-                segment.data,
-                ui_strings::channel_text_tail );
+// Hands a message of the application over to the sender of its end of the connection.
+void
+send_reliable_message( reliable_endpoint_t& endpoint, const message_t message )
+{
+    const segment_header_t header { endpoint.sender.get_next_sequence_num( ), false };
 
-    return segment;
+    endpoint.sender.push( transport_to_channel( *endpoint.node, *endpoint.peer_node, message, header ) );
 }
 
-[[ nodiscard ]] segment_t
-node1_transport_to_channel( const message_t message )
+// Writes the acknowledgements owed by an end of a connection to batch_OUT, followed by
+// the data segments due from it, and returns the number of segments in the batch.
+[[ nodiscard ]] size_t
+emit_reliable_segments( reliable_endpoint_t& endpoint, const uint32_t round, const std::span<segment_t> batch_OUT,
+                        connection_statistics_t& statistics )
 {
-    fmt::print( "{0}node1_transport received message: <{1}> from source #{2}\n\n{3}",
-                ui_strings::transport_layer_text_head,
-                message.payload.data,
-                message.source_port_num,
-                ui_strings::transport_layer_text_tail );
+    const auto& node { *endpoint.node };
+    const auto& peer_node { *endpoint.peer_node };
 
-    segment_t segment { };
-    segment.data |= decltype( segment.data ) { message.payload.data.to_ullong( ) };
+    std::array<uint32_t, sequence_num_modulus> acknowledgement_nums;
+    const auto acknowledgement_count { endpoint.receiver.take_acknowledgements( acknowledgement_nums ) };
 
-    switch ( message.source_port_num )
-    {
-        default :
-            [[ fallthrough ]];
-        case 5001 :
-            segment.data[ 9 ] = false;
-            break;
-        case 5002 :
-            segment.data[ 9 ] = true;
-            break;
-    }
+    const auto source_port_idx { get_port_idx( node, endpoint.context->process->port_num ) };
+    const auto destination_port_idx { get_port_idx( peer_node, endpoint.context->peer_port_num ) };
 
-    switch ( message.destination_port_num )
+    for ( auto idx { 0uz }; idx < acknowledgement_count; ++idx )
     {
-        default :
-            [[ fallthrough ]];
-        case 7001 :
-            segment.data[ 8 ] = false;
-            break;
-        case 7002 :
-            segment.data[ 8 ] = true;
-            break;
+        const segment_header_t header { acknowledgement_nums[ idx ], true };
+        batch_OUT[ idx ] = segment_t { pack_segment_fields( payload_t { }, source_port_idx, destination_port_idx,
+                                                            header ) };
     }
 
-    if ( segment.data.count( ) % 2 == 0 )
+    generate_parity( batch_OUT.first( acknowledgement_count ) );
+
+    for ( auto idx { 0uz }; idx < acknowledgement_count; ++idx )
     {
-        segment.data[ 10 ] = false;
+        record_trace_event( trace_event_t::segment_encoded, node.node_num, batch_OUT[ idx ], 0 );
+
+        trace( "{0}node{1}_transport is sending acknowledgement #{2}: <{3}>\n\n{4}",
+               ui_strings::transport_layer_text_head,
+               node.node_num,
+               acknowledgement_nums[ idx ],
+               batch_OUT[ idx ],
+               ui_strings::transport_layer_text_tail );
     }
-    else
+
+    auto retransmission_count { 0uz };
+    const auto data_segment_count { endpoint.sender.collect_due_segments( round,
+                                                                          batch_OUT.subspan( acknowledgement_count ),
+                                                                          retransmission_count ) };
+
+    for ( const auto segment : batch_OUT.subspan( acknowledgement_count, retransmission_count ) )
     {
-        segment.data[ 10 ] = true;
+        trace( "{0}node{1}_transport timed out and is resending segment: <{2}>\n\n{3}",
+               ui_strings::transport_layer_text_head,
+               node.node_num,
+               segment,
+               ui_strings::transport_layer_text_tail );
     }
 
-    std::this_thread::sleep_for( node1_transport_to_layer_delay );
+    statistics.retransmission_count += retransmission_count;
 
-    fmt::print( "{0}node1_transport is sending segment: <{1}> to destination #{2}\n\n{3}",
-                ui_strings::transport_layer_text_head,
-                segment.data,
-                message.destination_port_num,
-                ui_strings::transport_layer_text_tail );
-
-    return segment;
+    return acknowledgement_count + data_segment_count;
 }
 
-[[ nodiscard ]] std::pair<message_t, bool>
-node1_transport_from_channel( const segment_t segment )
+// Takes the segments that came out of the channel in at an end of a connection: feeds
+// the acknowledgements to its sender and the data segments to its receiver, writes the
+// messages that the latter lets through, in order, to messages_OUT and returns their
+// number. messages_OUT must hold at least as many messages as the window.
+[[ nodiscard ]] size_t
+absorb_reliable_segments( reliable_endpoint_t& endpoint, const std::span<const segment_t> sent_segments,
+                          const std::span<const segment_t> arrived_segments, const std::span<message_t> messages_OUT,
+                          connection_statistics_t& statistics )
 {
-    std::pair<message_t, bool> result { };
-    auto& [ message, is_intact ] { result };
+    const auto& node { *endpoint.node };
+    const auto& peer_node { *endpoint.peer_node };
 
-    message.payload.data |= decltype( message.payload.data ) { segment.data.to_ullong( ) };
+    auto message_count { 0uz };
 
-    if ( segment.data[ 9 ] == false )
-    {
-        message.source_port_num = 7001;
-    }
-    else
-    {
-        message.source_port_num = 7002;
-    }
+    // The checks that only detect errors are verified over the whole batch at once.
+    std::array<bool, max_arrived_batch_size> are_intact;
 
-    if ( segment.data[ 8 ] == false )
+    if constexpr ( segment_check_t::is_correcting == false )
     {
-        message.destination_port_num = 5001;
-    }
-    else
-    {
-        message.destination_port_num = 5002;
+        [[ maybe_unused ]] const auto corrupt_count { verify_parity( arrived_segments, are_intact ) };
     }
 
-    if ( segment.data.count( ) % 2 == 0 )
+    for ( auto segment_idx { 0uz }; segment_idx < std::size( arrived_segments ); ++segment_idx )
     {
-        fmt::print( "{0}node1_transport received segment: <{1}> from source #{2}\n\n{3}",
-                    ui_strings::transport_layer_text_head,
-                    segment.data,
-                    message.source_port_num,
-                    ui_strings::transport_layer_text_tail );
+        const auto segment { arrived_segments[ segment_idx ] };
+        auto decoded_segment { decode_segment( segment ) };
 
-        is_intact = true;
+        if constexpr ( segment_check_t::is_correcting == false )
+        {
+            decoded_segment.is_intact = are_intact[ segment_idx ];
+        }
 
-        std::this_thread::sleep_for( node1_transport_from_layer_delay );
+        const auto integrity { get_segment_integrity( decoded_segment ) };
+        const auto sequence_num { decoded_segment.header.sequence_num };
 
-        fmt::print( "{0}node1_transport is sending message: <{1}> to destination #{2}\n\n{3}",
-                    ui_strings::transport_layer_text_head,
-                    message.payload.data,
-                    message.destination_port_num,
-                    ui_strings::transport_layer_text_tail );
-    }
-    else
-    {
-        fmt::print( "{0}node1_transport received corrupt segment: <{1}>\n\n{2}",
-                    ui_strings::transport_layer_text_head,
-                    segment.data,
-                    ui_strings::transport_layer_text_tail );
+        record_trace_event( trace_event_t::segment_decoded, node.node_num, segment, std::to_underlying( integrity ) );
 
-        is_intact = false;
+        if ( count_arrival( statistics, integrity, sent_segments, segment ) == false )
+        {
+            trace( "{0}node{1}_transport dropped corrupt segment: <{2}>\n\n{3}",
+                   ui_strings::transport_layer_text_head,
+                   node.node_num,
+                   segment,
+                   ui_strings::transport_layer_text_tail );
+
+            continue;
+        }
+
+        if ( integrity == segment_integrity_t::corrected )
+        {
+            trace( "{0}node{1}_transport corrected a flipped bit of segment: <{2}>\n\n{3}",
+                   ui_strings::transport_layer_text_head,
+                   node.node_num,
+                   segment,
+                   ui_strings::transport_layer_text_tail );
+        }
+
+        if ( decoded_segment.header.is_acknowledgement )
+        {
+            const bool is_new { endpoint.sender.acknowledge( sequence_num ) };
+
+            trace( "{0}node{1}_transport received {2}acknowledgement #{3}\n\n{4}",
+                   ui_strings::transport_layer_text_head,
+                   node.node_num,
+                   is_new ? "" : "stale ",
+                   sequence_num,
+                   ui_strings::transport_layer_text_tail );
+
+            continue;
+        }
+
+        std::array<segment_t, sequence_num_modulus> delivered_segments;
+        const auto reception { endpoint.receiver.receive( sequence_num, segment, delivered_segments ) };
 
-        std::this_thread::sleep_for( node1_transport_from_layer_delay );
+        if ( reception.is_duplicate || reception.delivered_count == 0 )
+        {
+            trace( "{0}node{1}_transport {2} segment #{3}: <{4}>\n\n{5}",
+                   ui_strings::transport_layer_text_head,
+                   node.node_num,
+                   reception.is_duplicate ? "discarded duplicate or out-of-order" : "buffered out-of-order",
+                   sequence_num,
+                   segment,
+                   ui_strings::transport_layer_text_tail );
+        }
 
-        fmt::print( "{0}node1_transport is sending corrupt message: <{1}>\n\n{2}",
-                    ui_strings::transport_layer_text_head,
-                    message.payload.data,
-                    ui_strings::transport_layer_text_tail );
+        for ( const auto delivered_segment : std::span { delivered_segments }.first( reception.delivered_count ) )
+        {
+            const auto delivered_fields { decode_segment( delivered_segment ) };
+
+            message_t message { };
+            message.payload = delivered_fields.payload;
+            message.source_port_num = peer_node.first_port_num + delivered_fields.source_port_idx;
+            message.destination_port_num = node.first_port_num + delivered_fields.destination_port_idx;
+
+            trace( "{0}node{1}_transport is sending message: <{2}> to destination #{3}\n\n{4}",
+                   ui_strings::transport_layer_text_head,
+                   node.node_num,
+                   message.payload,
+                   message.destination_port_num,
+                   ui_strings::transport_layer_text_tail );
+
+            messages_OUT[ message_count++ ] = message;
+            ++statistics.delivered_message_count;
+            count_process_message( node.first_process_idx + delivered_fields.destination_port_idx, traced_connection_num,
+                                   true );
+        }
     }
 
-    return result;
+    elapse( node.transport_from_channel_delay );
+
+    return message_count;
 }
 
-[[ nodiscard ]] segment_t
-node2_transport_to_channel( const message_t message )
+// A connection suspends at every hand-off between its layers, which is where its
+// executor gets to interleave the other connections and let the time of a hop pass.
+constexpr std::suspend_always layer_hand_off { };
+
+// Padded to a cache line so that the workers executing neighbouring connections
+// do not keep invalidating each other's copy of the counters.
+struct alignas( 64 ) pooled_connection_t
 {
-    fmt::print( "{0}node2_transport received message: <{1}> from source #{2}\n\n{3}",
-                ui_strings::transport_layer_text_head,
-                message.payload.data,
-                message.source_port_num,
-                ui_strings::transport_layer_text_tail );
+    Connection connection;
+    connection_statistics_t closed_connections_statistics;
+};
 
-    segment_t segment { };
-    segment.data |= decltype( segment.data ) { message.payload.data.to_ullong( ) };
+struct [[ nodiscard ]] pooled_execution_t
+{
+    const topology_t* topology;
+    util::WorkStealingThreadPool* pool;
+    std::vector<pooled_connection_t> connections;
+    uint64_t round_trips_budget;
+    std::chrono::steady_clock::time_point deadline;
+    size_t round_trips_per_task;
+    bool is_time_budget_set;
+    bool is_reopening_enabled;
+};
+
+// Executes a slice of round trips of a connection and then submits the rest as a new
+// task, so that a few workers interleave any number of connections and the idle ones
+// can steal the connections queued up behind a busy worker.
+void
+execute_pooled_round_trips( pooled_execution_t& execution, const uint32_t connection_idx )
+{
+    auto& [ connection, statistics ] { execution.connections[ connection_idx ] };
 
-    switch ( message.source_port_num )
+    for ( auto round_trip_idx { 0uz }; round_trip_idx < execution.round_trips_per_task; ++round_trip_idx )
     {
-        default :
-            [[ fallthrough ]];
-        case 7001 :
-            segment.data[ 9 ] = false;
-            break;
-        case 7002 :
-            segment.data[ 9 ] = true;
-            break;
-    }
+        for ( auto hop_idx { 0uz }; hop_idx < Connection::hops_per_round_trip && connection.step( ); ++hop_idx ) { }
 
-    switch ( message.destination_port_num )
-    {
-        default :
-            [[ fallthrough ]];
-        case 5001 :
-            segment.data[ 8 ] = false;
-            break;
-        case 5002 :
-            segment.data[ 8 ] = true;
-            break;
-    }
+        if ( connection.is_closed( ) == false )
+        {
+            continue;
+        }
 
-    if ( segment.data.count( ) % 2 == 0 )
-    {
-        segment.data[ 10 ] = false;
-    }
-    else
-    {
-        segment.data[ 10 ] = true;
-    }
+        statistics += connection.get_statistics( );
+        ++statistics.connection_count;
+
+        // The protocol closes a connection after a handful of round trips, so in the
+        // benchmark each connection is reopened over and over until its budget is used up.
+        const bool is_budget_left { ( execution.round_trips_budget == 0 ||
+                                      statistics.round_trip_count < execution.round_trips_budget ) &&
+                                    ( execution.is_time_budget_set == false ||
+                                      std::chrono::steady_clock::now( ) < execution.deadline ) };
 
-    std::this_thread::sleep_for( node2_transport_to_layer_delay );
+        if ( execution.is_reopening_enabled == false || is_budget_left == false )
+        {
+            return;
+        }
 
-    fmt::print( "{0}node2_transport is sending segment: <{1}> to destination #{2}\n\n{3}",
-                ui_strings::transport_layer_text_head,
-                segment.data,
-                message.destination_port_num,
-                ui_strings::transport_layer_text_tail );
+        connection = Connection { *execution.topology, connection_idx,
+                                  static_cast<uint32_t>( statistics.connection_count ) };
+    }
 
-    return segment;
+    execution.pool->submit( [ &execution, connection_idx ]
+                            {
+                                execute_pooled_round_trips( execution, connection_idx );
+                            } );
 }
 
-[[ nodiscard ]] std::pair<message_t, bool>
-node2_transport_from_channel( const segment_t segment )
+void
+execute_on_thread_pool( pooled_execution_t& execution )
 {
-    std::pair<message_t, bool> result { };
-    auto& [ message, is_intact ] { result };
+    const auto& topology { *execution.topology };
+    const auto connection_count { static_cast<uint32_t>( std::size( topology.connections ) ) };
 
-    message.payload.data |= decltype( message.payload.data ) { segment.data.to_ullong( ) };
+    execution.connections.reserve( connection_count );
 
-    if ( segment.data[ 9 ] == false )
+    for ( auto connection_idx { 0u }; connection_idx < connection_count; ++connection_idx )
     {
-        message.source_port_num = 5001;
-    }
-    else
-    {
-        message.source_port_num = 5002;
+        execution.connections.push_back( pooled_connection_t { Connection { topology, connection_idx }, { } } );
     }
 
-    if ( segment.data[ 8 ] == false )
-    {
-        message.destination_port_num = 7001;
-    }
-    else
+    util::WorkStealingThreadPool pool { get_thread_count( ) };
+    execution.pool = &pool;
+
+    for ( auto connection_idx { 0u }; connection_idx < connection_count; ++connection_idx )
     {
-        message.destination_port_num = 7002;
+        pool.submit( [ &execution, connection_idx ]
+                     {
+                         execute_pooled_round_trips( execution, connection_idx );
+                     } );
     }
 
-    if ( segment.data.count( ) % 2 == 0 )
-    {
-        fmt::print( "{0}node2_transport received segment: <{1}> from source #{2}\n\n{3}",
-                    ui_strings::transport_layer_text_head,
-                    segment.data,
-                    message.source_port_num,
-                    ui_strings::transport_layer_text_tail );
+    pool.wait( );
+    execution.pool = nullptr;
+}
 
-        is_intact = true;
+[[ nodiscard ]] uint64_t
+get_benchmark_round_trips_budget( ) noexcept
+{
+    const bool is_time_budget_set { benchmark_time_budget != std::chrono::seconds { 0 } };
 
-        std::this_thread::sleep_for( node2_transport_from_layer_delay );
+    return ( benchmark_round_trips_budget == 0 && is_time_budget_set == false ) ? benchmark_default_round_trips_budget
+                                                                                : benchmark_round_trips_budget;
+}
 
-        fmt::print( "{0}node2_transport is sending message: <{1}> to destination #{2}\n\n{3}",
-                    ui_strings::transport_layer_text_head,
-                    message.payload.data,
-                    message.destination_port_num,
-                    ui_strings::transport_layer_text_tail );
-    }
-    else
-    {
-        fmt::print( "{0}node2_transport received corrupt segment: <{1}>\n\n{2}",
-                    ui_strings::transport_layer_text_head,
-                    segment.data,
-                    ui_strings::transport_layer_text_tail );
+// Without a time budget, the open-loop benchmark runs for this long.
+constexpr std::chrono::seconds open_loop_default_duration { 10 };
 
-        is_intact = false;
+// Closer than this to the time at which its next request is due, a worker spins rather
+// than sleeps, since a sleep tends to overshoot by about as much.
+constexpr std::chrono::microseconds open_loop_spin_threshold { 100 };
 
-        std::this_thread::sleep_for( node2_transport_from_layer_delay );
+struct alignas( 64 ) open_loop_connection_t
+{
+    Connection connection;
+    TrafficSource traffic_source;
+    connection_statistics_t closed_connections_statistics;
+    uint64_t answered_request_count;
+};
+
+// The latencies are recorded into histograms of the worker, which it alone updates.
+struct [[ nodiscard ]] open_loop_worker_t
+{
+    util::LatencyHistogram latencies_from_schedule;
+    util::LatencyHistogram latencies_from_send;
+    uint64_t unanswered_request_count;
+};
 
-        fmt::print( "{0}node2_transport is sending corrupt message: <{1}>\n\n{2}",
-                    ui_strings::transport_layer_text_head,
-                    message.payload.data,
-                    ui_strings::transport_layer_text_tail );
-    }
+struct [[ nodiscard ]] open_loop_execution_t
+{
+    const topology_t* topology;
+    std::vector<open_loop_connection_t> connections;
+    std::vector<open_loop_worker_t> workers;
+    uint64_t requests_budget;
+    std::chrono::steady_clock::time_point start_time;
+    std::chrono::steady_clock::time_point deadline;
+};
 
-    return result;
-}
+using due_request_t = std::pair<std::chrono::steady_clock::time_point, uint32_t>;
 
 void
-execute_connection1( const uint32_t node1_process1_num,
-                     const uint32_t node2_process2_num )
+wait_until( const std::chrono::steady_clock::time_point time )
 {
-    std::pair<message_t, bool> node1_process1_message_from_transport { message_t { }, true };
-    std::pair<message_t, bool> node2_process2_message_from_transport { message_t { }, true };
+    using std::chrono::steady_clock;
 
-    while ( true )
+    if ( time - steady_clock::now( ) > open_loop_spin_threshold )
     {
-        message_t node1_process1_message { node1_process1( node1_process1_num,
-                                                           node1_process1_message_from_transport ) };
+        std::this_thread::sleep_until( time - open_loop_spin_threshold );
+    }
 
-        if ( node1_process1_message.destination_port_num == 0 )
-        {
-            fmt::print( R"(    /|\/|\/|\    closing connection1 by node1_process1...    /|\/|\/|\     )""\n\n" );
+    while ( steady_clock::now( ) < time )
+    {
+        std::this_thread::yield( );
+    }
+}
 
-            break;
-        }
+// Steps a connection through the round trip of its next request. The protocol closes the
+// connection every few round trips, and so does a lost segment, in which case the request
+// is sent again over the connection reopened. Returns false if the run ends before the
+// response arrives.
+[[ nodiscard ]] bool
+execute_open_loop_round_trip( open_loop_execution_t& execution, const uint32_t connection_idx )
+{
+    auto& [ connection, traffic_source, statistics, answered_request_count ] { execution.connections[ connection_idx ] };
 
-        segment_t node1_process1_segment { node1_transport_to_channel( node1_process1_message ) };
+    while ( true )
+    {
+        const auto round_trip_count { connection.get_statistics( ).round_trip_count };
 
-        segment_t nodes_1_to_2_channel_output { channel( node1_process1_segment ) };
+        while ( connection.step( ) && connection.get_statistics( ).round_trip_count == round_trip_count ) { }
 
-        node2_process2_message_from_transport = node2_transport_from_channel( nodes_1_to_2_channel_output );
+        if ( connection.get_statistics( ).round_trip_count != round_trip_count )
+        {
+            return true;
+        }
 
-        message_t node2_process2_message { node2_process2( node2_process2_num,
-                                                           node2_process2_message_from_transport ) };
+        statistics += connection.get_statistics( );
+        ++statistics.connection_count;
 
-        if ( node2_process2_message.destination_port_num == 0 )
+        if ( std::chrono::steady_clock::now( ) >= execution.deadline )
         {
-            fmt::print( R"(    /|\/|\/|\    closing connection1 by node2_process2...    /|\/|\/|\     )""\n\n" );
-
-            break;
+            return false;
         }
 
-        segment_t node2_process2_segment { node2_transport_to_channel( node2_process2_message ) };
+        connection = Connection { *execution.topology, connection_idx, static_cast<uint32_t>( statistics.connection_count ) };
+    }
+}
 
-        segment_t nodes_2_to_1_channel_output { channel( node2_process2_segment ) };
+// Counts the requests of a connection that fall due before the end of the run, from the
+// one that is due at due_time on.
+[[ nodiscard ]] uint64_t
+count_due_requests( open_loop_execution_t& execution, const due_request_t& due_request )
+{
+    auto& traffic_source { execution.connections[ due_request.second ].traffic_source };
+    uint64_t request_count { };
 
-        node1_process1_message_from_transport = node1_transport_from_channel( nodes_2_to_1_channel_output );
+    for ( auto due_time { due_request.first }; due_time < execution.deadline;
+          due_time = execution.start_time + traffic_source.get_next_send_time( ) )
+    {
+        ++request_count;
     }
+
+    return request_count;
 }
 
+// The heap algorithms of libstdc++ that order the due requests do signed iterator
+// arithmetic that GCC assumes does not overflow, and report it under -Wstrict-overflow.
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wstrict-overflow"
+#endif
+
+// Runs the connections whose indices are congruent to worker_idx modulo worker_count, one
+// request at a time in the order in which they fall due, so that when the requests come
+// in faster than the worker can carry them they queue up and their latencies grow.
 void
-execute_connection2( const uint32_t node1_process2_num,
-                     const uint32_t node2_process1_num )
+run_open_loop_worker( open_loop_execution_t& execution, const size_t worker_idx, const size_t worker_count )
 {
-    std::pair<message_t, bool> node1_process2_message_from_transport { message_t { }, true };
-    std::pair<message_t, bool> node2_process1_message_from_transport { message_t { }, true };
+    auto& worker { execution.workers[ worker_idx ] };
+    const auto connection_count { std::size( execution.connections ) };
 
-    while ( true )
+    std::vector<due_request_t> due_requests;
+    due_requests.reserve( ( connection_count + worker_count - 1 ) / worker_count );
+
+    for ( auto connection_idx { worker_idx }; connection_idx < connection_count; connection_idx += worker_count )
+    {
+        due_requests.emplace_back( execution.start_time +
+                                   execution.connections[ connection_idx ].traffic_source.get_next_send_time( ),
+                                   static_cast<uint32_t>( connection_idx ) );
+    }
+
+    std::ranges::make_heap( due_requests, std::ranges::greater { } );
+
+    while ( std::empty( due_requests ) == false )
     {
-        message_t node1_process2_message { node1_process2( node1_process2_num,
-                                                           node1_process2_message_from_transport ) };
+        std::ranges::pop_heap( due_requests, std::ranges::greater { } );
+        const auto due_request { due_requests.back( ) };
+        const auto [ due_time, connection_idx ] { due_request };
 
-        if ( node1_process2_message.destination_port_num == 0 )
+        if ( due_time >= execution.deadline )
         {
-            fmt::print( R"(    /|\/|\/|\    closing connection2 by node1_process2...    /|\/|\/|\     )""\n\n" );
+            due_requests.pop_back( );
 
-            break;
+            continue;
         }
 
-        segment_t node1_process2_segment { node1_transport_to_channel( node1_process2_message ) };
+        wait_until( due_time );
+        const auto send_time { std::chrono::steady_clock::now( ) };
 
-        segment_t nodes_1_to_2_channel_output { channel( node1_process2_segment ) };
+        if ( send_time >= execution.deadline || execute_open_loop_round_trip( execution, connection_idx ) == false )
+        {
+            break;
+        }
 
-        node2_process1_message_from_transport = node2_transport_from_channel( nodes_1_to_2_channel_output );
+        const auto response_time { std::chrono::steady_clock::now( ) };
+        worker.latencies_from_schedule.record( static_cast<uint64_t>( ( response_time - due_time ).count( ) ) );
+        worker.latencies_from_send.record( static_cast<uint64_t>( ( response_time - send_time ).count( ) ) );
 
-        message_t node2_process1_message { node2_process1( node2_process1_num,
-                                                           node2_process1_message_from_transport ) };
+        auto& connection { execution.connections[ connection_idx ] };
+        ++connection.answered_request_count;
 
-        if ( node2_process1_message.destination_port_num == 0 )
+        if ( execution.requests_budget != 0 && connection.answered_request_count == execution.requests_budget )
         {
-            fmt::print( R"(    /|\/|\/|\    closing connection2 by node2_process1...    /|\/|\/|\     )""\n\n" );
+            due_requests.pop_back( );
 
-            break;
+            continue;
         }
 
-        segment_t node2_process1_segment { node2_transport_to_channel( node2_process1_message ) };
-
-        segment_t nodes_2_to_1_channel_output { channel( node2_process1_segment ) };
+        due_requests.back( ).first = execution.start_time + connection.traffic_source.get_next_send_time( );
+        std::ranges::push_heap( due_requests, std::ranges::greater { } );
+    }
 
-        node1_process2_message_from_transport = node1_transport_from_channel( nodes_2_to_1_channel_output );
+    // The run is over while these were still waiting to go out or to be answered.
+    for ( const auto& due_request : due_requests )
+    {
+        worker.unanswered_request_count += count_due_requests( execution, due_request );
     }
 }
 
-void
-set_layers_delays( const bool layers_delays_status ) noexcept
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic pop
+#endif
+
+[[ nodiscard ]] open_loop_latencies_t
+get_open_loop_latencies( const util::LatencyHistogram& histogram ) noexcept
 {
-    if ( layers_delays_status == true )
+    const auto get_percentile { [ &histogram ]( const double percentile )
+                                {
+                                    return std::chrono::nanoseconds { histogram.get_value_at_percentile( percentile ) };
+                                } };
+
+    return open_loop_latencies_t { get_percentile( 50.0 ), get_percentile( 90.0 ), get_percentile( 99.0 ),
+                                   get_percentile( 99.9 ), std::chrono::nanoseconds { histogram.get_max( ) } };
+}
+
+// The stages of the pipeline, in the order in which the items go round them.
+enum class pipeline_stage_t : uint8_t
+{
+    application,
+    transport_to_channel,
+    channel,
+    transport_from_channel
+};
+
+constexpr auto pipeline_stage_count { 4uz };
+
+// What a stage hands on to the next one on behalf of a connection: a message between the
+// application and transport layers, the segment that goes into the channel and what comes
+// out of it between the transport layer and the channel. A lost segment goes on as an
+// empty delivery, so that the application layer closes its connection.
+struct [[ nodiscard ]] pipeline_item_t
+{
+    std::pair<message_t, bool> message;
+    segment_t sent_segment;
+    channel_delivery_t delivery;
+    uint32_t connection_idx;
+    uint32_t incarnation;
+    channel_direction_t direction;
+    bool is_shutdown;   // goes round the stages once every connection has closed
+};
+
+using pipeline_ring_t = util::SpscRing<pipeline_item_t, pipeline_ring_capacity>;
+
+struct [[ nodiscard ]] pipelined_connection_t
+{
+    process_context_t initiator;
+    process_context_t responder;
+    uint64_t round_trip_count;
+    uint32_t incarnation;
+};
+
+struct [[ nodiscard ]] pipelined_execution_t
+{
+    const topology_t* topology;
+    uint64_t round_trips_budget;
+    std::chrono::steady_clock::time_point deadline;
+    bool is_time_budget_set;
+
+    // Each stage takes its items from the ring of its own index.
+    std::array<pipeline_ring_t, pipeline_stage_count> rings;
+    std::array<connection_statistics_t, pipeline_stage_count> stage_statistics;
+};
+
+// A stage is only ever kept waiting for as long as its neighbours take over an item, so it
+// spins on its rings rather than sleeps, but yields in case the stages outnumber the cores.
+void
+push_pipeline_item( pipeline_ring_t& ring, const pipeline_item_t& item ) noexcept
+{
+    while ( ring.try_push( item ) == false )
+    {
+        std::this_thread::yield( );
+    }
+}
+
+[[ nodiscard ]] pipeline_item_t
+pop_pipeline_item( pipeline_ring_t& ring ) noexcept
+{
+    pipeline_item_t item;
+
+    while ( ring.try_pop( item ) == false )
+    {
+        std::this_thread::yield( );
+    }
+
+    return item;
+}
+
+// The node that sends in the given direction of a connection, followed by its peer.
+[[ nodiscard ]] std::pair<const node_t*, const node_t*>
+get_sending_nodes( const topology_t& topology, const uint32_t connection_idx,
+                   const channel_direction_t direction ) noexcept
+{
+    const auto& connection { topology.connections[ connection_idx ] };
+    const auto* const initiator_node { &topology.nodes[ topology.processes[ connection.initiator_process_idx ].node_idx ] };
+    const auto* const responder_node { &topology.nodes[ topology.processes[ connection.responder_process_idx ].node_idx ] };
+
+    return direction == channel_direction_t::forward ? std::pair { initiator_node, responder_node }
+                                                     : std::pair { responder_node, initiator_node };
+}
+
+[[ nodiscard ]] pipelined_connection_t
+make_pipelined_connection( const topology_t& topology, const uint32_t connection_idx ) noexcept
+{
+    const auto& connection { topology.connections[ connection_idx ] };
+    const auto& initiator_process { topology.processes[ connection.initiator_process_idx ] };
+    const auto& responder_process { topology.processes[ connection.responder_process_idx ] };
+    const auto& protocol { topology.protocols[ connection.protocol_idx ] };
+
+    return pipelined_connection_t { process_context_t { &initiator_process, &topology.nodes[ initiator_process.node_idx ],
+                                                        &protocol, responder_process.port_num, 0,
+                                                        process_role_t::initiator },
+                                    process_context_t { &responder_process, &topology.nodes[ responder_process.node_idx ],
+                                                        &protocol, initiator_process.port_num, 0,
+                                                        process_role_t::responder },
+                                    0, 0 };
+}
+
+// Passes every item that comes into a stage through process_item and on to the next
+// stage, until the shutdown item has gone through.
+template <class ProcessItem>
+void
+run_pipeline_stage( pipelined_execution_t& execution, const pipeline_stage_t stage, ProcessItem&& process_item )
+{
+    const auto stage_idx { size_t { std::to_underlying( stage ) } };
+    auto& input_ring { execution.rings[ stage_idx ] };
+    auto& output_ring { execution.rings[ ( stage_idx + 1 ) % pipeline_stage_count ] };
+
+    connection_statistics_t statistics { };
+
+    while ( true )
+    {
+        auto item { pop_pipeline_item( input_ring ) };
+
+        if ( item.is_shutdown == false )
+        {
+            traced_connection_num = item.connection_idx + 1;
+            process_item( item, statistics );
+        }
+
+        push_pipeline_item( output_ring, item );
+
+        if ( item.is_shutdown )
+        {
+            break;
+        }
+    }
+
+    execution.stage_statistics[ stage_idx ] = statistics;
+}
+
+// Plays both processes of every connection: turns each request that comes up from the
+// transport layer into a response and each response into the next request, and opens
+// the connections one after another, as many at a time as the rings leave room for.
+void
+run_application_stage( pipelined_execution_t& execution )
+{
+    const auto& topology { *execution.topology };
+    const auto connection_count { static_cast<uint32_t>( std::size( topology.connections ) ) };
+    const auto max_open_connection_count { std::min( connection_count,
+                                                     static_cast<uint32_t>( pipeline_ring_capacity ) ) };
+    const auto stage_idx { size_t { std::to_underlying( pipeline_stage_t::application ) } };
+    auto& input_ring { execution.rings[ stage_idx ] };
+    auto& output_ring { execution.rings[ stage_idx + 1 ] };
+
+    std::vector<pipelined_connection_t> connections { };
+    connections.reserve( connection_count );
+
+    for ( auto connection_idx { 0u }; connection_idx < connection_count; ++connection_idx )
+    {
+        connections.push_back( make_pipelined_connection( topology, connection_idx ) );
+    }
+
+    connection_statistics_t statistics { };
+
+    // Returns whether the message went out rather than closed its connection.
+    const auto send_message { [ &statistics, &output_ring, &connections ]( const uint32_t connection_idx,
+                                                                           const message_t message,
+                                                                           const channel_direction_t direction )
+                              {
+                                  if ( message.destination_port_num == 0 )
+                                  {
+                                      return false;
+                                  }
+
+                                  ++statistics.message_count;
+                                  push_pipeline_item( output_ring, pipeline_item_t { { message, true }, { }, { },
+                                                                                     connection_idx,
+                                                                                     connections[ connection_idx ].incarnation,
+                                                                                     direction, false } );
+
+                                  return true;
+                              } };
+
+    // As in the benchmark on the thread pool, a connection that closes is reopened over
+    // and over until its budget is used up; returns whether it is open again.
+    const auto reopen_connection { [ &execution, &connections, &statistics, &send_message ]( const uint32_t connection_idx )
+                                   {
+                                       auto& connection { connections[ connection_idx ] };
+
+                                       while ( ( execution.round_trips_budget == 0 ||
+                                                 connection.round_trip_count < execution.round_trips_budget ) &&
+                                               ( execution.is_time_budget_set == false ||
+                                                 std::chrono::steady_clock::now( ) < execution.deadline ) )
+                                       {
+                                           connection.initiator.request_counter = 0;
+                                           connection.responder.request_counter = 0;
+
+                                           const std::pair<message_t, bool> opening_message { message_t { }, true };
+
+                                           if ( send_message( connection_idx,
+                                                              application_process( connection.initiator, opening_message ),
+                                                              channel_direction_t::forward ) )
+                                           {
+                                               return true;
+                                           }
+
+                                           ++statistics.connection_count;
+                                           count_event( event_counter_t::closed_connections );
+                                           ++connection.incarnation;
+                                       }
+
+                                       return false;
+                                   } };
+
+    auto next_connection_idx { 0u };
+    auto open_connection_count { 0u };
+
+    const auto open_pending_connections { [ & ]
+                                          {
+                                              while ( open_connection_count < max_open_connection_count &&
+                                                      next_connection_idx < connection_count )
+                                              {
+                                                  if ( reopen_connection( next_connection_idx++ ) )
+                                                  {
+                                                      ++open_connection_count;
+                                                  }
+                                              }
+                                          } };
+
+    open_pending_connections( );
+
+    while ( open_connection_count > 0 )
+    {
+        const auto item { pop_pipeline_item( input_ring ) };
+        auto& connection { connections[ item.connection_idx ] };
+
+        bool is_open { };
+
+        if ( item.delivery.segment_count != 0 && item.direction == channel_direction_t::forward )
+        {
+            is_open = send_message( item.connection_idx, application_process( connection.responder, item.message ),
+                                    channel_direction_t::backward );
+        }
+        else if ( item.delivery.segment_count != 0 )
+        {
+            ++connection.round_trip_count;
+            ++statistics.round_trip_count;
+
+            is_open = send_message( item.connection_idx, application_process( connection.initiator, item.message ),
+                                    channel_direction_t::forward );
+        }
+
+        if ( is_open )
+        {
+            continue;
+        }
+
+        ++statistics.connection_count;
+        count_event( event_counter_t::closed_connections );
+        ++connection.incarnation;
+
+        if ( reopen_connection( item.connection_idx ) == false )
+        {
+            --open_connection_count;
+            open_pending_connections( );
+        }
+    }
+
+    push_pipeline_item( output_ring, pipeline_item_t { { }, { }, { }, 0, 0, channel_direction_t::forward, true } );
+
+    execution.stage_statistics[ stage_idx ] = statistics;
+}
+
+void
+run_transport_to_channel_stage( pipelined_execution_t& execution )
+{
+    const auto& topology { *execution.topology };
+
+    run_pipeline_stage( execution, pipeline_stage_t::transport_to_channel,
+                        [ &topology ]( pipeline_item_t& item, connection_statistics_t& )
+                        {
+                            const auto [ node, peer_node ] { get_sending_nodes( topology, item.connection_idx,
+                                                                                item.direction ) };
+
+                            item.sent_segment = transport_to_channel( *node, *peer_node, item.message.first );
+                        } );
+}
+
+// Keeps the channel stream of every connection, so that a connection sees the same faults
+// as it does on the thread pool, whatever the other connections in the pipeline.
+void
+run_channel_stage( pipelined_execution_t& execution )
+{
+    const auto connection_count { static_cast<uint32_t>( std::size( execution.topology->connections ) ) };
+
+    std::vector<channel_stream_t> streams { };
+    std::vector<uint32_t> stream_incarnations( connection_count, 0u );
+    streams.reserve( connection_count );
+
+    for ( auto connection_idx { 0u }; connection_idx < connection_count; ++connection_idx )
+    {
+        streams.push_back( make_channel_stream( connection_idx, 0 ) );
+    }
+
+    run_pipeline_stage( execution, pipeline_stage_t::channel,
+                        [ &streams, &stream_incarnations ]( pipeline_item_t& item, connection_statistics_t& statistics )
+                        {
+                            auto& stream { streams[ item.connection_idx ] };
+
+                            if ( stream_incarnations[ item.connection_idx ] != item.incarnation )
+                            {
+                                stream = make_channel_stream( item.connection_idx, item.incarnation );
+                                stream_incarnations[ item.connection_idx ] = item.incarnation;
+                            }
+
+                            item.delivery = channel( item.sent_segment, item.direction, stream );
+                            ++statistics.segment_count;
+
+                            if ( item.delivery.segment_count == 0 )
+                            {
+                                ++statistics.loss_count;
+                            }
+                        } );
+}
+
+void
+run_transport_from_channel_stage( pipelined_execution_t& execution )
+{
+    const auto& topology { *execution.topology };
+
+    run_pipeline_stage( execution, pipeline_stage_t::transport_from_channel,
+                        [ &topology ]( pipeline_item_t& item, connection_statistics_t& statistics )
+                        {
+                            if ( item.delivery.segment_count == 0 )
+                            {
+                                return;
+                            }
+
+                            const auto [ peer_node, node ] { get_sending_nodes( topology, item.connection_idx,
+                                                                                item.direction ) };
+                            auto integrity { segment_integrity_t::intact };
+
+                            item.message = transport_from_channel( *node, *peer_node, item.delivery.segments[ 0 ],
+                                                                   integrity );
+
+                            if ( item.delivery.segment_count == 2 )
+                            {
+                                ++statistics.duplicate_count;
+                                discard_duplicate_segment( *node, item.delivery.segments[ 1 ] );
+                            }
+
+                            count_delivery( statistics, integrity, item.sent_segment, item.delivery.segments[ 0 ] );
+                        } );
+}
+
+// Gives each stage a core of its own when there are enough of them to go round.
+void
+pin_pipeline_stage( [[ maybe_unused ]] std::jthread& stage_thread, [[ maybe_unused ]] const size_t stage_idx ) noexcept
+{
+#if PLATFORM_NAME == OS_GNULINUX
+    if ( std::thread::hardware_concurrency( ) < pipeline_stage_count )
+    {
+        return;
+    }
+
+    cpu_set_t cpu_set;
+    CPU_ZERO( &cpu_set );
+    CPU_SET( stage_idx, &cpu_set );
+
+    // Pinning is only an optimization, so a failure to pin is of no consequence.
+    pthread_setaffinity_np( stage_thread.native_handle( ), sizeof( cpu_set ), &cpu_set );
+#endif
+}
+
+// What crosses from one side of the multiprocess benchmark to the other.
+enum class node_link_record_kind_t : uint8_t
+{
+    segment,            // as it goes into the channel, whose faults the receiving side draws
+    closed_connection,  // by the side of the responder, for the side that opened it to reopen it
+    finished            // the sending side has no connections of its own left open
+};
+
+struct [[ nodiscard ]] node_link_record_t
+{
+    segment_t segment;
+    uint32_t connection_idx;
+    uint32_t incarnation;
+    channel_direction_t direction;
+    node_link_record_kind_t kind;
+};
+
+using node_link_ring_t = util::SpscRing<node_link_record_t, node_link_ring_capacity>;
+
+// The channel stream of a connection is shared by both sides, so that the connection
+// sees the same faults as it does on the thread pool. Only the side that takes the record
+// of the connection off its ring touches it, and the ring orders the accesses.
+struct [[ nodiscard ]] shared_channel_stream_t
+{
+    channel_stream_t stream;
+    uint32_t incarnation;
+};
+
+// The layout of the shared-memory segment of the multiprocess benchmark, which goes on
+// with the channel streams of the connections and the message counts of the processes
+// of the topology made by the forked side. The records are written straight into the
+// slots of the rings and read straight out of them, so a segment crosses between the
+// processes without a system call or a copy of its own.
+struct node_link_t
+{
+    std::array<node_link_ring_t, node_side_count> rings;   // indexed by the side that reads from it
+    connection_statistics_t forked_side_statistics;
+    event_counts_t forked_side_event_counts;
+};
+
+struct [[ nodiscard ]] node_side_execution_t
+{
+    const topology_t* topology;
+    node_link_t* link;
+    std::span<shared_channel_stream_t> streams;
+    size_t side;
+    int peer_process_id;
+    uint64_t round_trips_budget;
+    std::chrono::steady_clock::time_point deadline;
+    bool is_time_budget_set;
+};
+
+[[ nodiscard ]] size_t
+get_node_side( const topology_t& topology, const uint32_t process_idx ) noexcept
+{
+    return topology.processes[ process_idx ].node_idx % node_side_count;
+}
+
+// The parent finds out that the forked process has exited without reaping it, and the
+// forked process that the parent has exited once it gets adopted by another one.
+[[ nodiscard ]] bool
+is_peer_side_alive( [[ maybe_unused ]] const node_side_execution_t& execution ) noexcept
+{
+#if PLATFORM_NAME != OS_WINDOWS
+    if ( execution.side != 0 )
+    {
+        return ::getppid( ) == execution.peer_process_id;
+    }
+
+    siginfo_t info { };
+
+    return ::waitid( P_PID, static_cast<id_t>( execution.peer_process_id ), &info, WEXITED | WNOHANG | WNOWAIT ) == 0 &&
+           info.si_pid == 0;
+#else
+    return false;
+#endif
+}
+
+void
+push_node_link_record( node_link_ring_t& ring, const node_link_record_t& record ) noexcept
+{
+    while ( ring.try_push( record ) == false )
+    {
+        std::this_thread::yield( );
+    }
+}
+
+// Throws std::runtime_error if the other side is gone before anything comes in.
+[[ nodiscard ]] node_link_record_t
+pop_node_link_record( const node_side_execution_t& execution )
+{
+    auto& ring { execution.link->rings[ execution.side ] };
+    node_link_record_t record;
+
+    for ( auto attempt_count { 1uz }; ring.try_pop( record ) == false; ++attempt_count )
+    {
+        // What the other side sent just before it exited is still to be taken.
+        if ( attempt_count % node_link_liveness_check_interval == 0 && is_peer_side_alive( execution ) == false &&
+             ring.try_pop( record ) == false )
+        {
+            throw std::runtime_error { "the process of the other nodes has exited before the end of the run" };
+        }
+
+        std::this_thread::yield( );
+    }
+
+    return record;
+}
+
+// Pins the calling thread to the core configured for its side, if any.
+void
+pin_node_side( const size_t side )
+{
+    if ( node_cpus.has_value( ) == false )
+    {
+        return;
+    }
+
+#if PLATFORM_NAME == OS_GNULINUX
+    cpu_set_t cpu_set;
+    CPU_ZERO( &cpu_set );
+    CPU_SET( ( *node_cpus )[ side ], &cpu_set );
+
+    // Unlike the stages of the pipeline, the sides are only pinned when asked to.
+    if ( const int error_code { pthread_setaffinity_np( pthread_self( ), sizeof( cpu_set ), &cpu_set ) };
+         error_code != 0 )
+    {
+        throw std::system_error { error_code, std::generic_category( ), "Failure in pinning the nodes to their core" };
+    }
+#else
+    throw std::system_error { std::make_error_code( std::errc::not_supported ), "Pinning the nodes is not supported" };
+#endif
+}
+
+// Plays the processes of the nodes of one side, both as the initiators of the connections
+// that they open and as the responders to those that the other side opens, along with
+// their transport layers and the channel from the other side: a segment goes through
+// the faults of the channel as the receiving side takes it off its ring. Each side opens
+// its connections as the application stage of the pipeline does and keeps going until
+// both sides are done with theirs.
+[[ nodiscard ]] connection_statistics_t
+run_node_side( const node_side_execution_t& execution )
+{
+    const auto& topology { *execution.topology };
+    const auto connection_count { static_cast<uint32_t>( std::size( topology.connections ) ) };
+    auto& output_ring { execution.link->rings[ node_side_count - 1 - execution.side ] };
+
+    std::vector<pipelined_connection_t> connections { };
+    std::vector<uint32_t> opened_connection_idxs { };
+    connections.reserve( connection_count );
+
+    for ( auto connection_idx { 0u }; connection_idx < connection_count; ++connection_idx )
+    {
+        connections.push_back( make_pipelined_connection( topology, connection_idx ) );
+
+        if ( get_node_side( topology, topology.connections[ connection_idx ].initiator_process_idx ) == execution.side )
+        {
+            opened_connection_idxs.push_back( connection_idx );
+        }
+    }
+
+    connection_statistics_t statistics { };
+
+    // Returns whether the message went out rather than closed its connection.
+    const auto send_message { [ &topology, &statistics, &output_ring, &connections ]( const uint32_t connection_idx,
+                                                                                      const message_t message,
+                                                                                      const channel_direction_t direction )
+                              {
+                                  if ( message.destination_port_num == 0 )
+                                  {
+                                      return false;
+                                  }
+
+                                  ++statistics.message_count;
+
+                                  const auto [ node, peer_node ] { get_sending_nodes( topology, connection_idx, direction ) };
+                                  push_node_link_record( output_ring,
+                                                         node_link_record_t { transport_to_channel( *node, *peer_node, message ),
+                                                                              connection_idx,
+                                                                              connections[ connection_idx ].incarnation,
+                                                                              direction, node_link_record_kind_t::segment } );
+
+                                  return true;
+                              } };
+
+    // As in the pipeline, a connection that closes is reopened over and over until its
+    // budget is used up; returns whether it is open again.
+    const auto reopen_connection { [ &execution, &connections, &statistics, &send_message ]( const uint32_t connection_idx )
+                                   {
+                                       auto& connection { connections[ connection_idx ] };
+
+                                       while ( ( execution.round_trips_budget == 0 ||
+                                                 connection.round_trip_count < execution.round_trips_budget ) &&
+                                               ( execution.is_time_budget_set == false ||
+                                                 std::chrono::steady_clock::now( ) < execution.deadline ) )
+                                       {
+                                           connection.initiator.request_counter = 0;
+
+                                           const std::pair<message_t, bool> opening_message { message_t { }, true };
+
+                                           if ( send_message( connection_idx,
+                                                              application_process( connection.initiator, opening_message ),
+                                                              channel_direction_t::forward ) )
+                                           {
+                                               return true;
+                                           }
+
+                                           ++statistics.connection_count;
+                                           count_event( event_counter_t::closed_connections );
+                                           ++connection.incarnation;
+                                       }
+
+                                       return false;
+                                   } };
+
+    auto next_opened_connection_pos { 0uz };
+    auto open_connection_count { 0u };
+
+    const auto open_pending_connections { [ & ]
+                                          {
+                                              while ( open_connection_count < max_open_connections_per_side &&
+                                                      next_opened_connection_pos < std::size( opened_connection_idxs ) )
+                                              {
+                                                  const auto connection_idx { opened_connection_idxs[ next_opened_connection_pos++ ] };
+                                                  traced_connection_num = connection_idx + 1;
+
+                                                  if ( reopen_connection( connection_idx ) )
+                                                  {
+                                                      ++open_connection_count;
+                                                  }
+                                              }
+                                          } };
+
+    const auto close_connection { [ & ]( const uint32_t connection_idx )
+                                  {
+                                      ++statistics.connection_count;
+                                      count_event( event_counter_t::closed_connections );
+                                      ++connections[ connection_idx ].incarnation;
+
+                                      if ( reopen_connection( connection_idx ) == false )
+                                      {
+                                          --open_connection_count;
+                                          open_pending_connections( );
+                                      }
+                                  } };
+
+    open_pending_connections( );
+
+    auto is_finished { false };
+    auto is_peer_finished { false };
+
+    while ( is_finished == false || is_peer_finished == false )
+    {
+        if ( open_connection_count == 0 && is_finished == false )
+        {
+            push_node_link_record( output_ring, node_link_record_t { { }, 0, 0, channel_direction_t::forward,
+                                                                     node_link_record_kind_t::finished } );
+            is_finished = true;
+
+            continue;
+        }
+
+        const auto record { pop_node_link_record( execution ) };
+        const auto connection_idx { record.connection_idx };
+        traced_connection_num = connection_idx + 1;
+
+        if ( record.kind == node_link_record_kind_t::finished )
+        {
+            is_peer_finished = true;
+
+            continue;
+        }
+
+        if ( record.kind == node_link_record_kind_t::closed_connection )
+        {
+            close_connection( connection_idx );
+
+            continue;
+        }
+
+        auto& [ stream, stream_incarnation ] { execution.streams[ connection_idx ] };
+
+        if ( stream_incarnation != record.incarnation )
+        {
+            stream = make_channel_stream( connection_idx, record.incarnation );
+            stream_incarnation = record.incarnation;
+        }
+
+        const auto delivery { channel( record.segment, record.direction, stream ) };
+        ++statistics.segment_count;
+
+        auto& connection { connections[ connection_idx ] };
+        bool is_open { };
+
+        if ( delivery.segment_count == 0 )
+        {
+            ++statistics.loss_count;
+        }
+        else
+        {
+            const auto [ peer_node, node ] { get_sending_nodes( topology, connection_idx, record.direction ) };
+            auto integrity { segment_integrity_t::intact };
+
+            const auto message { transport_from_channel( *node, *peer_node, delivery.segments[ 0 ], integrity ) };
+
+            if ( delivery.segment_count == 2 )
+            {
+                ++statistics.duplicate_count;
+                discard_duplicate_segment( *node, delivery.segments[ 1 ] );
+            }
+
+            count_delivery( statistics, integrity, record.segment, delivery.segments[ 0 ] );
+
+            if ( record.direction == channel_direction_t::forward )
+            {
+                // The responses go back under the incarnation of the request.
+                connection.incarnation = record.incarnation;
+                is_open = send_message( connection_idx, application_process( connection.responder, message ),
+                                        channel_direction_t::backward );
+            }
+            else
+            {
+                ++connection.round_trip_count;
+                ++statistics.round_trip_count;
+
+                is_open = send_message( connection_idx, application_process( connection.initiator, message ),
+                                        channel_direction_t::forward );
+            }
+        }
+
+        if ( is_open )
+        {
+            continue;
+        }
+
+        if ( record.direction == channel_direction_t::forward )
+        {
+            push_node_link_record( output_ring, node_link_record_t { { }, connection_idx, record.incarnation,
+                                                                     channel_direction_t::backward,
+                                                                     node_link_record_kind_t::closed_connection } );
+        }
+        else
+        {
+            close_connection( connection_idx );
+        }
+    }
+
+    return statistics;
+}
+
+// Runs the forked side and leaves its statistics and the counts of its events in the
+// shared memory for the parent, then exits at once: the forked process has none of the
+// threads of its parent and must not run its destructors or flush its buffers.
+[[ noreturn ]] void
+run_forked_node_side( const node_side_execution_t& execution,
+                      const std::span<process_message_counts_t> process_counts_OUT ) noexcept
+{
+    auto exit_code { EXIT_FAILURE };
+
+    try
+    {
+        pin_node_side( execution.side );
+
+        // Whatever the parent counted before the fork is in here too.
+        const auto initial_event_counts { read_event_counts( ) };
+        std::vector<process_message_counts_t> initial_process_counts( std::size( process_counts_OUT ) );
+        read_process_message_counts( initial_process_counts );
+
+        execution.link->forked_side_statistics = run_node_side( execution );
+
+        using event_count_words_t = std::array<uint64_t, sizeof( event_counts_t ) / sizeof( uint64_t )>;
+
+        auto event_count_words { std::bit_cast<event_count_words_t>( read_event_counts( ) ) };
+        const auto initial_event_count_words { std::bit_cast<event_count_words_t>( initial_event_counts ) };
+
+        for ( auto word_idx { 0uz }; word_idx < std::size( event_count_words ); ++word_idx )
+        {
+            event_count_words[ word_idx ] -= initial_event_count_words[ word_idx ];
+        }
+
+        execution.link->forked_side_event_counts = std::bit_cast<event_counts_t>( event_count_words );
+
+        read_process_message_counts( process_counts_OUT );
+
+        for ( auto process_idx { 0uz }; process_idx < std::size( process_counts_OUT ); ++process_idx )
+        {
+            process_counts_OUT[ process_idx ].sent_count -= initial_process_counts[ process_idx ].sent_count;
+            process_counts_OUT[ process_idx ].received_count -= initial_process_counts[ process_idx ].received_count;
+        }
+
+        exit_code = EXIT_SUCCESS;
+    }
+    catch ( ... )
+    {
+    }
+
+#if PLATFORM_NAME != OS_WINDOWS
+    ::_exit( exit_code );
+#else
+    std::quick_exit( exit_code );
+#endif
+}
+
+void
+schedule_connection_step( des::EventScheduler& scheduler, Connection& connection )
+{
+    // The step advances the simulated clock by the delay of the layer it executes,
+    // hence the next step is due as soon as the current one completes.
+    scheduler.schedule_after( des::simulation_clock::duration::zero( ),
+                              [ &scheduler, &connection ]
+                              {
+                                  if ( connection.step( ) )
+                                  {
+                                      schedule_connection_step( scheduler, connection );
+                                  }
+                              } );
+}
+
+[[ nodiscard ]] std::chrono::duration<double, std::nano>
+measure_segment_check_time( )
+{
+    using std::chrono::steady_clock;
+
+    constexpr auto sample_count { 1uz << 22 };
+
+    // Spreads the samples over the possible payloads and ports.
+    constexpr auto sample_stride { uint64_t { 0x9E37'79B9'7F4A'7C15 } };
+
+    auto accumulated_bits { segment_word_t { 0 } };
+    const auto start_time { steady_clock::now( ) };
+
+    for ( auto sample_idx { uint64_t { 0 } }; sample_idx < sample_count; ++sample_idx )
+    {
+        const auto data_bits { static_cast<segment_word_t>( ( sample_idx * sample_stride ) & data_bit_mask ) };
+        accumulated_bits ^= compute_segment_check_bits( data_bits );
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed_time { steady_clock::now( ) - start_time };
+
+    // Keeps the computation from being optimized away.
+    [[ maybe_unused ]] volatile auto sink { accumulated_bits };
+
+    return elapsed_time / sample_count;
+}
+
+}
+
+
+[[ nodiscard ]] message_t
+application_process( process_context_t& context,
+                     const std::pair<message_t, bool>& incoming_message )
+{
+    [[ maybe_unused ]] const auto layer_timer { time_layer( latency_layer_t::application ) };
+
+    const auto& [ process, node, protocol, peer_port_num, request_counter, role ] { context };
+
+    message_t message { };
+    message.source_port_num = process->port_num;
+
+    const auto& [ received_message, is_intact ] { incoming_message };
+
+    if ( is_intact )
+    {
+        trace( "{0}node{1}_process{2} received message: <{3}> from source #{4}\n\n{5}",
+               ui_strings::application_layer_text_head,
+               node->node_num,
+               process->process_num,
+               received_message.payload,
+               received_message.source_port_num,
+               ui_strings::application_layer_text_tail );
+
+        if ( role == process_role_t::initiator )
+        {
+            if ( received_message.payload.bits == protocol->closing_payload ) [[ unlikely ]]
+            {
+                message.destination_port_num = 0;
+            }
+            else
+            {
+                message.destination_port_num = peer_port_num;
+
+                message.payload.bits = protocol->request_payloads[ std::min( size_t { request_counter },
+                                                                             max_request_count - 1 ) ];
+
+                ++context.request_counter;
+            }
+        }
+        else
+        {
+            message.destination_port_num = peer_port_num;
+            message.payload.bits = protocol->response_payloads[ received_message.payload.bits ];
+        }
+
+        elapse( process->application_delay );
+
+        trace( "{0}node{1}_process{2} is sending message: <{3}> to destination #{4}\n\n{5}",
+               ui_strings::application_layer_text_head,
+               node->node_num,
+               process->process_num,
+               message.payload,
+               message.destination_port_num,
+               ui_strings::application_layer_text_tail );
+    }
+    else
+    {
+        trace( "{0}node{1}_process{2} received corrupt message: <{3}>\n\n{4}",
+               ui_strings::application_layer_text_head,
+               node->node_num,
+               process->process_num,
+               received_message.payload,
+               ui_strings::application_layer_text_tail );
+
+        message.destination_port_num = 0;
+
+        elapse( process->application_delay );
+
+        trace( "{0}node{1}_process{2} is sending message: <{3}> to destination #{4}\n\n{5}",
+               ui_strings::application_layer_text_head,
+               node->node_num,
+               process->process_num,
+               message.payload,
+               message.destination_port_num,
+               ui_strings::application_layer_text_tail );
+    }
+
+    return message;
+}
+
+[[ nodiscard ]] channel_delivery_t
+channel( const segment_t segment, const channel_direction_t direction, channel_stream_t& stream )
+{
+    channel_delivery_t delivery { };
+    delivery.segment_count = static_cast<uint8_t>( channel( std::span { &segment, 1uz }, delivery.segments,
+                                                            direction, stream ) );
+
+    return delivery;
+}
+
+[[ nodiscard ]] size_t
+channel( const std::span<const segment_t> segments, const std::span<segment_t> delivered_OUT,
+         const channel_direction_t direction, channel_stream_t& stream )
+{
+    [[ maybe_unused ]] const auto layer_timer { time_layer( latency_layer_t::channel ) };
+
+    for ( const auto segment : segments )
+    {
+        record_trace_event( trace_event_t::segment_entered_channel, 0, segment, std::to_underlying( direction ) );
+
+        trace( "{0}channel received: <{1}>\n\n{2}",
+               ui_strings::channel_text_head,
+               segment,
+               ui_strings::channel_text_tail );
+    }
+
+    count_event( event_counter_t::sent_segments, std::size( segments ) );
+
+    auto& fault_injector { stream.fault_injectors[ std::to_underlying( direction ) ] };
+    auto delivered_count { std::size( segments ) };
+
+    if ( fault_injector.is_faultless( ) ) [[ likely ]]
+    {
+        std::ranges::copy( segments, std::begin( delivered_OUT ) );
+    }
+    else
+    {
+        const auto previous_counters { fault_injector.get_counters( ) };
+        delivered_count = fault_injector.apply( segments, delivered_OUT, stream.generator );
+
+        count_event( event_counter_t::flipped_bits,
+                     fault_injector.get_counters( ).flipped_bit_count - previous_counters.flipped_bit_count );
+
+        if ( const auto lost_segment_count { fault_injector.get_counters( ).loss_count - previous_counters.loss_count };
+             lost_segment_count != 0 )
+        {
+            trace( "{0}channel lost {1} segment(s)\n\n{2}",
+                   ui_strings::channel_text_head,
+                   lost_segment_count,
+                   ui_strings::channel_text_tail );
+        }
+    }
+
+    const auto delivered_segments { delivered_OUT.first( delivered_count ) };
+
+    if ( is_channel_faulty )
+    {
+        count_event( event_counter_t::flipped_bits, inject_channel_faults( delivered_segments, stream.generator ) );
+    }
+
+    elapse( channel_default_delay );
+
+    for ( const auto segment : delivered_segments )
+    {
+        record_trace_event( trace_event_t::segment_left_channel, 0, segment, std::to_underlying( direction ) );
+
+        trace( "{0}channel is sending: <{1}>\n\n{2}",
+               ui_strings::channel_text_head,
+               segment,
+               ui_strings::channel_text_tail );
+    }
+
+    return delivered_count;
+}
+
+[[ nodiscard ]] segment_t
+transport_to_channel( const node_t& node, const node_t& peer_node, const message_t message,
+                      const segment_header_t header )
+{
+    [[ maybe_unused ]] const auto layer_timer { time_layer( latency_layer_t::transport_to_channel ) };
+
+    trace( "{0}node{1}_transport received message: <{2}> from source #{3}\n\n{4}",
+           ui_strings::transport_layer_text_head,
+           node.node_num,
+           message.payload,
+           message.source_port_num,
+           ui_strings::transport_layer_text_tail );
+
+    const segment_t segment { encode_segment( message.payload,
+                                              get_port_idx( node, message.source_port_num ),
+                                              get_port_idx( peer_node, message.destination_port_num ), header ) };
+
+    record_trace_event( trace_event_t::segment_encoded, node.node_num, segment, 0 );
+    count_process_message( node.first_process_idx + get_port_idx( node, message.source_port_num ), traced_connection_num,
+                           false );
+
+    elapse( node.transport_to_channel_delay );
+
+    trace( "{0}node{1}_transport is sending segment: <{2}> to destination #{3}\n\n{4}",
+           ui_strings::transport_layer_text_head,
+           node.node_num,
+           segment,
+           message.destination_port_num,
+           ui_strings::transport_layer_text_tail );
+
+    return segment;
+}
+
+[[ nodiscard ]] std::pair<message_t, bool>
+transport_from_channel( const node_t& node, const node_t& peer_node, const segment_t segment,
+                        segment_integrity_t& integrity_OUT )
+{
+    [[ maybe_unused ]] const auto layer_timer { time_layer( latency_layer_t::transport_from_channel ) };
+
+    const auto decoded_segment { decode_segment( segment ) };
+
+    integrity_OUT = get_segment_integrity( decoded_segment );
+
+    record_trace_event( trace_event_t::segment_decoded, node.node_num, segment, std::to_underlying( integrity_OUT ) );
+
+    std::pair<message_t, bool> result { };
+    auto& [ message, is_intact ] { result };
+
+    message.payload = decoded_segment.payload;
+    message.source_port_num = peer_node.first_port_num + decoded_segment.source_port_idx;
+    message.destination_port_num = node.first_port_num + decoded_segment.destination_port_idx;
+
+    if ( decoded_segment.is_corrected )
+    {
+        trace( "{0}node{1}_transport corrected a flipped bit of segment: <{2}>\n\n{3}",
+               ui_strings::transport_layer_text_head,
+               node.node_num,
+               segment,
+               ui_strings::transport_layer_text_tail );
+    }
+
+    if ( decoded_segment.is_intact )
+    {
+        trace( "{0}node{1}_transport received segment: <{2}> from source #{3}\n\n{4}",
+               ui_strings::transport_layer_text_head,
+               node.node_num,
+               segment,
+               message.source_port_num,
+               ui_strings::transport_layer_text_tail );
+
+        is_intact = true;
+        count_process_message( node.first_process_idx + decoded_segment.destination_port_idx, traced_connection_num, true );
+
+        elapse( node.transport_from_channel_delay );
+
+        trace( "{0}node{1}_transport is sending message: <{2}> to destination #{3}\n\n{4}",
+               ui_strings::transport_layer_text_head,
+               node.node_num,
+               message.payload,
+               message.destination_port_num,
+               ui_strings::transport_layer_text_tail );
+    }
+    else
+    {
+        trace( "{0}node{1}_transport received corrupt segment: <{2}>\n\n{3}",
+               ui_strings::transport_layer_text_head,
+               node.node_num,
+               segment,
+               ui_strings::transport_layer_text_tail );
+
+        is_intact = false;
+
+        elapse( node.transport_from_channel_delay );
+
+        trace( "{0}node{1}_transport is sending corrupt message: <{2}>\n\n{3}",
+               ui_strings::transport_layer_text_head,
+               node.node_num,
+               message.payload,
+               ui_strings::transport_layer_text_tail );
+    }
+
+    return result;
+}
+
+Connection::Connection( const topology_t& topology, const uint32_t connection_idx, const uint32_t incarnation,
+                        const uint32_t replication )
+    : m_coroutine { get_arq_protocol( ) == arq_protocol_t::none
+                    ? execute( topology, connection_idx, incarnation, replication )
+                    : execute_reliable( topology, connection_idx, incarnation, replication ) },
+      m_connection_num { connection_idx + 1 }
+{
+}
+
+bool
+Connection::step( )
+{
+    if ( m_coroutine.done( ) == false ) [[ likely ]]
+    {
+        traced_connection_num = m_connection_num;
+        m_coroutine.resume( );
+
+        if ( m_coroutine.done( ) )
+        {
+            count_event( event_counter_t::closed_connections );
+        }
+    }
+
+    return m_coroutine.done( ) == false;
+}
+
+[[ nodiscard ]] bool
+Connection::is_closed( ) const noexcept
+{
+    return m_coroutine.done( );
+}
+
+[[ nodiscard ]] uint32_t
+Connection::get_connection_num( ) const noexcept
+{
+    return m_connection_num;
+}
+
+[[ nodiscard ]] const connection_statistics_t&
+Connection::get_statistics( ) const noexcept
+{
+    return m_coroutine.get_state( );
+}
+
+[[ nodiscard ]] size_t
+Connection::get_frame_size( ) noexcept
+{
+    return util::Resumable<connection_statistics_t>::get_frame_size( );
+}
+
+// GCC lowers the body of a coroutine into a switch over its suspension points which
+// has no default case and trips -Wswitch-default.
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wswitch-default"
+#endif
+
+[[ nodiscard ]] util::Resumable<connection_statistics_t>
+Connection::execute( const topology_t& topology, const uint32_t connection_idx, const uint32_t incarnation,
+                     const uint32_t replication )
+{
+    auto& statistics { co_await util::this_coroutine_state<connection_statistics_t> { } };
+
+    const auto connection_num { connection_idx + 1 };
+    const auto& connection { topology.connections[ connection_idx ] };
+    const auto& initiator_process { topology.processes[ connection.initiator_process_idx ] };
+    const auto& responder_process { topology.processes[ connection.responder_process_idx ] };
+    const auto& protocol { topology.protocols[ connection.protocol_idx ] };
+    const auto& initiator_node { topology.nodes[ initiator_process.node_idx ] };
+    const auto& responder_node { topology.nodes[ responder_process.node_idx ] };
+
+    process_context_t initiator { &initiator_process, &initiator_node, &protocol,
+                                  responder_process.port_num, 0, process_role_t::initiator };
+    process_context_t responder { &responder_process, &responder_node, &protocol,
+                                  initiator_process.port_num, 0, process_role_t::responder };
+    auto channel_stream { make_channel_stream( connection_idx, incarnation, replication ) };
+
+    const auto trace_closing { [ connection_num ]( const node_t& node, const process_spec_t& process )
+                               {
+                                   trace( R"(    /|\/|\/|\    closing connection{} by node{}_process{}...    /|\/|\/|\     )""\n\n",
+                                          connection_num, node.node_num, process.process_num );
+                               } };
+
+    std::pair<message_t, bool> delivered_message { message_t { }, true };
+    channel_delivery_t delivery { };
+    auto integrity { segment_integrity_t::intact };
+
+    while ( true )
+    {
+        const auto request { application_process( initiator, delivered_message ) };
+
+        if ( request.destination_port_num == 0 )
+        {
+            trace_closing( initiator_node, initiator_process );
+
+            co_return;
+        }
+
+        ++statistics.message_count;
+        co_await layer_hand_off;
+
+        const auto round_trip_start_time { des::simulation_clock::now( ) };
+        auto segment { transport_to_channel( initiator_node, responder_node, request ) };
+        co_await layer_hand_off;
+
+        delivery = channel( segment, channel_direction_t::forward, channel_stream );
+        ++statistics.segment_count;
+        co_await layer_hand_off;
+
+        // Nothing retransmits a lost segment, so the opening process would wait for the
+        // response forever and gives up on the connection instead.
+        if ( delivery.segment_count == 0 )
+        {
+            ++statistics.loss_count;
+            trace_closing( initiator_node, initiator_process );
+
+            co_return;
+        }
+
+        delivered_message = transport_from_channel( responder_node, initiator_node, delivery.segments[ 0 ],
+                                                    integrity );
+
+        if ( delivery.segment_count == 2 )
+        {
+            ++statistics.duplicate_count;
+            discard_duplicate_segment( responder_node, delivery.segments[ 1 ] );
+        }
+
+        count_delivery( statistics, integrity, segment, delivery.segments[ 0 ] );
+
+        co_await layer_hand_off;
+
+        const auto response { application_process( responder, delivered_message ) };
+
+        if ( response.destination_port_num == 0 )
+        {
+            trace_closing( responder_node, responder_process );
+
+            co_return;
+        }
+
+        ++statistics.message_count;
+        co_await layer_hand_off;
+
+        segment = transport_to_channel( responder_node, initiator_node, response );
+        co_await layer_hand_off;
+
+        delivery = channel( segment, channel_direction_t::backward, channel_stream );
+        ++statistics.segment_count;
+        co_await layer_hand_off;
+
+        if ( delivery.segment_count == 0 )
+        {
+            ++statistics.loss_count;
+            trace_closing( initiator_node, initiator_process );
+
+            co_return;
+        }
+
+        delivered_message = transport_from_channel( initiator_node, responder_node, delivery.segments[ 0 ],
+                                                    integrity );
+
+        if ( delivery.segment_count == 2 )
+        {
+            ++statistics.duplicate_count;
+            discard_duplicate_segment( initiator_node, delivery.segments[ 1 ] );
+        }
+
+        count_delivery( statistics, integrity, segment, delivery.segments[ 0 ] );
+
+        const auto round_trip_latency { des::simulation_clock::now( ) - round_trip_start_time };
+        statistics.round_trip_latency_sum += round_trip_latency;
+        statistics.round_trip_latency_max = std::max( statistics.round_trip_latency_max, round_trip_latency );
+        ++statistics.round_trip_count;
+        co_await layer_hand_off;
+    }
+}
+
+[[ nodiscard ]] util::Resumable<connection_statistics_t>
+Connection::execute_reliable( const topology_t& topology, const uint32_t connection_idx, const uint32_t incarnation,
+                              const uint32_t replication )
+{
+    auto& statistics { co_await util::this_coroutine_state<connection_statistics_t> { } };
+
+    const auto connection_num { connection_idx + 1 };
+    const auto& connection { topology.connections[ connection_idx ] };
+    const auto& initiator_process { topology.processes[ connection.initiator_process_idx ] };
+    const auto& responder_process { topology.processes[ connection.responder_process_idx ] };
+    const auto& protocol { topology.protocols[ connection.protocol_idx ] };
+    const auto& initiator_node { topology.nodes[ initiator_process.node_idx ] };
+    const auto& responder_node { topology.nodes[ responder_process.node_idx ] };
+
+    process_context_t initiator { &initiator_process, &initiator_node, &protocol,
+                                  responder_process.port_num, 0, process_role_t::initiator };
+    process_context_t responder { &responder_process, &responder_node, &protocol,
+                                  initiator_process.port_num, 0, process_role_t::responder };
+    auto channel_stream { make_channel_stream( connection_idx, incarnation, replication ) };
+
+    const auto trace_closing { [ connection_num ]( const node_t& node, const process_spec_t& process )
+                               {
+                                   trace( R"(    /|\/|\/|\    closing connection{} by node{}_process{}...    /|\/|\/|\     )""\n\n",
+                                          connection_num, node.node_num, process.process_num );
+                               } };
+
+    const auto arq_protocol { get_arq_protocol( ) };
+    const auto window_size { get_arq_window_size( ) };
+
+    reliable_endpoint_t initiator_endpoint { &initiator, &initiator_node, &responder_node,
+                                             ArqSender { arq_protocol, window_size },
+                                             ArqReceiver { arq_protocol, window_size } };
+    reliable_endpoint_t responder_endpoint { &responder, &responder_node, &initiator_node,
+                                             ArqSender { arq_protocol, window_size },
+                                             ArqReceiver { arq_protocol, window_size } };
+
+    std::array<segment_t, max_reliable_batch_size> batch;
+    std::array<segment_t, max_arrived_batch_size> arrived_batch;
+    std::array<message_t, sequence_num_modulus> messages;
+    auto batch_size { 0uz };
+    auto arrived_batch_size { 0uz };
+    auto message_count { 0uz };
+
+    // The opening process keeps a window's worth of requests waiting for their responses
+    // and sends a new one for each response that comes in.
+    const std::pair<message_t, bool> opening_message { message_t { }, true };
+    auto awaited_response_count { 0u };
+    auto stalled_round_trip_count { 0u };
+
+    for ( auto round { 0u }; ; ++round )
+    {
+        const auto response_count { std::exchange( message_count, 0uz ) };
+
+        for ( const auto& response : std::span { messages }.first( response_count ) )
+        {
+            const auto request { application_process( initiator, { response, true } ) };
+            --awaited_response_count;
+
+            if ( request.destination_port_num == 0 )
+            {
+                trace_closing( initiator_node, initiator_process );
+
+                co_return;
+            }
+
+            messages[ message_count++ ] = request;
+        }
+
+        while ( awaited_response_count + message_count < window_size )
+        {
+            messages[ message_count++ ] = application_process( initiator, opening_message );
+        }
+
+        awaited_response_count += static_cast<uint32_t>( message_count );
+        statistics.message_count += message_count;
+        co_await layer_hand_off;
+
+        const auto round_trip_start_time { des::simulation_clock::now( ) };
+
+        for ( const auto& request : std::span { messages }.first( std::exchange( message_count, 0uz ) ) )
+        {
+            send_reliable_message( initiator_endpoint, request );
+        }
+
+        batch_size = emit_reliable_segments( initiator_endpoint, round, batch, statistics );
+        co_await layer_hand_off;
+
+        arrived_batch_size = carry_segments( std::span { batch }.first( batch_size ), arrived_batch,
+                                             channel_direction_t::forward, channel_stream, statistics );
+        co_await layer_hand_off;
+
+        message_count = absorb_reliable_segments( responder_endpoint, std::span { batch }.first( batch_size ),
+                                                  std::span { arrived_batch }.first( arrived_batch_size ),
+                                                  messages, statistics );
+        bool is_stalled { message_count == 0 };
+        co_await layer_hand_off;
+
+        for ( auto& message : std::span { messages }.first( message_count ) )
+        {
+            message = application_process( responder, { message, true } );
+
+            if ( message.destination_port_num == 0 )
+            {
+                trace_closing( responder_node, responder_process );
+
+                co_return;
+            }
+        }
+
+        statistics.message_count += message_count;
+        co_await layer_hand_off;
+
+        for ( const auto& response : std::span { messages }.first( std::exchange( message_count, 0uz ) ) )
+        {
+            send_reliable_message( responder_endpoint, response );
+        }
+
+        batch_size = emit_reliable_segments( responder_endpoint, round, batch, statistics );
+        co_await layer_hand_off;
+
+        arrived_batch_size = carry_segments( std::span { batch }.first( batch_size ), arrived_batch,
+                                             channel_direction_t::backward, channel_stream, statistics );
+        co_await layer_hand_off;
+
+        message_count = absorb_reliable_segments( initiator_endpoint, std::span { batch }.first( batch_size ),
+                                                  std::span { arrived_batch }.first( arrived_batch_size ),
+                                                  messages, statistics );
+        is_stalled = is_stalled && message_count == 0;
+
+        const auto round_trip_latency { des::simulation_clock::now( ) - round_trip_start_time };
+        statistics.round_trip_latency_sum += round_trip_latency;
+        statistics.round_trip_latency_max = std::max( statistics.round_trip_latency_max, round_trip_latency );
+        ++statistics.round_trip_count;
+
+        stalled_round_trip_count = is_stalled ? stalled_round_trip_count + 1 : 0;
+
+        if ( stalled_round_trip_count == max_stalled_round_trip_count )
+        {
+            trace_closing( initiator_node, initiator_process );
+
+            co_return;
+        }
+
+        co_await layer_hand_off;
+    }
+}
+
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic pop
+#endif
+
+[[ nodiscard ]] size_t
+get_memory_per_connection( const topology_t& topology ) noexcept
+{
+    const auto connection_count { std::max( std::size( topology.connections ), 1uz ) };
+
+    return sizeof( Connection ) + Connection::get_frame_size( ) + get_memory_footprint( topology ) / connection_count;
+}
+
+[[ nodiscard ]] connection_statistics_t
+execute_connection( const topology_t& topology, const uint32_t connection_idx )
+{
+    Connection connection { topology, connection_idx };
+
+    while ( connection.step( ) ) { }
+
+    return connection.get_statistics( );
+}
+
+[[ nodiscard ]] benchmark_report_t
+execute_benchmark( const topology_t& topology )
+{
+    using std::chrono::steady_clock;
+
+    const bool is_time_budget_set { benchmark_time_budget != std::chrono::seconds { 0 } };
+
+    const auto start_time { steady_clock::now( ) };
+    const BinaryTraceScope binary_trace_scope { };
+
+    pooled_execution_t execution { };
+    execution.topology = &topology;
+    execution.round_trips_budget = get_benchmark_round_trips_budget( );
+    execution.deadline = start_time + benchmark_time_budget;
+    execution.round_trips_per_task = benchmark_round_trips_per_task;
+    execution.is_time_budget_set = is_time_budget_set;
+    execution.is_reopening_enabled = true;
+
+    execute_on_thread_pool( execution );
+
+    benchmark_report_t report { };
+    report.elapsed_time = steady_clock::now( ) - start_time;
+    report.memory_per_connection = get_memory_per_connection( topology );
+    report.segment_check_name = segment_check_t::name;
+    report.segment_check_time = measure_segment_check_time( );
+    report.arq_protocol = get_arq_protocol( );
+    report.arq_window_size = get_arq_window_size( );
+    report.random_seed = get_random_seed( );
+
+    for ( const auto& pooled_connection : execution.connections )
     {
-        node1_process1_application_layer_delay = node1_process1_application_layer_default_delay;
-        node1_process2_application_layer_delay = node1_process2_application_layer_default_delay;
-        node2_process1_application_layer_delay = node2_process1_application_layer_default_delay;
-        node2_process2_application_layer_delay = node2_process2_application_layer_default_delay;
-        node1_transport_to_layer_delay         = node1_transport_to_layer_default_delay;
-        node1_transport_from_layer_delay       = node1_transport_from_layer_default_delay;
-        node2_transport_to_layer_delay         = node2_transport_to_layer_default_delay;
-        node2_transport_from_layer_delay       = node2_transport_from_layer_default_delay;
-        channel_delay                          = channel_default_delay;
+        report.statistics += pooled_connection.closed_connections_statistics;
     }
-    else
+
+    return report;
+}
+
+[[ nodiscard ]] benchmark_report_t
+execute_pipelined_benchmark( const topology_t& topology )
+{
+    using std::chrono::steady_clock;
+
+    const bool is_time_budget_set { benchmark_time_budget != std::chrono::seconds { 0 } };
+
+    const auto start_time { steady_clock::now( ) };
+    const BinaryTraceScope binary_trace_scope { };
+
+    // The rings take up too much memory for the stack.
+    const auto execution { std::make_unique<pipelined_execution_t>( ) };
+    execution->topology = &topology;
+    execution->round_trips_budget = get_benchmark_round_trips_budget( );
+    execution->deadline = start_time + benchmark_time_budget;
+    execution->is_time_budget_set = is_time_budget_set;
+
+    {
+        // Indexed by pipeline_stage_t.
+        std::array stage_threads { std::jthread { run_application_stage, std::ref( *execution ) },
+                                   std::jthread { run_transport_to_channel_stage, std::ref( *execution ) },
+                                   std::jthread { run_channel_stage, std::ref( *execution ) },
+                                   std::jthread { run_transport_from_channel_stage, std::ref( *execution ) } };
+
+        static_assert( std::size( stage_threads ) == pipeline_stage_count );
+
+        for ( auto stage_idx { 0uz }; auto& stage_thread : stage_threads )
+        {
+            pin_pipeline_stage( stage_thread, stage_idx++ );
+        }
+    }
+
+    benchmark_report_t report { };
+    report.elapsed_time = steady_clock::now( ) - start_time;
+
+    // The pipeline keeps the processes of a connection and a counter in place of its
+    // coroutine frame.
+    const auto connection_count { std::max( std::size( topology.connections ), 1uz ) };
+    report.memory_per_connection = sizeof( pipelined_connection_t ) + sizeof( channel_stream_t ) +
+                                   get_memory_footprint( topology ) / connection_count;
+    report.segment_check_name = segment_check_t::name;
+    report.segment_check_time = measure_segment_check_time( );
+    report.arq_protocol = get_arq_protocol( );
+    report.arq_window_size = get_arq_window_size( );
+    report.random_seed = get_random_seed( );
+
+    for ( const auto& statistics : execution->stage_statistics )
+    {
+        report.statistics += statistics;
+    }
+
+    return report;
+}
+
+[[ nodiscard ]] benchmark_report_t
+execute_multiprocess_benchmark( const topology_t& topology )
+{
+    using std::chrono::steady_clock;
+
+    // The claims of the threads on the regions of the trace file are kept by the writer
+    // in the memory of the process that opened it.
+    if ( std::empty( binary_trace_path ) == false )
+    {
+        throw std::system_error { std::make_error_code( std::errc::invalid_argument ),
+                                  "A binary trace cannot be recorded by the nodes of several processes" };
+    }
+
+    if ( std::ranges::any_of( topology.connections,
+                              [ &topology ]( const connection_spec_t& connection ) noexcept
+                              {
+                                  return get_node_side( topology, connection.initiator_process_idx ) ==
+                                         get_node_side( topology, connection.responder_process_idx );
+                              } ) )
+    {
+        throw std::system_error { std::make_error_code( std::errc::invalid_argument ),
+                                  "A connection joins two nodes that would run in the same process" };
+    }
+
+#if PLATFORM_NAME != OS_WINDOWS
+    const bool is_time_budget_set { benchmark_time_budget != std::chrono::seconds { 0 } };
+    const auto connection_count { static_cast<uint32_t>( std::size( topology.connections ) ) };
+    const auto process_count { std::size( topology.processes ) };
+
+    static_assert( sizeof( node_link_t ) % alignof( shared_channel_stream_t ) == 0 &&
+                   sizeof( shared_channel_stream_t ) % alignof( process_message_counts_t ) == 0 );
+
+    const util::SharedMemorySegment segment { fmt::format( "sns-channel-{}", ::getpid( ) ),
+                                              sizeof( node_link_t ) + connection_count * sizeof( shared_channel_stream_t ) +
+                                              process_count * sizeof( process_message_counts_t ) };
+
+    auto* const link { ::new ( segment.get_data( ) ) node_link_t { } };
+    auto* const streams { reinterpret_cast<shared_channel_stream_t*>( segment.get_data( ) + sizeof( node_link_t ) ) };
+    auto* const forked_side_process_counts { reinterpret_cast<process_message_counts_t*>( streams + connection_count ) };
+
+    for ( auto connection_idx { 0u }; connection_idx < connection_count; ++connection_idx )
+    {
+        ::new ( streams + connection_idx ) shared_channel_stream_t { make_channel_stream( connection_idx, 0 ), 0 };
+    }
+
+    std::uninitialized_value_construct_n( forked_side_process_counts, process_count );
+
+    const auto start_time { steady_clock::now( ) };
+
+    node_side_execution_t execution { &topology, link, std::span { streams, connection_count }, 0,
+                                      static_cast<int>( ::getpid( ) ),
+                                      get_benchmark_round_trips_budget( ), start_time + benchmark_time_budget,
+                                      is_time_budget_set };
+
+    const auto forked_process_id { ::fork( ) };
+
+    if ( forked_process_id == -1 )
+    {
+        throw std::system_error { errno, std::generic_category( ), "Failure in forking the process of the nodes" };
+    }
+
+    if ( forked_process_id == 0 )
+    {
+        execution.side = 1;
+        run_forked_node_side( execution, std::span { forked_side_process_counts, process_count } );
+    }
+
+    execution.peer_process_id = static_cast<int>( forked_process_id );
+
+    connection_statistics_t statistics { };
+
+    try
+    {
+        pin_node_side( execution.side );
+        statistics = run_node_side( execution );
+    }
+    catch ( ... )
+    {
+        ::kill( forked_process_id, SIGKILL );
+        ::waitpid( forked_process_id, nullptr, 0 );
+
+        throw;
+    }
+
+    if ( int status { }; ::waitpid( forked_process_id, &status, 0 ) == -1 || WIFEXITED( status ) == false ||
+                         WEXITSTATUS( status ) != EXIT_SUCCESS )
+    {
+        throw std::runtime_error { "the process of the even-numbered nodes failed" };
+    }
+
+    benchmark_report_t report { };
+    report.elapsed_time = steady_clock::now( ) - start_time;
+
+    // Each side keeps the processes of every connection and a counter in place of its
+    // coroutine frame, and both of them share its channel stream.
+    report.memory_per_connection = node_side_count * sizeof( pipelined_connection_t ) + sizeof( shared_channel_stream_t ) +
+                                   get_memory_footprint( topology ) / std::max( size_t { connection_count }, 1uz );
+    report.segment_check_name = segment_check_t::name;
+    report.segment_check_time = measure_segment_check_time( );
+    report.arq_protocol = get_arq_protocol( );
+    report.arq_window_size = get_arq_window_size( );
+    report.random_seed = get_random_seed( );
+    report.statistics = statistics;
+    report.statistics += link->forked_side_statistics;
+
+    add_event_counts( link->forked_side_event_counts );
+    add_process_message_counts( std::span { forked_side_process_counts, process_count } );
+
+    return report;
+#else
+    throw std::system_error { std::make_error_code( std::errc::not_supported ),
+                              "Running the nodes in processes of their own is not supported" };
+#endif
+}
+
+[[ nodiscard ]] open_loop_report_t
+execute_open_loop_benchmark( const topology_t& topology )
+{
+    using std::chrono::steady_clock;
+
+    const auto& traffic_model { get_traffic_model( ) };
+    const auto connection_count { static_cast<uint32_t>( std::size( topology.connections ) ) };
+    const auto worker_count { std::clamp( get_thread_count( ), 1uz, std::max( size_t { connection_count }, 1uz ) ) };
+
+    open_loop_execution_t execution { };
+    execution.topology = &topology;
+    execution.connections.reserve( connection_count );
+    execution.workers.resize( worker_count );
+    execution.requests_budget = benchmark_round_trips_budget;
+
+    for ( auto connection_idx { 0u }; connection_idx < connection_count; ++connection_idx )
+    {
+        execution.connections.push_back( open_loop_connection_t { Connection { topology, connection_idx },
+                                                                  TrafficSource { traffic_model, connection_idx },
+                                                                  { }, 0 } );
+    }
+
+    const BinaryTraceScope binary_trace_scope { };
+
+    execution.start_time = steady_clock::now( );
+    execution.deadline = execution.start_time + ( benchmark_time_budget != std::chrono::seconds { 0 }
+                                                  ? benchmark_time_budget : open_loop_default_duration );
+
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve( worker_count );
+
+        for ( auto worker_idx { 0uz }; worker_idx < worker_count; ++worker_idx )
+        {
+            workers.emplace_back( run_open_loop_worker, std::ref( execution ), worker_idx, worker_count );
+        }
+    }
+
+    open_loop_report_t report { };
+    report.benchmark.elapsed_time = steady_clock::now( ) - execution.start_time;
+    report.benchmark.memory_per_connection = get_memory_per_connection( topology ) + sizeof( open_loop_connection_t ) -
+                                             sizeof( Connection );
+    report.benchmark.segment_check_name = segment_check_t::name;
+    report.benchmark.segment_check_time = measure_segment_check_time( );
+    report.benchmark.arq_protocol = get_arq_protocol( );
+    report.benchmark.arq_window_size = get_arq_window_size( );
+    report.benchmark.random_seed = get_random_seed( );
+    report.traffic_model = traffic_model;
+    report.connection_count = connection_count;
+
+    for ( const auto& open_loop_connection : execution.connections )
+    {
+        report.benchmark.statistics += open_loop_connection.closed_connections_statistics;
+
+        if ( open_loop_connection.connection.is_closed( ) == false )
+        {
+            report.benchmark.statistics += open_loop_connection.connection.get_statistics( );
+            ++report.benchmark.statistics.connection_count;
+        }
+
+        report.answered_request_count += open_loop_connection.answered_request_count;
+    }
+
+    util::LatencyHistogram latencies_from_schedule { };
+    util::LatencyHistogram latencies_from_send { };
+
+    for ( const auto& worker : execution.workers )
+    {
+        latencies_from_schedule.merge( worker.latencies_from_schedule );
+        latencies_from_send.merge( worker.latencies_from_send );
+        report.scheduled_request_count += worker.unanswered_request_count;
+    }
+
+    report.scheduled_request_count += report.answered_request_count;
+    report.latencies_from_schedule = get_open_loop_latencies( latencies_from_schedule );
+    report.latencies_from_send = get_open_loop_latencies( latencies_from_send );
+
+    return report;
+}
+
+[[ nodiscard ]] simulation_report_t
+execute_discrete_event_simulation( const topology_t& topology )
+{
+    const auto start_time { std::chrono::steady_clock::now( ) };
+    const BinaryTraceScope binary_trace_scope { };
+
+    des::simulation_clock::reset( );
+
+    const auto connection_count { static_cast<uint32_t>( std::size( topology.connections ) ) };
+
+    std::vector<Connection> connections { };
+    connections.reserve( connection_count );
+
+    for ( auto connection_idx { 0u }; connection_idx < connection_count; ++connection_idx )
     {
-        using std::chrono_literals::operator""ms;
+        connections.emplace_back( topology, connection_idx );
+    }
+
+    des::EventScheduler scheduler { };
+
+    for ( auto& connection : connections )
+    {
+        schedule_connection_step( scheduler, connection );
+    }
+
+    simulation_report_t report { };
+    report.event_count = scheduler.run( );
+    report.simulated_time = des::simulation_clock::now( ).time_since_epoch( );
+    report.elapsed_time = std::chrono::steady_clock::now( ) - start_time;
+    report.memory_per_connection = get_memory_per_connection( topology );
+    report.random_seed = get_random_seed( );
+    report.connections.reserve( connection_count );
 
-        node1_process1_application_layer_delay = 0ms;
-        node1_process2_application_layer_delay = 0ms;
-        node2_process1_application_layer_delay = 0ms;
-        node2_process2_application_layer_delay = 0ms;
-        node1_transport_to_layer_delay         = 0ms;
-        node1_transport_from_layer_delay       = 0ms;
-        node2_transport_to_layer_delay         = 0ms;
-        node2_transport_from_layer_delay       = 0ms;
-        channel_delay                          = 0ms;
+    for ( const auto& connection : connections )
+    {
+        report.connections.push_back( connection.get_statistics( ) );
     }
+
+    return report;
+}
+
+void
+execute_real_time_simulation( const topology_t& topology )
+{
+    const BinaryTraceScope binary_trace_scope { };
+
+    pooled_execution_t execution { };
+    execution.topology = &topology;
+    execution.round_trips_per_task = 1;
+    execution.is_reopening_enabled = false;
+
+    execute_on_thread_pool( execution );
+}
+
+void
+set_layers_delays( const bool layers_delays_status ) noexcept
+{
+    are_layers_delays_enabled = layers_delays_status;
 }
 
 void
@@ -755,4 +2663,76 @@ set_channel_faults( const bool channel_faults_status ) noexcept
     }
 }
 
+void
+set_virtual_time( const bool virtual_time_status ) noexcept
+{
+    is_virtual_time_enabled = virtual_time_status;
+}
+
+void
+set_tracing( const bool tracing_status ) noexcept
+{
+    is_tracing_enabled = tracing_status;
+}
+
+void
+set_execution_mode( const execution_mode_t mode ) noexcept
+{
+    current_execution_mode = mode;
+}
+
+[[ nodiscard ]] execution_mode_t
+get_execution_mode( ) noexcept
+{
+    return current_execution_mode;
+}
+
+[[ nodiscard ]] bool
+is_running_in_virtual_time( ) noexcept
+{
+    return is_virtual_time_enabled;
+}
+
+void
+set_benchmark_round_trips_budget( const uint64_t round_trips_budget ) noexcept
+{
+    benchmark_round_trips_budget = round_trips_budget;
+}
+
+void
+set_benchmark_time_budget( const std::chrono::seconds time_budget ) noexcept
+{
+    benchmark_time_budget = time_budget;
+}
+
+void
+set_thread_count( const size_t thread_count ) noexcept
+{
+    configured_thread_count = thread_count;
+}
+
+[[ nodiscard ]] size_t
+get_thread_count( ) noexcept
+{
+    return configured_thread_count != 0 ? configured_thread_count : size_t { std::thread::hardware_concurrency( ) };
+}
+
+void
+set_node_cpus( const std::array<uint32_t, node_side_count>& cpus ) noexcept
+{
+    node_cpus = cpus;
+}
+
+void
+set_binary_trace_path( const std::string_view path )
+{
+    binary_trace_path = path;
+}
+
+void
+set_binary_trace_size( const size_t size ) noexcept
+{
+    binary_trace_size = size;
+}
+
 }
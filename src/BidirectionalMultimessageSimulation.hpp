@@ -2,24 +2,177 @@
 #pragma once
 
 #include <bitset>
+#include <bit>
+#include <type_traits>
 #include <utility>
+#include <chrono>
+#include <vector>
+#include <span>
+#include <array>
+#include <string_view>
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include "Coroutine.hpp"
+#include "Crc.hpp"
+#include "EventScheduler.hpp"
+#include "Hamming.hpp"
+#include "Topology.hpp"
+#include "TrafficSource.hpp"
 
 
+#ifndef SNS_PORT_NUM_BIT_COUNT
+#   define SNS_PORT_NUM_BIT_COUNT 1
+#endif
+
+// The width of the sequence number carried by a segment for the reliable transport,
+// which bounds the number of segments it keeps in flight.
+#ifndef SNS_SEQUENCE_NUM_BIT_COUNT
+#   define SNS_SEQUENCE_NUM_BIT_COUNT 3
+#endif
+
+// The width of the CRC that protects a segment, or 0 for a single even parity bit.
+#ifndef SNS_CRC_BIT_COUNT
+#   define SNS_CRC_BIT_COUNT 0
+#endif
+
+// Building with -DSNS_SECDED=1 protects a segment with an extended Hamming code instead,
+// which corrects a single flipped bit rather than only detecting it.
+#ifndef SNS_SECDED
+#   define SNS_SECDED 0
+#endif
+
+static_assert( SNS_SECDED == 0 || SNS_CRC_BIT_COUNT == 0, "a segment is protected by either a CRC or a SECDED code" );
+
 namespace simple_network_simulation
 {
 
-inline constexpr auto parity_bit_count               { 1uz };
-inline constexpr auto source_port_num_bit_count      { 1uz };
-inline constexpr auto destination_port_num_bit_count { 1uz };
+inline constexpr auto source_port_num_bit_count      { std::size_t { SNS_PORT_NUM_BIT_COUNT } };
+inline constexpr auto destination_port_num_bit_count { std::size_t { SNS_PORT_NUM_BIT_COUNT } };
 inline constexpr auto payload_bit_count              { 8uz };
-inline constexpr auto segment_bit_count              { parity_bit_count + source_port_num_bit_count +
-                                                       destination_port_num_bit_count + payload_bit_count };
+inline constexpr auto sequence_num_bit_count         { std::size_t { SNS_SEQUENCE_NUM_BIT_COUNT } };
+inline constexpr auto acknowledgement_flag_bit_count { 1uz };
+inline constexpr auto data_bit_count                 { source_port_num_bit_count + destination_port_num_bit_count +
+                                                       payload_bit_count + sequence_num_bit_count +
+                                                       acknowledgement_flag_bit_count };
+
+// The check bits of a segment are computed over its payload and port fields, packed
+// into a word with the payload in the lowest bits.
+struct even_parity_check_t
+{
+    static constexpr auto bit_count { 1uz };
+    static constexpr auto is_correcting { false };
+    static constexpr std::string_view name { "parity" };
+
+    [[ nodiscard ]] static constexpr std::uint32_t
+    compute( const std::uint32_t data_bits ) noexcept
+    {
+        return static_cast<std::uint32_t>( std::popcount( data_bits ) ) & 1u;
+    }
+};
 
+template <std::size_t Width>
+struct crc_check_t
+{
+    static constexpr auto bit_count { Width };
+    static constexpr auto is_correcting { false };
+    static constexpr auto name { util::Crc<Width>::name };
+
+    [[ nodiscard ]] static constexpr std::uint32_t
+    compute( const std::uint32_t data_bits ) noexcept
+    {
+        return util::Crc<Width>::compute( data_bits, ( data_bit_count + 7 ) / 8 );
+    }
+};
+
+struct secded_check_t
+{
+    using code = util::ExtendedHammingCode<data_bit_count>;
+
+    static constexpr auto bit_count { code::check_bit_count };
+    static constexpr auto is_correcting { true };
+    static constexpr auto name { code::name };
+
+    [[ nodiscard ]] static constexpr std::uint32_t
+    compute( const std::uint32_t data_bits ) noexcept
+    {
+        return code::compute( data_bits );
+    }
+
+    // The check bits follow the data bits, so a segment is a codeword as it stands.
+    [[ nodiscard ]] static constexpr util::hamming_correction_t
+    correct( const std::uint64_t segment_bits ) noexcept
+    {
+        return code::correct( segment_bits );
+    }
+};
+
+// The segment layout is parameterized on its check.
+using segment_check_t = std::conditional_t< SNS_SECDED != 0, secded_check_t,
+                                            std::conditional_t< SNS_CRC_BIT_COUNT == 0, even_parity_check_t,
+                                                                crc_check_t< SNS_CRC_BIT_COUNT > > >;
+
+inline constexpr auto check_bit_count   { segment_check_t::bit_count };
+inline constexpr auto segment_bit_count { check_bit_count + data_bit_count };
+
+inline constexpr auto payload_bit_offset              { 0uz };
+inline constexpr auto destination_port_num_bit_offset { payload_bit_offset + payload_bit_count };
+inline constexpr auto source_port_num_bit_offset      { destination_port_num_bit_offset +
+                                                        destination_port_num_bit_count };
+inline constexpr auto sequence_num_bit_offset         { source_port_num_bit_offset + source_port_num_bit_count };
+inline constexpr auto acknowledgement_flag_bit_offset { sequence_num_bit_offset + sequence_num_bit_count };
+inline constexpr auto check_bit_offset                { acknowledgement_flag_bit_offset +
+                                                        acknowledgement_flag_bit_count };
+
+// The port fields of a segment carry the index of a port within its node.
+inline constexpr std::uint32_t max_processes_per_node { 1u << source_port_num_bit_count };
+
+// The sequence numbers wrap around after this many segments.
+inline constexpr std::uint32_t sequence_num_modulus { 1u << sequence_num_bit_count };
+
+static_assert( sequence_num_bit_count >= 1 && sequence_num_bit_count <= 5,
+               "the reliable transport buffers a segment per sequence number" );
+static_assert( data_bit_count <= 32, "the port fields are too wide for a packed segment" );
+static_assert( segment_bit_count <= 64, "the check is too wide for a packed segment" );
+
+// The smallest unsigned integer that holds a whole segment, i.e. 16 bits unless the
+// port or sequence number fields are widened or a wide check protects the segment.
+using segment_word_t = std::conditional_t< segment_bit_count <= 16, std::uint16_t,
+                                           std::conditional_t< segment_bit_count <= 32, std::uint32_t,
+                                                               std::uint64_t > >;
+
+[[ nodiscard ]] consteval segment_word_t
+make_segment_field_mask( const std::size_t bit_offset, const std::size_t bit_count ) noexcept
+{
+    return static_cast<segment_word_t>( ( ( std::uint64_t { 1 } << bit_count ) - 1 ) << bit_offset );
+}
+
+inline constexpr auto payload_bit_mask              { make_segment_field_mask( payload_bit_offset,
+                                                                               payload_bit_count ) };
+inline constexpr auto destination_port_num_bit_mask { make_segment_field_mask( destination_port_num_bit_offset,
+                                                                               destination_port_num_bit_count ) };
+inline constexpr auto source_port_num_bit_mask      { make_segment_field_mask( source_port_num_bit_offset,
+                                                                               source_port_num_bit_count ) };
+inline constexpr auto sequence_num_bit_mask         { make_segment_field_mask( sequence_num_bit_offset,
+                                                                               sequence_num_bit_count ) };
+inline constexpr auto acknowledgement_flag_bit_mask { make_segment_field_mask( acknowledgement_flag_bit_offset,
+                                                                               acknowledgement_flag_bit_count ) };
+inline constexpr auto check_bit_mask                { make_segment_field_mask( check_bit_offset,
+                                                                               check_bit_count ) };
+inline constexpr auto data_bit_mask                 { make_segment_field_mask( payload_bit_offset,
+                                                                               data_bit_count ) };
+
+// The payload and the segment are plain integers; the bitsets are only views of them
+// for the sake of tracing.
 struct [[ nodiscard ]] payload_t
 {
-    std::bitset< payload_bit_count > data;
+    std::uint8_t bits;
+
+    [[ nodiscard ]] constexpr std::bitset< payload_bit_count >
+    to_bitset( ) const noexcept
+    {
+        return bits;
+    }
 };
 
 struct [[ nodiscard ]] message_t
@@ -31,46 +184,412 @@ struct [[ nodiscard ]] message_t
 
 struct [[ nodiscard ]] segment_t
 {
-    std::bitset< segment_bit_count > data;
+    segment_word_t bits;
+
+    [[ nodiscard ]] constexpr std::bitset< segment_bit_count >
+    to_bitset( ) const noexcept
+    {
+        return bits;
+    }
 };
 
-[[ nodiscard ]] message_t
-node1_process1( const std::uint32_t process_num,
-                const std::pair<message_t, bool>& incoming_message );
+// The fields of the reliable transport, left zeroed otherwise: a data segment carries
+// its own sequence number and an acknowledgement that of the segment it acknowledges
+// ( or, for the cumulative acknowledgements, that of the next segment expected ).
+struct [[ nodiscard ]] segment_header_t
+{
+    std::uint32_t sequence_num;
+    bool is_acknowledgement;
+};
 
-[[ nodiscard ]] message_t
-node1_process2( const std::uint32_t process_num,
-                const std::pair<message_t, bool>& incoming_message );
+struct [[ nodiscard ]] decoded_segment_t
+{
+    payload_t payload;
+    std::uint32_t source_port_idx;
+    std::uint32_t destination_port_idx;
+    segment_header_t header;
+    bool is_intact;
+    bool is_corrected;
+};
 
-[[ nodiscard ]] message_t
-node2_process1( const std::uint32_t process_num,
-                const std::pair<message_t, bool>& incoming_message );
+// Computes the check bits of the payload and port fields of a segment, in place.
+[[ nodiscard ]] constexpr segment_word_t
+compute_segment_check_bits( const segment_word_t bits ) noexcept
+{
+    const auto data_bits { static_cast<std::uint32_t>( bits & data_bit_mask ) };
+
+    const auto check_bits { static_cast<segment_word_t>( segment_check_t::compute( data_bits ) ) };
+
+    return static_cast<segment_word_t>( check_bits << check_bit_offset );
+}
+
+// Packs the fields of a segment, leaving its check bits clear. The port indices and the
+// sequence number are truncated to the width of their fields.
+[[ nodiscard ]] constexpr segment_word_t
+pack_segment_fields( const payload_t payload, const std::uint32_t source_port_idx,
+                     const std::uint32_t destination_port_idx, const segment_header_t header = { } ) noexcept
+{
+    return static_cast<segment_word_t>( static_cast<std::uint32_t>( payload.bits << payload_bit_offset ) |
+                                        ( ( destination_port_idx << destination_port_num_bit_offset ) &
+                                          destination_port_num_bit_mask ) |
+                                        ( ( source_port_idx << source_port_num_bit_offset ) &
+                                          source_port_num_bit_mask ) |
+                                        ( ( header.sequence_num << sequence_num_bit_offset ) &
+                                          sequence_num_bit_mask ) |
+                                        ( static_cast<std::uint32_t>( header.is_acknowledgement ) <<
+                                          acknowledgement_flag_bit_offset ) );
+}
+
+// Packs the fields of a segment and sets its check bits.
+[[ nodiscard ]] constexpr segment_t
+encode_segment( const payload_t payload, const std::uint32_t source_port_idx,
+                const std::uint32_t destination_port_idx, const segment_header_t header = { } ) noexcept
+{
+    const auto data_bits { pack_segment_fields( payload, source_port_idx, destination_port_idx, header ) };
+
+    return segment_t { static_cast<segment_word_t>( data_bits | compute_segment_check_bits( data_bits ) ) };
+}
+
+// Checks a segment, repairing it first if its check is able to, and unpacks its fields.
+// Only a template so that the repair is discarded for the checks that cannot make one.
+template <typename SegmentCheck = segment_check_t>
+[[ nodiscard ]] constexpr decoded_segment_t
+decode_segment( const segment_t segment ) noexcept
+{
+    auto bits { segment.bits };
+    bool is_intact { };
+    bool is_corrected { };
+
+    if constexpr ( SegmentCheck::is_correcting )
+    {
+        const auto correction { SegmentCheck::correct( bits ) };
+        bits = static_cast<segment_word_t>( bits ^ correction.error_mask );
+        is_intact = correction.is_correctable;
+        is_corrected = correction.error_mask != 0;
+    }
+    else
+    {
+        is_intact = ( bits & check_bit_mask ) == compute_segment_check_bits( bits );
+    }
+
+    return decoded_segment_t { payload_t { static_cast<std::uint8_t>( ( bits & payload_bit_mask ) >>
+                                                                      payload_bit_offset ) },
+                               static_cast<std::uint32_t>( ( bits & source_port_num_bit_mask ) >>
+                                                           source_port_num_bit_offset ),
+                               static_cast<std::uint32_t>( ( bits & destination_port_num_bit_mask ) >>
+                                                           destination_port_num_bit_offset ),
+                               segment_header_t { static_cast<std::uint32_t>( ( bits & sequence_num_bit_mask ) >>
+                                                                              sequence_num_bit_offset ),
+                                                  ( bits & acknowledgement_flag_bit_mask ) != 0 },
+                               is_intact,
+                               is_corrected };
+}
+
+enum class channel_direction_t : std::uint8_t
+{
+    forward,    // from the process that opens a connection to the one that accepts it
+    backward
+};
+
+// What comes out of the channel for a segment that goes in: nothing if it was lost, two
+// copies if it was duplicated and the (possibly corrupted) segment itself otherwise.
+struct [[ nodiscard ]] channel_delivery_t
+{
+    std::array<segment_t, 2> segments;
+    std::uint8_t segment_count;
+};
+
+enum class execution_mode_t : std::uint8_t
+{
+    interactive,
+    benchmark,
+    pipelined_benchmark,
+    open_loop_benchmark,
+    multiprocess_benchmark,
+    sweep
+};
+
+// How a connection copes with the faults of the channel: not at all, which leaves one
+// message in flight per direction and closes the connection on any loss or corruption,
+// or by retransmitting what went missing under one of the ARQ schemes.
+enum class arq_protocol_t : std::uint8_t
+{
+    none,
+    stop_and_wait,
+    go_back_n,
+    selective_repeat
+};
+
+struct [[ nodiscard ]] connection_statistics_t
+{
+    std::uint64_t connection_count;
+    std::uint64_t round_trip_count;
+    std::uint64_t message_count;
+    std::uint64_t segment_count;
+    std::uint64_t delivered_message_count;
+    std::uint64_t corruption_count;
+    std::uint64_t undetected_corruption_count;
+    std::uint64_t correction_count;
+    std::uint64_t loss_count;
+    std::uint64_t duplicate_count;
+    std::uint64_t retransmission_count;
+    des::simulation_clock::duration round_trip_latency_sum;
+    des::simulation_clock::duration round_trip_latency_max;
+
+    connection_statistics_t&
+    operator+=( const connection_statistics_t& rhs ) noexcept
+    {
+        connection_count            += rhs.connection_count;
+        round_trip_count            += rhs.round_trip_count;
+        message_count               += rhs.message_count;
+        segment_count               += rhs.segment_count;
+        delivered_message_count     += rhs.delivered_message_count;
+        corruption_count            += rhs.corruption_count;
+        undetected_corruption_count += rhs.undetected_corruption_count;
+        correction_count            += rhs.correction_count;
+        loss_count                  += rhs.loss_count;
+        duplicate_count             += rhs.duplicate_count;
+        retransmission_count        += rhs.retransmission_count;
+        round_trip_latency_sum      += rhs.round_trip_latency_sum;
+        round_trip_latency_max       = std::max( round_trip_latency_max, rhs.round_trip_latency_max );
+
+        return *this;
+    }
+};
+
+struct [[ nodiscard ]] benchmark_report_t
+{
+    connection_statistics_t statistics;
+    std::size_t memory_per_connection;
+    std::string_view segment_check_name;
+    std::chrono::duration<double, std::nano> segment_check_time;
+    arq_protocol_t arq_protocol;
+    std::uint32_t arq_window_size;
+    std::uint64_t random_seed;
+    std::chrono::nanoseconds elapsed_time;
+};
+
+// The latency percentiles of the requests of the open-loop benchmark, from a point in time
+// up to the arrival of their response.
+struct [[ nodiscard ]] open_loop_latencies_t
+{
+    std::chrono::nanoseconds p50;
+    std::chrono::nanoseconds p90;
+    std::chrono::nanoseconds p99;
+    std::chrono::nanoseconds p999;
+    std::chrono::nanoseconds max;
+};
+
+// The latencies are measured both from the time at which each request was scheduled to go
+// out and from the time at which it actually went out. The latter is what a closed-loop
+// benchmark measures and leaves out the time that requests spend queued up behind a
+// slow response (the coordinated omission), whereas the former includes it.
+struct [[ nodiscard ]] open_loop_report_t
+{
+    benchmark_report_t benchmark;
+    traffic_model_t traffic_model;
+    std::uint32_t connection_count;
+    std::uint64_t scheduled_request_count;  // the requests due before the end of the run
+    std::uint64_t answered_request_count;
+    open_loop_latencies_t latencies_from_schedule;
+    open_loop_latencies_t latencies_from_send;
+};
+
+struct [[ nodiscard ]] simulation_report_t
+{
+    std::vector<connection_statistics_t> connections;
+    std::size_t memory_per_connection;
+    std::size_t event_count;
+    std::uint64_t random_seed;
+    des::simulation_clock::duration simulated_time;
+    std::chrono::nanoseconds elapsed_time;
+};
+
+enum class process_role_t : std::uint8_t
+{
+    initiator,
+    responder
+};
+
+// The state of a process within the connection it takes part in.
+struct [[ nodiscard ]] process_context_t
+{
+    const process_spec_t* process;
+    const node_t* node;
+    const application_protocol_t* protocol;
+    std::uint32_t peer_port_num;
+    std::uint32_t request_counter;
+    process_role_t role;
+};
 
 [[ nodiscard ]] message_t
-node2_process2( const std::uint32_t process_num,
-                const std::pair<message_t, bool>& incoming_message );
+application_process( process_context_t& context,
+                     const std::pair<message_t, bool>& incoming_message );
 
-[[ nodiscard ]] segment_t
-channel( segment_t segment );
+struct channel_stream_t;
 
-[[ nodiscard ]] segment_t
-node1_transport_to_channel( const message_t message );
+// Carries a segment across the channel, drawing its faults from the stream of the
+// connection it belongs to.
+[[ nodiscard ]] channel_delivery_t
+channel( const segment_t segment, const channel_direction_t direction, channel_stream_t& stream );
 
-[[ nodiscard ]] std::pair<message_t, bool>
-node1_transport_from_channel( const segment_t segment );
+// Carries a batch of segments across the channel at once: the faults are injected into
+// the whole batch in bulk and the delay of the channel elapses once for all of them.
+// delivered_OUT must hold twice as many segments as go in, for the case where every one
+// of them gets duplicated; returns the number of segments delivered.
+[[ nodiscard ]] std::size_t
+channel( const std::span<const segment_t> segments, const std::span<segment_t> delivered_OUT,
+         const channel_direction_t direction, channel_stream_t& stream );
 
 [[ nodiscard ]] segment_t
-node2_transport_to_channel( const message_t message );
+transport_to_channel( const node_t& node, const node_t& peer_node, const message_t message,
+                      const segment_header_t header = { } );
+
+enum class segment_integrity_t : std::uint8_t
+{
+    intact,
+    corrected,
+    corrupt
+};
 
 [[ nodiscard ]] std::pair<message_t, bool>
-node2_transport_from_channel( const segment_t segment );
+transport_from_channel( const node_t& node, const node_t& peer_node, const segment_t segment,
+                        segment_integrity_t& integrity_OUT );
+
+// A connection between the process that opens it and the process that accepts it.
+// Its ping-pong loop is a coroutine that suspends at every hand-off between layers,
+// and each call to step( ) resumes it for one layer hop, so that it can be driven
+// either by a plain loop or by an executor interleaving many connections.
+class Connection
+{
+public:
+    // A round trip starts at the application layer of the opening process and ends
+    // once the response has been delivered back to it.
+    static constexpr auto hops_per_round_trip { 8uz };
+
+    // A connection that is reopened gets a new incarnation, and with it new faults, and so
+    // does every replication of a connection.
+    Connection( const topology_t& topology, const std::uint32_t connection_idx, const std::uint32_t incarnation = 0,
+                const std::uint32_t replication = 0 );
+
+    // Executes the next layer hop and returns whether the connection is still open.
+    bool
+    step( );
+
+    [[ nodiscard ]] bool
+    is_closed( ) const noexcept;
+
+    [[ nodiscard ]] std::uint32_t
+    get_connection_num( ) const noexcept;
+
+    [[ nodiscard ]] const connection_statistics_t&
+    get_statistics( ) const noexcept;
+
+    // The heap memory taken by the suspended ping-pong loop of a connection.
+    [[ nodiscard ]] static std::size_t
+    get_frame_size( ) noexcept;
+
+private:
+    [[ nodiscard ]] static util::Resumable<connection_statistics_t>
+    execute( const topology_t& topology, const std::uint32_t connection_idx, const std::uint32_t incarnation,
+             const std::uint32_t replication );
+
+    // The same dialogue over the reliable transport, with a window of messages in flight
+    // per direction. Each round trip carries a batch of segments across the channel in
+    // each direction, hence it takes as many hops as a round trip of execute( ).
+    [[ nodiscard ]] static util::Resumable<connection_statistics_t>
+    execute_reliable( const topology_t& topology, const std::uint32_t connection_idx, const std::uint32_t incarnation,
+                      const std::uint32_t replication );
+
+    util::Resumable<connection_statistics_t> m_coroutine;
+    std::uint32_t m_connection_num;
+};
+
+[[ nodiscard ]] std::size_t
+get_memory_per_connection( const topology_t& topology ) noexcept;
+
+[[ nodiscard ]] connection_statistics_t
+execute_connection( const topology_t& topology, const std::uint32_t connection_idx );
+
+[[ nodiscard ]] benchmark_report_t
+execute_benchmark( const topology_t& topology );
+
+// The same benchmark with each layer running as a pipeline stage on a thread of its own,
+// handing the messages and segments of every connection on to the next stage through
+// bounded lock-free rings, so that the layers work on different connections at once.
+[[ nodiscard ]] benchmark_report_t
+execute_pipelined_benchmark( const topology_t& topology );
+
+// The same benchmark with the odd-numbered nodes running in the process of the simulator
+// and the even-numbered ones in a process forked off from it, so every connection must
+// join an odd-numbered node to an even-numbered one. The segments cross between them
+// through a pair of lock-free rings in a shared-memory segment under /dev/shm, each side
+// spinning on its own ring without a system call for as long as there is something in it.
+[[ nodiscard ]] benchmark_report_t
+execute_multiprocess_benchmark( const topology_t& topology );
+
+// The multiprocess benchmark runs the odd-numbered nodes ( node1, node3, ... ) in the
+// process of the simulator and the even-numbered ones in a process forked off from it.
+inline constexpr auto node_side_count { 2uz };
+
+// Drives every connection open-loop with the configured traffic model: its requests
+// are due on the schedule of a traffic source of its own, whether or not the responses
+// to the previous ones are back, and a request that cannot go out on time because the
+// connection is still busy waits its turn. Each worker thread runs the round trips of
+// its share of the connections in the order in which their requests fall due.
+[[ nodiscard ]] open_loop_report_t
+execute_open_loop_benchmark( const topology_t& topology );
+
+[[ nodiscard ]] simulation_report_t
+execute_discrete_event_simulation( const topology_t& topology );
+
+// Executes every connection once on the wall clock, as tasks of a thread pool.
+void
+execute_real_time_simulation( const topology_t& topology );
+
+// The settings of a run, which the command line makes before it starts.
+void
+set_layers_delays( const bool layers_delays_status ) noexcept;
+
+void
+set_channel_faults( const bool channel_faults_status ) noexcept;
 
 void
-execute_connection1( const std::uint32_t node1_process1_num,
-                     const std::uint32_t node2_process2_num );
+set_tracing( const bool tracing_status ) noexcept;
 
 void
-execute_connection2( const std::uint32_t node1_process2_num,
-                     const std::uint32_t node2_process1_num );
+set_execution_mode( const execution_mode_t mode ) noexcept;
+
+void
+set_benchmark_round_trips_budget( const std::uint64_t round_trips_budget ) noexcept;
+
+void
+set_benchmark_time_budget( const std::chrono::seconds time_budget ) noexcept;
+
+void
+set_virtual_time( const bool virtual_time_status ) noexcept;
+
+void
+set_thread_count( const std::size_t thread_count ) noexcept;
+
+// The cores that the sides of the multiprocess benchmark are pinned to.
+void
+set_node_cpus( const std::array<std::uint32_t, node_side_count>& cpus ) noexcept;
+
+void
+set_binary_trace_path( const std::string_view path );
+
+void
+set_binary_trace_size( const std::size_t size ) noexcept;
+
+[[ nodiscard ]] execution_mode_t
+get_execution_mode( ) noexcept;
+
+[[ nodiscard ]] bool
+is_running_in_virtual_time( ) noexcept;
+
+// The number of worker threads configured, or else the number of hardware threads.
+[[ nodiscard ]] std::size_t
+get_thread_count( ) noexcept;
 
 }
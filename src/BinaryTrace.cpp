@@ -0,0 +1,157 @@
+#include "BinaryTrace.hpp"
+#include <system_error>
+#include <algorithm>
+#include "PlatformMacros.hpp"
+#include "SharedMemory.hpp"
+
+#if PLATFORM_NAME != OS_WINDOWS
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
+
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+// Tells the writers apart, so that a thread does not go on filling the region it
+// claimed from a writer that has since been replaced by another one at the same address.
+constinit std::atomic<std::uint64_t> next_writer_id { 1 };
+
+}
+
+
+BinaryTraceWriter::BinaryTraceWriter( const std::filesystem::path& path, const std::size_t file_size,
+                                      const std::uint32_t segment_bit_count )
+    : m_id { next_writer_id.fetch_add( 1, std::memory_order_relaxed ) },
+      m_start_time { std::chrono::steady_clock::now( ) },
+      m_mapping { },
+      m_mapping_size { std::max( file_size, sizeof( trace_file_header_t ) + region_size ) },
+      m_max_region_count { static_cast<std::uint32_t>( ( m_mapping_size - sizeof( trace_file_header_t ) ) /
+                                                       region_size ) },
+      m_file_descriptor { -1 }
+{
+#if PLATFORM_NAME != OS_WINDOWS
+    m_file_descriptor = ::open( path.c_str( ), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+
+    if ( m_file_descriptor == -1 )
+    {
+        throw util::make_system_error( "Failure in creating the trace file" );
+    }
+
+    if ( ::ftruncate( m_file_descriptor, static_cast<off_t>( m_mapping_size ) ) == -1 )
+    {
+        const auto error { util::make_system_error( "Failure in sizing the trace file" ) };
+        ::close( m_file_descriptor );
+
+        throw error;
+    }
+
+    void* const mapping { ::mmap( nullptr, m_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file_descriptor, 0 ) };
+
+    if ( mapping == MAP_FAILED )
+    {
+        const auto error { util::make_system_error( "Failure in mapping the trace file" ) };
+        ::close( m_file_descriptor );
+
+        throw error;
+    }
+
+    m_mapping = static_cast<std::byte*>( mapping );
+#else
+    throw std::system_error { std::make_error_code( std::errc::not_supported ), "Binary traces are not supported" };
+#endif
+
+    auto& header { get_file_header( ) };
+    header.magic = trace_file_header_t::expected_magic;
+    header.version = trace_file_header_t::current_version;
+    header.record_size = sizeof( trace_record_t );
+    header.records_per_region = records_per_region;
+    header.segment_bit_count = segment_bit_count;
+    header.start_time_ns = static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::system_clock::now( ).time_since_epoch( ) ).count( ) );
+}
+
+BinaryTraceWriter::~BinaryTraceWriter( )
+{
+    const auto region_count { std::min( m_claimed_region_count.load( ), m_max_region_count ) };
+
+    auto& header { get_file_header( ) };
+    header.region_count = region_count;
+    header.dropped_record_count = m_dropped_record_count.load( );
+
+#if PLATFORM_NAME != OS_WINDOWS
+    ::munmap( m_mapping, m_mapping_size );
+
+    // A failure leaves the unclaimed regions in the file, which the reader skips anyway.
+    [[ maybe_unused ]] const auto result { ::ftruncate( m_file_descriptor,
+                                                        static_cast<off_t>( sizeof( trace_file_header_t ) +
+                                                                            region_count * region_size ) ) };
+    ::close( m_file_descriptor );
+#endif
+}
+
+void
+BinaryTraceWriter::record( trace_record_t record ) noexcept
+{
+    thread_local constinit thread_cursor_t cursor { };
+
+    if ( cursor.writer_id != m_id || cursor.region == nullptr ||
+         cursor.region->record_count == records_per_region ) [[ unlikely ]]
+    {
+        if ( claim_region( cursor ) == false )
+        {
+            m_dropped_record_count.fetch_add( 1, std::memory_order_relaxed );
+
+            return;
+        }
+    }
+
+    record.wall_time_ns = static_cast<std::uint64_t>( std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now( ) - m_start_time ).count( ) );
+
+    cursor.records[ cursor.region->record_count++ ] = record;
+}
+
+[[ nodiscard ]] bool
+BinaryTraceWriter::claim_region( thread_cursor_t& cursor ) noexcept
+{
+    if ( cursor.writer_id != m_id )
+    {
+        cursor = thread_cursor_t { m_id, nullptr, nullptr, m_thread_count.fetch_add( 1, std::memory_order_relaxed ) };
+    }
+    else if ( cursor.region == nullptr )
+    {
+        // The file is full already.
+        return false;
+    }
+
+    const auto region_idx { m_claimed_region_count.fetch_add( 1, std::memory_order_relaxed ) };
+
+    if ( region_idx >= m_max_region_count )
+    {
+        cursor.region = nullptr;
+
+        return false;
+    }
+
+    auto* const region_start { m_mapping + sizeof( trace_file_header_t ) + region_idx * region_size };
+
+    cursor.region = reinterpret_cast<trace_region_header_t*>( region_start );
+    cursor.records = reinterpret_cast<trace_record_t*>( region_start + sizeof( trace_region_header_t ) );
+    cursor.region->thread_ordinal = cursor.thread_ordinal;
+    cursor.region->record_count = 0;
+
+    return true;
+}
+
+[[ nodiscard ]] trace_file_header_t&
+BinaryTraceWriter::get_file_header( ) const noexcept
+{
+    return *reinterpret_cast<trace_file_header_t*>( m_mapping );
+}
+
+}
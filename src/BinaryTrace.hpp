@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace simple_network_simulation
+{
+
+// The events of the binary trace. The transport layer records the segments it encodes
+// and decodes, and the channel the segments that enter it and those that leave it, so
+// a segment shows up as it was before and after its trip across the channel.
+enum class trace_event_t : std::uint8_t
+{
+    segment_encoded,
+    segment_entered_channel,
+    segment_left_channel,
+    segment_decoded
+};
+
+// The records are fixed-size, so that a writer appends one with a handful of stores and
+// a reader can seek to any of them.
+struct trace_record_t
+{
+    std::uint64_t wall_time_ns;         // since the trace was opened
+    std::uint64_t simulated_time_ns;    // on the simulated clock of the recording thread
+    std::uint64_t segment_bits;
+    std::uint32_t connection_num;
+    std::uint32_t node_num;             // 0 for the events of the channel
+    trace_event_t event;
+    std::uint8_t detail;                // the channel_direction_t of the events of the channel and
+                                        // the segment_integrity_t of a decoded segment
+    std::array<std::uint8_t, 6> reserved;
+};
+
+static_assert( sizeof( trace_record_t ) == 40 );
+
+// The file starts with this header and is followed by equally sized regions, each of
+// which belongs to a single thread and holds a region header and its records.
+struct trace_file_header_t
+{
+    static constexpr std::array<char, 8> expected_magic { 'S', 'N', 'S', 'T', 'R', 'A', 'C', 'E' };
+    static constexpr std::uint32_t current_version { 1 };
+
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint32_t records_per_region;
+    std::uint32_t region_count;         // the regions that got claimed before the trace was closed
+    std::uint32_t segment_bit_count;
+    std::uint32_t reserved;
+    std::uint64_t start_time_ns;        // on the system clock, since the epoch
+    std::uint64_t dropped_record_count; // the records that found the file full
+    std::array<std::uint8_t, 16> padding;
+};
+
+static_assert( sizeof( trace_file_header_t ) == 64 );
+
+struct trace_region_header_t
+{
+    std::uint32_t thread_ordinal;
+    std::uint32_t record_count;
+    std::array<std::uint8_t, 24> padding;
+};
+
+static_assert( sizeof( trace_region_header_t ) == 32 );
+
+// Appends trace records to a memory-mapped file of a fixed size. Every thread claims a
+// region of the file for itself and fills it without synchronizing with the others; it
+// only touches the shared counter of claimed regions once per region, and once the file
+// is full the records are counted and dropped. Closing the trace cuts the file down to
+// the regions that were claimed.
+class BinaryTraceWriter
+{
+public:
+    static constexpr std::uint32_t records_per_region { 4096 };
+    static constexpr auto region_size { sizeof( trace_region_header_t ) + records_per_region * sizeof( trace_record_t ) };
+
+    // Throws std::system_error if the file cannot be created or mapped.
+    BinaryTraceWriter( const std::filesystem::path& path, const std::size_t file_size,
+                       const std::uint32_t segment_bit_count );
+
+    BinaryTraceWriter( const BinaryTraceWriter& ) = delete;
+    BinaryTraceWriter& operator=( const BinaryTraceWriter& ) = delete;
+
+    // Must not run before every thread is done recording.
+    ~BinaryTraceWriter( );
+
+    // Stamps the record with the wall-clock time and appends it.
+    void
+    record( trace_record_t record ) noexcept;
+
+private:
+    struct thread_cursor_t
+    {
+        std::uint64_t writer_id;
+        trace_region_header_t* region;
+        trace_record_t* records;
+        std::uint32_t thread_ordinal;
+    };
+
+    [[ nodiscard ]] bool
+    claim_region( thread_cursor_t& cursor ) noexcept;
+
+    [[ nodiscard ]] trace_file_header_t&
+    get_file_header( ) const noexcept;
+
+    std::uint64_t m_id;
+    std::chrono::steady_clock::time_point m_start_time;
+    std::byte* m_mapping;
+    std::size_t m_mapping_size;
+    std::uint32_t m_max_region_count;
+    int m_file_descriptor;
+    alignas( 64 ) std::atomic<std::uint32_t> m_claimed_region_count { };
+    std::atomic<std::uint32_t> m_thread_count { };
+    std::atomic<std::uint64_t> m_dropped_record_count { };
+};
+
+}
@@ -0,0 +1,337 @@
+#include "ChannelFaults.hpp"
+#include <array>
+#include <span>
+#include <string_view>
+#include <charconv>
+#include <expected>
+#include <system_error>
+#include <utility>
+#include <limits>
+#include <optional>
+#include <random>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "BidirectionalMultimessageSimulation.hpp"
+#include "Random.hpp"
+
+
+using std::uint64_t;
+using std::size_t;
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+constinit std::array<channel_fault_model_t, 2> channel_fault_models { };
+
+constinit std::optional<uint64_t> configured_random_seed { };
+
+// Far enough away to never be reached, yet safe to count down from.
+constexpr auto never { std::numeric_limits<uint64_t>::max( ) / 2 };
+
+// Samples the number of trials that precede the first success of a sequence of
+// Bernoulli trials by inverting the cumulative distribution of the geometric law.
+[[ nodiscard ]] uint64_t
+sample_geometric_gap( const double probability, util::Philox4x32& generator ) noexcept
+{
+    if ( probability <= 0.0 )
+    {
+        return never;
+    }
+
+    if ( probability >= 1.0 )
+    {
+        return 0;
+    }
+
+    const auto uniform { ( static_cast<double>( generator( ) ) + 0.5 ) * 0x1p-32 };
+    const auto gap { std::floor( std::log( uniform ) / std::log1p( -probability ) ) };
+
+    return gap < static_cast<double>( never ) ? static_cast<uint64_t>( gap ) : never;
+}
+
+}
+
+
+[[ nodiscard ]] std::expected<channel_fault_model_t, std::errc>
+parse_channel_fault_model( std::string_view specification ) noexcept
+{
+    using std::string_view_literals::operator""sv;
+
+    channel_fault_model_t model { };
+
+    while ( std::empty( specification ) == false )
+    {
+        const auto separator_pos { specification.find( ',' ) };
+        const auto impairment { specification.substr( 0, separator_pos ) };
+        specification.remove_prefix( separator_pos == std::string_view::npos ? std::size( specification )
+                                                                             : separator_pos + 1 );
+
+        const auto equals_sign_pos { impairment.find( '=' ) };
+
+        if ( equals_sign_pos == std::string_view::npos )
+        {
+            return std::unexpected { std::errc::invalid_argument };
+        }
+
+        const auto key { impairment.substr( 0, equals_sign_pos ) };
+        const auto value_text { impairment.substr( equals_sign_pos + 1 ) };
+        const auto value_text_end { std::data( value_text ) + std::size( value_text ) };
+
+        double value { };
+
+        if ( const auto [ ptr, ec ] { std::from_chars( std::data( value_text ), value_text_end, value ) };
+             ec != std::errc { } || ptr != value_text_end )
+        {
+            return std::unexpected { ec != std::errc { } ? ec : std::errc::invalid_argument };
+        }
+
+        if ( ( value >= 0.0 && value <= 1.0 ) == false )
+        {
+            return std::unexpected { std::errc::argument_out_of_domain };
+        }
+
+        if ( key == "ber"sv )
+        {
+            model.bit_error_rate = value;
+        }
+        else if ( key == "burst-enter"sv )
+        {
+            model.burst.enter_burst_probability = value;
+        }
+        else if ( key == "burst-exit"sv )
+        {
+            model.burst.exit_burst_probability = value;
+        }
+        else if ( key == "burst-ber"sv )
+        {
+            model.burst.burst_bit_error_rate = value;
+        }
+        else if ( key == "loss"sv )
+        {
+            model.loss_probability = value;
+        }
+        else if ( key == "duplicate"sv )
+        {
+            model.duplication_probability = value;
+        }
+        else if ( key == "reorder"sv )
+        {
+            model.reordering_probability = value;
+        }
+        else
+        {
+            return std::unexpected { std::errc::invalid_argument };
+        }
+    }
+
+    return model;
+}
+
+void
+set_channel_fault_model( const channel_direction_t direction, const channel_fault_model_t& model ) noexcept
+{
+    channel_fault_models[ std::to_underlying( direction ) ] = model;
+}
+
+[[ nodiscard ]] const channel_fault_model_t&
+get_channel_fault_model( const channel_direction_t direction ) noexcept
+{
+    return channel_fault_models[ std::to_underlying( direction ) ];
+}
+
+ChannelFaultInjector::ChannelFaultInjector( const channel_fault_model_t& model ) noexcept
+    : m_model { model }
+{
+}
+
+[[ nodiscard ]] bool
+ChannelFaultInjector::is_faultless( ) const noexcept
+{
+    return m_model.bit_error_rate <= 0.0 && m_model.burst.enter_burst_probability <= 0.0 &&
+           m_model.loss_probability <= 0.0 && m_model.duplication_probability <= 0.0 &&
+           m_model.reordering_probability <= 0.0;
+}
+
+[[ nodiscard ]] std::size_t
+ChannelFaultInjector::apply( const std::span<const segment_t> segments, const std::span<segment_t> delivered_OUT,
+                             util::Philox4x32& generator ) noexcept
+{
+    if ( m_is_sampled == false )
+    {
+        m_bits_to_next_error = sample_bits_to_next_error( generator );
+        m_bits_to_next_transition = sample_bits_to_next_transition( generator );
+        m_segments_to_next_loss = sample_geometric_gap( m_model.loss_probability, generator );
+        m_segments_to_next_duplication = sample_geometric_gap( m_model.duplication_probability, generator );
+        m_segments_to_next_reordering = sample_geometric_gap( m_model.reordering_probability, generator );
+        m_is_sampled = true;
+    }
+
+    auto delivered_count { 0uz };
+
+    for ( const auto segment : segments )
+    {
+        const auto impaired_segment { inject_bit_errors( segment, generator ) };
+
+        if ( m_segments_to_next_loss == 0 )
+        {
+            m_segments_to_next_loss = sample_geometric_gap( m_model.loss_probability, generator );
+            ++m_counters.loss_count;
+            continue;
+        }
+
+        --m_segments_to_next_loss;
+        delivered_OUT[ delivered_count++ ] = impaired_segment;
+
+        if ( m_segments_to_next_duplication == 0 )
+        {
+            m_segments_to_next_duplication = sample_geometric_gap( m_model.duplication_probability, generator );
+            ++m_counters.duplication_count;
+            delivered_OUT[ delivered_count++ ] = impaired_segment;
+            continue;
+        }
+
+        --m_segments_to_next_duplication;
+    }
+
+    // A reordered segment gets overtaken by the one that follows it. Two segments that
+    // carry the same bits, such as a segment and its duplicate, cannot be told apart in
+    // either order, so they are no candidates.
+    for ( auto segment_idx { 0uz }; segment_idx + 1 < delivered_count; ++segment_idx )
+    {
+        if ( delivered_OUT[ segment_idx ].bits == delivered_OUT[ segment_idx + 1 ].bits )
+        {
+            continue;
+        }
+
+        if ( m_segments_to_next_reordering == 0 )
+        {
+            m_segments_to_next_reordering = sample_geometric_gap( m_model.reordering_probability, generator );
+            ++m_counters.reordering_count;
+            std::swap( delivered_OUT[ segment_idx ], delivered_OUT[ segment_idx + 1 ] );
+            ++segment_idx;
+            continue;
+        }
+
+        --m_segments_to_next_reordering;
+    }
+
+    return delivered_count;
+}
+
+[[ nodiscard ]] const channel_fault_counters_t&
+ChannelFaultInjector::get_counters( ) const noexcept
+{
+    return m_counters;
+}
+
+[[ nodiscard ]] uint64_t
+ChannelFaultInjector::sample_bits_to_next_error( util::Philox4x32& generator ) const noexcept
+{
+    return sample_geometric_gap( m_is_in_burst ? m_model.burst.burst_bit_error_rate : m_model.bit_error_rate,
+                                 generator );
+}
+
+[[ nodiscard ]] uint64_t
+ChannelFaultInjector::sample_bits_to_next_transition( util::Philox4x32& generator ) const noexcept
+{
+    return sample_geometric_gap( m_is_in_burst ? m_model.burst.exit_burst_probability
+                                               : m_model.burst.enter_burst_probability,
+                                 generator );
+}
+
+// Both gaps count the clean bits ahead. The bit that a zero gap to the next error points
+// at gets flipped, and the bit that a zero gap to the next transition points at is the
+// last one sent in the current state, so that every state lasts at least one bit and a
+// burst lasts 1 / exit_burst_probability bits on average. Since both laws are memoryless,
+// the gap to the next error is simply sampled afresh under the bit error rate of the new
+// state.
+[[ nodiscard ]] segment_t
+ChannelFaultInjector::inject_bit_errors( segment_t segment, util::Philox4x32& generator ) noexcept
+{
+    auto remaining_bit_count { uint64_t { segment_bit_count } };
+    auto bit_idx { uint64_t { 0 } };
+
+    while ( true )
+    {
+        if ( m_bits_to_next_transition < m_bits_to_next_error && m_bits_to_next_transition < remaining_bit_count )
+        {
+            bit_idx += m_bits_to_next_transition + 1;
+            remaining_bit_count -= m_bits_to_next_transition + 1;
+
+            m_is_in_burst = !m_is_in_burst;
+            m_bits_to_next_transition = sample_bits_to_next_transition( generator );
+            m_bits_to_next_error = sample_bits_to_next_error( generator );
+
+            continue;
+        }
+
+        if ( m_bits_to_next_error < remaining_bit_count )
+        {
+            bit_idx += m_bits_to_next_error;
+            remaining_bit_count -= m_bits_to_next_error + 1;
+
+            segment.bits ^= static_cast<segment_word_t>( segment_word_t { 1 } << bit_idx );
+            ++bit_idx;
+            ++m_counters.flipped_bit_count;
+
+            if ( m_bits_to_next_transition == m_bits_to_next_error )
+            {
+                m_is_in_burst = !m_is_in_burst;
+                m_bits_to_next_transition = sample_bits_to_next_transition( generator );
+            }
+            else
+            {
+                m_bits_to_next_transition -= m_bits_to_next_error + 1;
+            }
+
+            m_bits_to_next_error = sample_bits_to_next_error( generator );
+
+            continue;
+        }
+
+        m_bits_to_next_error -= remaining_bit_count;
+        m_bits_to_next_transition -= remaining_bit_count;
+
+        return segment;
+    }
+}
+
+[[ nodiscard ]] channel_stream_t
+make_channel_stream( const std::uint32_t connection_idx, const std::uint32_t incarnation,
+                     const std::uint32_t replication )
+{
+    // Any two keys yield unrelated streams, and the golden ratio spreads the keys of the
+    // replications over the whole key space.
+    constexpr auto replication_key_stride { uint64_t { 0x9E37'79B9'7F4A'7C15 } };
+
+    const auto key { get_random_seed( ) + replication * replication_key_stride };
+    const auto stream { ( uint64_t { incarnation } << 32 ) | connection_idx };
+
+    return channel_stream_t { util::Philox4x32 { key, stream },
+                              { ChannelFaultInjector { channel_fault_models[ 0 ] },
+                                ChannelFaultInjector { channel_fault_models[ 1 ] } } };
+}
+
+void
+set_random_seed( const std::uint64_t seed ) noexcept
+{
+    configured_random_seed = seed;
+}
+
+[[ nodiscard ]] std::uint64_t
+get_random_seed( )
+{
+    static const auto random_seed { configured_random_seed.has_value( ) ? *configured_random_seed : [ ]
+                                    {
+                                        std::random_device rand_dev { };
+                                        return ( uint64_t { rand_dev( ) } << 32 ) | rand_dev( );
+                                    }( ) };
+
+    return random_seed;
+}
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <string_view>
+#include <expected>
+#include <system_error>
+#include <cstddef>
+#include <cstdint>
+#include "BidirectionalMultimessageSimulation.hpp"
+#include "Random.hpp"
+
+
+namespace simple_network_simulation
+{
+
+// The Gilbert-Elliott channel: every bit either keeps the channel in its current state
+// or moves it between a good state, with the independent bit error rate of the model,
+// and a bad state with a bit error rate of its own, so that errors come in bursts.
+struct [[ nodiscard ]] burst_error_model_t
+{
+    double enter_burst_probability;
+    double exit_burst_probability;
+    double burst_bit_error_rate;
+};
+
+// The impairments of one direction of the channel. All of them default to 0, i.e. to
+// a perfect channel.
+struct [[ nodiscard ]] channel_fault_model_t
+{
+    double bit_error_rate;
+    burst_error_model_t burst;
+    double loss_probability;
+    double duplication_probability;
+    double reordering_probability;
+};
+
+struct [[ nodiscard ]] channel_fault_counters_t
+{
+    std::uint64_t flipped_bit_count;
+    std::uint64_t loss_count;
+    std::uint64_t duplication_count;
+    std::uint64_t reordering_count;
+};
+
+// Parses a comma-separated list of impairments such as "ber=1e-4,loss=0.01", with the
+// keys ber, burst-enter, burst-exit, burst-ber, loss, duplicate and reorder, each
+// taking a probability.
+[[ nodiscard ]] std::expected<channel_fault_model_t, std::errc>
+parse_channel_fault_model( const std::string_view specification ) noexcept;
+
+void
+set_channel_fault_model( const channel_direction_t direction, const channel_fault_model_t& model ) noexcept;
+
+[[ nodiscard ]] const channel_fault_model_t&
+get_channel_fault_model( const channel_direction_t direction ) noexcept;
+
+// Applies the fault model of one direction of the channel to a stream of segments.
+// Rather than drawing a random number per bit (or per segment) it samples the gap to
+// the next event from a geometric distribution and skips over the clean bits, so that
+// at low error rates a clean segment costs little more than a subtraction.
+class ChannelFaultInjector
+{
+public:
+    explicit
+    ChannelFaultInjector( const channel_fault_model_t& model ) noexcept;
+
+    [[ nodiscard ]] bool
+    is_faultless( ) const noexcept;
+
+    // Writes the segments that come out of the channel to delivered_OUT, which must hold
+    // twice as many segments as go in, and returns how many of them there are.
+    [[ nodiscard ]] std::size_t
+    apply( const std::span<const segment_t> segments, const std::span<segment_t> delivered_OUT,
+           util::Philox4x32& generator ) noexcept;
+
+    [[ nodiscard ]] const channel_fault_counters_t&
+    get_counters( ) const noexcept;
+
+private:
+    [[ nodiscard ]] std::uint64_t
+    sample_bits_to_next_error( util::Philox4x32& generator ) const noexcept;
+
+    [[ nodiscard ]] std::uint64_t
+    sample_bits_to_next_transition( util::Philox4x32& generator ) const noexcept;
+
+    [[ nodiscard ]] segment_t
+    inject_bit_errors( segment_t segment, util::Philox4x32& generator ) noexcept;
+
+    channel_fault_model_t m_model;
+    bool m_is_in_burst { };
+    bool m_is_sampled { };
+    std::uint64_t m_bits_to_next_error { };
+    std::uint64_t m_bits_to_next_transition { };
+    std::uint64_t m_segments_to_next_loss { };
+    std::uint64_t m_segments_to_next_duplication { };
+    std::uint64_t m_segments_to_next_reordering { };
+    channel_fault_counters_t m_counters { };
+};
+
+// The channel as a single connection sees it. The faults of both of its directions are
+// drawn from a stream of their own, keyed on the seed of the run (offset for each of its
+// replications, if it is replicated) and selected by the connection and its incarnation
+// (the number of times it has been reopened), so they do not depend on the thread that
+// carries the segments or on the other connections.
+struct [[ nodiscard ]] channel_stream_t
+{
+    util::Philox4x32 generator;
+    std::array<ChannelFaultInjector, 2> fault_injectors;    // indexed by channel_direction_t
+};
+
+// Sets up a stream with the fault models configured for the directions of the channel.
+[[ nodiscard ]] channel_stream_t
+make_channel_stream( const std::uint32_t connection_idx, const std::uint32_t incarnation,
+                     const std::uint32_t replication = 0 );
+
+void
+set_random_seed( const std::uint64_t seed ) noexcept;
+
+// The seed of the run: the one set, or else one drawn from the entropy source of the
+// system the first time it is asked for.
+[[ nodiscard ]] std::uint64_t
+get_random_seed( );
+
+}
@@ -0,0 +1,181 @@
+
+#include <string_view>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <fmt/core.h>
+#include "BidirectionalMultimessageSimulation.hpp"
+#include "ChannelFaults.hpp"
+#include "Random.hpp"
+
+
+namespace sns = simple_network_simulation;
+
+namespace
+{
+
+using std::string_view_literals::operator""sv;
+
+constexpr auto tool_name { "sns-test"sv };
+
+constexpr auto segment_count { 1uz << 16 };
+constexpr auto batch_segment_count { 64uz };
+constexpr auto generator_key { std::uint64_t { 0x5EED } };
+
+// Relative tolerance on the mean burst length, some five standard deviations of the
+// estimate at the lowest exit probability tested.
+constexpr auto burst_length_tolerance { 0.05 };
+
+struct burst_statistics_t
+{
+    std::uint64_t bit_count;
+    std::uint64_t flipped_bit_count;
+    std::uint64_t burst_count;
+};
+
+// Sends clean segments through a channel that is error-free in its good state and flips
+// every bit in its bad one, so that the runs of flipped bits are exactly its bursts
+// (a good state lasts at least one bit, and keeps any two bursts apart).
+[[ nodiscard ]] burst_statistics_t
+measure_bursts( const std::string_view specification )
+{
+    const auto model { sns::parse_channel_fault_model( specification ) };
+
+    if ( model.has_value( ) == false )
+    {
+        fmt::print( stderr, "{}: invalid fault model {}\n", tool_name, specification );
+
+        std::exit( EXIT_FAILURE );
+    }
+
+    sns::ChannelFaultInjector injector { *model };
+    sns::util::Philox4x32 generator { generator_key };
+
+    std::array<sns::segment_t, batch_segment_count> segments { };
+    std::array<sns::segment_t, 2 * batch_segment_count> delivered { };
+
+    burst_statistics_t statistics { };
+    auto is_previous_bit_flipped { false };
+
+    for ( auto batch_idx { 0uz }; batch_idx < segment_count / batch_segment_count; ++batch_idx )
+    {
+        const auto delivered_count { injector.apply( segments, delivered, generator ) };
+
+        for ( auto segment_idx { 0uz }; segment_idx < delivered_count; ++segment_idx )
+        {
+            const auto bits { delivered[ segment_idx ].to_bitset( ) };
+
+            for ( auto bit_idx { 0uz }; bit_idx < sns::segment_bit_count; ++bit_idx )
+            {
+                const auto is_bit_flipped { bits.test( bit_idx ) };
+
+                statistics.burst_count += is_bit_flipped && is_previous_bit_flipped == false;
+                statistics.flipped_bit_count += is_bit_flipped;
+                is_previous_bit_flipped = is_bit_flipped;
+            }
+        }
+
+        statistics.bit_count += delivered_count * sns::segment_bit_count;
+    }
+
+    return statistics;
+}
+
+[[ nodiscard ]] bool
+check_mean_burst_length( const std::string_view specification, const double exit_burst_probability )
+{
+    const auto statistics { measure_bursts( specification ) };
+    const auto expected_length { 1.0 / exit_burst_probability };
+    const auto flipped_bit_count { static_cast<double>( statistics.flipped_bit_count ) };
+    const auto mean_length { statistics.burst_count > 0 ? flipped_bit_count / static_cast<double>( statistics.burst_count )
+                                                        : 0.0 };
+    const auto is_passed { std::abs( mean_length - expected_length ) <= burst_length_tolerance * expected_length };
+
+    fmt::print( "{:<4} {:<48} mean burst length {:.3f} (expected {:.3f}) over {} bits\n", is_passed ? "ok" : "FAIL",
+                specification, mean_length, expected_length, statistics.bit_count );
+
+    return is_passed;
+}
+
+// Sends segments numbered in order through a reordering channel, and checks that each
+// reordering counted shows as a segment that comes out after the one that followed it.
+[[ nodiscard ]] bool
+check_reorderings( const std::string_view specification )
+{
+    const auto model { sns::parse_channel_fault_model( specification ) };
+
+    if ( model.has_value( ) == false )
+    {
+        fmt::print( stderr, "{}: invalid fault model {}\n", tool_name, specification );
+
+        std::exit( EXIT_FAILURE );
+    }
+
+    sns::ChannelFaultInjector injector { *model };
+    sns::util::Philox4x32 generator { generator_key };
+
+    std::array<sns::segment_t, batch_segment_count> segments;
+    std::array<sns::segment_t, 2 * batch_segment_count> delivered { };
+
+    for ( auto segment_idx { 0uz }; segment_idx < batch_segment_count; ++segment_idx )
+    {
+        segments[ segment_idx ] = sns::segment_t { static_cast<sns::segment_word_t>( segment_idx ) };
+    }
+
+    const auto delivered_count { injector.apply( segments, delivered, generator ) };
+    auto overtaken_count { std::uint64_t { 0 } };
+
+    for ( auto segment_idx { 1uz }; segment_idx < delivered_count; ++segment_idx )
+    {
+        overtaken_count += delivered[ segment_idx ].bits < delivered[ segment_idx - 1 ].bits;
+    }
+
+    const auto reordering_count { injector.get_counters( ).reordering_count };
+    const auto is_passed { reordering_count > 0 && reordering_count == overtaken_count };
+
+    fmt::print( "{:<4} {:<48} {} reorderings counted, {} segments overtaken\n", is_passed ? "ok" : "FAIL",
+                specification, reordering_count, overtaken_count );
+
+    return is_passed;
+}
+
+}
+
+
+int
+main( )
+{
+    auto is_passed { true };
+
+    // With both transitions certain the channel alternates between its states at every
+    // bit, so exactly every other bit gets flipped.
+    {
+        constexpr auto specification { "ber=0,burst-enter=1,burst-exit=1,burst-ber=1"sv };
+
+        const auto statistics { measure_bursts( specification ) };
+        const auto is_alternating { statistics.bit_count == segment_count * sns::segment_bit_count &&
+                                    statistics.flipped_bit_count == statistics.bit_count / 2 &&
+                                    statistics.burst_count == statistics.flipped_bit_count };
+
+        fmt::print( "{:<4} {:<48} {} of {} bits flipped in {} bursts\n", is_alternating ? "ok" : "FAIL", specification,
+                    statistics.flipped_bit_count, statistics.bit_count, statistics.burst_count );
+
+        is_passed &= is_alternating;
+    }
+
+    is_passed &= check_mean_burst_length( "ber=0,burst-enter=1,burst-exit=1,burst-ber=1"sv, 1.0 );
+    is_passed &= check_mean_burst_length( "ber=0,burst-enter=1,burst-exit=0.5,burst-ber=1"sv, 0.5 );
+    is_passed &= check_mean_burst_length( "ber=0,burst-enter=1,burst-exit=0.25,burst-ber=1"sv, 0.25 );
+    is_passed &= check_mean_burst_length( "ber=0,burst-enter=0.01,burst-exit=0.1,burst-ber=1"sv, 0.1 );
+
+    // A duplicate cannot be told apart from its original, so swapping the two is no
+    // reordering.
+    is_passed &= check_reorderings( "reorder=1"sv );
+    is_passed &= check_reorderings( "reorder=0.3"sv );
+    is_passed &= check_reorderings( "duplicate=1,reorder=1"sv );
+    is_passed &= check_reorderings( "duplicate=0.5,reorder=0.5"sv );
+
+    return is_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,75 @@
+#include "Coroutine.hpp"
+#include <new>
+#include <utility>
+#include <cstddef>
+
+
+namespace simple_network_simulation::util
+{
+
+namespace
+{
+
+constexpr auto max_cached_frame_count { 4096uz };
+
+// The freed frames are chained through their own first bytes.
+struct cached_frame_t
+{
+    cached_frame_t* next;
+};
+
+struct frame_list_t
+{
+    cached_frame_t* head { };
+    std::size_t frame_size { };
+    std::size_t frame_count { };
+
+    frame_list_t( ) = default;
+    frame_list_t( const frame_list_t& ) = delete;
+    frame_list_t& operator=( const frame_list_t& ) = delete;
+
+    ~frame_list_t( )
+    {
+        while ( head != nullptr )
+        {
+            ::operator delete( std::exchange( head, head->next ), frame_size );
+        }
+    }
+};
+
+thread_local frame_list_t cached_frames { };
+
+}
+
+
+[[ nodiscard ]] void*
+coroutine_frame_cache::allocate( const std::size_t frame_size )
+{
+    if ( frame_size == cached_frames.frame_size && cached_frames.head != nullptr )
+    {
+        --cached_frames.frame_count;
+        return std::exchange( cached_frames.head, cached_frames.head->next );
+    }
+
+    return ::operator new( frame_size );
+}
+
+void
+coroutine_frame_cache::deallocate( void* const frame, const std::size_t frame_size ) noexcept
+{
+    if ( cached_frames.frame_count == 0 && frame_size >= sizeof( cached_frame_t ) )
+    {
+        cached_frames.frame_size = frame_size;
+    }
+
+    if ( frame_size != cached_frames.frame_size || cached_frames.frame_count == max_cached_frame_count )
+    {
+        ::operator delete( frame, frame_size );
+        return;
+    }
+
+    cached_frames.head = ::new( frame ) cached_frame_t { cached_frames.head };
+    ++cached_frames.frame_count;
+}
+
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <atomic>
+#include <cstddef>
+
+
+namespace simple_network_simulation::util
+{
+
+// The frames of the coroutines of a given type all have the same size, so each thread
+// keeps the frames freed on it for reuse instead of going back to the heap every time
+// such a coroutine is started.
+struct coroutine_frame_cache
+{
+    [[ nodiscard ]] static void*
+    allocate( const std::size_t frame_size );
+
+    static void
+    deallocate( void* const frame, const std::size_t frame_size ) noexcept;
+};
+
+// A coroutine that starts suspended and is then resumed by its owner one suspension
+// point at a time, so that whatever drives it (an event scheduler, a thread pool, a
+// plain loop) acts as its executor. Its promise holds a State which the coroutine
+// body reaches through this_coroutine_state and its owner through get_state( ).
+template <class State>
+class Resumable
+{
+public:
+    struct promise_type
+    {
+        State state { };
+        std::exception_ptr exception { };
+
+        [[ nodiscard ]] static void*
+        operator new( const std::size_t frame_size )
+        {
+            last_frame_size.store( frame_size, std::memory_order_relaxed );
+            return coroutine_frame_cache::allocate( frame_size );
+        }
+
+        static void
+        operator delete( void* const frame, const std::size_t frame_size ) noexcept
+        {
+            coroutine_frame_cache::deallocate( frame, frame_size );
+        }
+
+        [[ nodiscard ]] Resumable
+        get_return_object( ) noexcept
+        {
+            return Resumable { std::coroutine_handle<promise_type>::from_promise( *this ) };
+        }
+
+        [[ nodiscard ]] std::suspend_always
+        initial_suspend( ) const noexcept
+        {
+            return { };
+        }
+
+        [[ nodiscard ]] std::suspend_always
+        final_suspend( ) const noexcept
+        {
+            return { };
+        }
+
+        void
+        return_void( ) const noexcept
+        {
+        }
+
+        void
+        unhandled_exception( ) noexcept
+        {
+            exception = std::current_exception( );
+        }
+    };
+
+    Resumable( Resumable&& rhs ) noexcept
+        : m_handle { std::exchange( rhs.m_handle, nullptr ) }
+    {
+    }
+
+    Resumable&
+    operator=( Resumable&& rhs ) noexcept
+    {
+        if ( this != &rhs )
+        {
+            destroy( );
+            m_handle = std::exchange( rhs.m_handle, nullptr );
+        }
+
+        return *this;
+    }
+
+    ~Resumable( )
+    {
+        destroy( );
+    }
+
+    // Runs the coroutine up to its next suspension point, rethrowing whatever escaped it.
+    void
+    resume( )
+    {
+        m_handle.resume( );
+
+        if ( auto& exception { m_handle.promise( ).exception }; exception != nullptr ) [[ unlikely ]]
+        {
+            std::rethrow_exception( std::exchange( exception, nullptr ) );
+        }
+    }
+
+    [[ nodiscard ]] bool
+    done( ) const noexcept
+    {
+        return m_handle.done( );
+    }
+
+    [[ nodiscard ]] const State&
+    get_state( ) const noexcept
+    {
+        return m_handle.promise( ).state;
+    }
+
+    // The size of the most recently allocated frame, as laid out by the compiler.
+    [[ nodiscard ]] static std::size_t
+    get_frame_size( ) noexcept
+    {
+        return last_frame_size.load( std::memory_order_relaxed );
+    }
+
+private:
+    explicit
+    Resumable( const std::coroutine_handle<promise_type> handle ) noexcept
+        : m_handle { handle }
+    {
+    }
+
+    void
+    destroy( ) noexcept
+    {
+        if ( m_handle != nullptr )
+        {
+            m_handle.destroy( );
+        }
+    }
+
+    inline static std::atomic<std::size_t> last_frame_size { };
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+// Awaited from within the body of a Resumable<State>, yields its State without suspending.
+template <class State>
+struct this_coroutine_state
+{
+    State* state { };
+
+    [[ nodiscard ]] bool
+    await_ready( ) const noexcept
+    {
+        return false;
+    }
+
+    [[ nodiscard ]] bool
+    await_suspend( const std::coroutine_handle<typename Resumable<State>::promise_type> handle ) noexcept
+    {
+        state = &handle.promise( ).state;
+        return false;
+    }
+
+    [[ nodiscard ]] State&
+    await_resume( ) const noexcept
+    {
+        return *state;
+    }
+};
+
+}
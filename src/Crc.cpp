@@ -0,0 +1,150 @@
+#include "Crc.hpp"
+#include <span>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+#if defined( __x86_64__ ) && defined( __GNUC__ )
+#   define SNS_CLMUL_CRC32 1
+#   include <immintrin.h>
+#else
+#   define SNS_CLMUL_CRC32 0
+#endif
+
+using std::uint32_t;
+using std::uint64_t;
+using std::size_t;
+
+namespace simple_network_simulation::util
+{
+
+namespace
+{
+
+#if SNS_CLMUL_CRC32 == 1
+
+// The folding constants are the remainders of powers of x modulo the polynomial, bit
+// reflected like the data and shifted up by one bit, which makes up for the product of
+// two reflected operands coming out one bit short.
+[[ nodiscard ]] consteval uint64_t
+make_folding_constant( const size_t exponent ) noexcept
+{
+    constexpr auto polynomial { uint64_t { 0x1'04C1'1DB7 } };
+
+    auto remainder { uint64_t { 1 } };
+
+    for ( auto idx { 0uz }; idx < exponent; ++idx )
+    {
+        remainder <<= 1;
+        remainder ^= ( remainder >> 32 ) != 0 ? polynomial : 0;
+    }
+
+    auto reflected_remainder { uint64_t { 0 } };
+
+    for ( auto bit_idx { 0uz }; bit_idx < 32; ++bit_idx )
+    {
+        reflected_remainder |= ( ( remainder >> bit_idx ) & 1 ) << ( 31 - bit_idx );
+    }
+
+    return reflected_remainder << 1;
+}
+
+constexpr auto block_byte_count { 64uz };
+constexpr auto lane_bit_count { 128uz };
+
+// Folding a 128-bit lane forward by d bits multiplies its high-order half by x^( d + 32 )
+// and its low-order half by x^( d - 32 ) modulo the polynomial.
+constexpr auto fold_by_4_low_constant { make_folding_constant( 4 * lane_bit_count + 32 ) };
+constexpr auto fold_by_4_high_constant { make_folding_constant( 4 * lane_bit_count - 32 ) };
+constexpr auto fold_by_1_low_constant { make_folding_constant( lane_bit_count + 32 ) };
+constexpr auto fold_by_1_high_constant { make_folding_constant( lane_bit_count - 32 ) };
+
+[[ nodiscard, gnu::target( "pclmul,sse4.1" ) ]] __m128i
+fold_lane( const __m128i lane, const __m128i constants ) noexcept
+{
+    return _mm_xor_si128( _mm_clmulepi64_si128( lane, constants, 0x00 ),
+                          _mm_clmulepi64_si128( lane, constants, 0x11 ) );
+}
+
+[[ gnu::target( "pclmul,sse4.1" ) ]] void
+fold_crc32_clmul( uint32_t& state, const std::byte* const data, const size_t block_count ) noexcept
+{
+    const auto load_lane { [ data ]( const size_t lane_idx )
+                           {
+                               return _mm_loadu_si128( reinterpret_cast<const __m128i*>( data ) +
+                                                       static_cast<std::ptrdiff_t>( lane_idx ) );
+                           } };
+
+    std::array lanes { load_lane( 0 ), load_lane( 1 ), load_lane( 2 ), load_lane( 3 ) };
+    lanes[ 0 ] = _mm_xor_si128( lanes[ 0 ], _mm_cvtsi32_si128( static_cast<int>( state ) ) );
+
+    const auto fold_by_4_constants { _mm_set_epi64x( static_cast<long long>( fold_by_4_high_constant ),
+                                                     static_cast<long long>( fold_by_4_low_constant ) ) };
+
+    for ( auto block_idx { 1uz }; block_idx < block_count; ++block_idx )
+    {
+        for ( auto lane_idx { 0uz }; lane_idx < std::size( lanes ); ++lane_idx )
+        {
+            lanes[ lane_idx ] = _mm_xor_si128( fold_lane( lanes[ lane_idx ], fold_by_4_constants ),
+                                               load_lane( block_idx * std::size( lanes ) + lane_idx ) );
+        }
+    }
+
+    const auto fold_by_1_constants { _mm_set_epi64x( static_cast<long long>( fold_by_1_high_constant ),
+                                                     static_cast<long long>( fold_by_1_low_constant ) ) };
+
+    auto lane { lanes[ 0 ] };
+
+    for ( auto lane_idx { 1uz }; lane_idx < std::size( lanes ); ++lane_idx )
+    {
+        lane = _mm_xor_si128( fold_lane( lane, fold_by_1_constants ), lanes[ lane_idx ] );
+    }
+
+    // The last lane leaves the same remainder as the whole run of blocks, so running it
+    // through the tables from a zero state yields the state after the blocks.
+    std::array<std::byte, sizeof( __m128i )> lane_bytes;
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( std::data( lane_bytes ) ), lane );
+
+    state = Crc<32>::update( 0, lane_bytes );
+}
+
+[[ nodiscard ]] bool
+is_clmul_supported( ) noexcept
+{
+    static const bool is_supported { [ ]
+                                     {
+                                         __builtin_cpu_init( );
+                                         return __builtin_cpu_supports( "pclmul" ) &&
+                                                __builtin_cpu_supports( "sse4.1" );
+                                     }( ) };
+
+    return is_supported;
+}
+
+#endif
+
+}
+
+
+[[ nodiscard ]] bool
+update_crc32_clmul( [[ maybe_unused ]] uint32_t& state,
+                    [[ maybe_unused ]] const std::span<const std::byte> bytes ) noexcept
+{
+#if SNS_CLMUL_CRC32 == 1
+    const auto block_count { std::size( bytes ) / block_byte_count };
+
+    if ( block_count == 0 || is_clmul_supported( ) == false )
+    {
+        return false;
+    }
+
+    fold_crc32_clmul( state, std::data( bytes ), block_count );
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+}
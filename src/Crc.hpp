@@ -0,0 +1,208 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace simple_network_simulation::util
+{
+
+template <std::size_t Width>
+struct crc_parameters_t;
+
+// CRC-8/ROHC
+template <>
+struct crc_parameters_t<8>
+{
+    using value_type = std::uint8_t;
+
+    static constexpr value_type reflected_polynomial { 0xE0 };
+    static constexpr value_type initial_value { 0xFF };
+    static constexpr value_type final_xor_value { 0x00 };
+    static constexpr std::string_view name { "crc8" };
+};
+
+// CRC-16/KERMIT, i.e. the CCITT polynomial taken least significant bit first.
+template <>
+struct crc_parameters_t<16>
+{
+    using value_type = std::uint16_t;
+
+    static constexpr value_type reflected_polynomial { 0x8408 };
+    static constexpr value_type initial_value { 0x0000 };
+    static constexpr value_type final_xor_value { 0x0000 };
+    static constexpr std::string_view name { "crc16" };
+};
+
+// CRC-32/ISO-HDLC, the one of Ethernet and zlib.
+template <>
+struct crc_parameters_t<32>
+{
+    using value_type = std::uint32_t;
+
+    static constexpr value_type reflected_polynomial { 0xEDB8'8320 };
+    static constexpr value_type initial_value { 0xFFFF'FFFF };
+    static constexpr value_type final_xor_value { 0xFFFF'FFFF };
+    static constexpr std::string_view name { "crc32" };
+};
+
+// Folds a buffer into a CRC-32 state with carry-less multiplications, 64 bytes at a
+// time. Only worth it for buffers of a few hundred bytes and more, and only available
+// on CPUs with PCLMULQDQ; returns false without touching the state otherwise.
+[[ nodiscard ]] bool
+update_crc32_clmul( std::uint32_t& state, const std::span<const std::byte> bytes ) noexcept;
+
+// A reflected CRC of the given width, computed slicing-by-8: a table per byte position
+// within an 8-byte word lets the bytes of the word be folded in independently of each
+// other instead of one after the other through a single table.
+template <std::size_t Width>
+class Crc
+{
+public:
+    using parameters = crc_parameters_t<Width>;
+    using value_type = typename parameters::value_type;
+
+    static constexpr auto width { Width };
+    static constexpr auto slice_count { 8uz };
+    static constexpr auto name { parameters::name };
+
+    // Below this size the tables beat the carry-less multiplications.
+    static constexpr auto clmul_min_byte_count { 256uz };
+
+    [[ nodiscard ]] static constexpr value_type
+    compute( const std::span<const std::byte> bytes ) noexcept
+    {
+        return static_cast<value_type>( update( parameters::initial_value, bytes ) ^ parameters::final_xor_value );
+    }
+
+    // The CRC of the byte_count lowest bytes of a word, taken least significant first.
+    [[ nodiscard ]] static constexpr value_type
+    compute( const std::uint64_t word, const std::size_t byte_count ) noexcept
+    {
+        return static_cast<value_type>( update( parameters::initial_value, word, byte_count ) ^
+                                        parameters::final_xor_value );
+    }
+
+    [[ nodiscard ]] static constexpr value_type
+    update( value_type state, std::span<const std::byte> bytes ) noexcept
+    {
+        if constexpr ( Width == 32 )
+        {
+            if !consteval
+            {
+                if ( std::size( bytes ) >= clmul_min_byte_count && update_crc32_clmul( state, bytes ) )
+                {
+                    // The multiplications leave over whatever is not a multiple of 64 bytes.
+                    bytes = bytes.last( std::size( bytes ) % 64 );
+                }
+            }
+        }
+
+        for ( ; std::size( bytes ) >= slice_count; bytes = bytes.subspan( slice_count ) )
+        {
+            state = update<slice_count>( state, load_word<slice_count>( std::data( bytes ) ) );
+        }
+
+        return update( state, load_word( bytes ), std::size( bytes ) );
+    }
+
+    // Folds the byte_count ( <= 8 ) lowest bytes of a word into the state at once.
+    [[ nodiscard ]] static constexpr value_type
+    update( const value_type state, const std::uint64_t word, const std::size_t byte_count ) noexcept
+    {
+        switch ( byte_count )
+        {
+        case 0 : return state;
+        case 1 : return update<1>( state, word );
+        case 2 : return update<2>( state, word );
+        case 3 : return update<3>( state, word );
+        case 4 : return update<4>( state, word );
+        case 5 : return update<5>( state, word );
+        case 6 : return update<6>( state, word );
+        case 7 : return update<7>( state, word );
+        default : return update<8>( state, word );
+        }
+    }
+
+    template <std::size_t ByteCount>
+        requires ( ByteCount >= 1 && ByteCount <= slice_count )
+    [[ nodiscard ]] static constexpr value_type
+    update( const value_type state, const std::uint64_t word ) noexcept
+    {
+        const auto bits { word ^ state };
+        auto next_state { ByteCount * 8 < Width ? std::uint64_t { state } >> ( ByteCount * 8 % 64 ) : 0 };
+
+        [ & ]< std::size_t... ByteIdx >( std::index_sequence<ByteIdx...> )
+        {
+            ( ( next_state ^= tables[ ByteCount - 1 - ByteIdx ][ ( bits >> ( ByteIdx * 8 ) ) & 0xFF ] ), ... );
+        }( std::make_index_sequence<ByteCount> { } );
+
+        return static_cast<value_type>( next_state );
+    }
+
+private:
+    using tables_t = std::array<std::array<value_type, 256>, slice_count>;
+
+    // tables[ k ][ b ] is the state that byte b leaves behind when followed by k zero bytes.
+    [[ nodiscard ]] static consteval tables_t
+    make_tables( ) noexcept
+    {
+        tables_t result { };
+
+        for ( auto byte_value { 0u }; byte_value < 256; ++byte_value )
+        {
+            auto state { byte_value };
+
+            for ( auto bit_idx { 0uz }; bit_idx < 8; ++bit_idx )
+            {
+                state = ( state & 1u ) != 0 ? ( state >> 1 ) ^ parameters::reflected_polynomial : state >> 1;
+            }
+
+            result[ 0 ][ byte_value ] = static_cast<value_type>( state );
+        }
+
+        for ( auto table_idx { 1uz }; table_idx < slice_count; ++table_idx )
+        {
+            for ( auto byte_value { 0uz }; byte_value < 256; ++byte_value )
+            {
+                const auto previous { std::uint32_t { result[ table_idx - 1 ][ byte_value ] } };
+                const auto shifted { Width > 8 ? previous >> 8 : 0u };
+                result[ table_idx ][ byte_value ] = static_cast<value_type>( shifted ^ result[ 0 ][ previous & 0xFF ] );
+            }
+        }
+
+        return result;
+    }
+
+    [[ nodiscard ]] static constexpr std::uint64_t
+    load_word( const std::span<const std::byte> bytes ) noexcept
+    {
+        std::uint64_t word { };
+
+        for ( auto byte_idx { 0uz }; byte_idx < std::size( bytes ); ++byte_idx )
+        {
+            word |= std::uint64_t { std::to_integer<std::uint8_t>( bytes[ byte_idx ] ) } << ( byte_idx * 8 );
+        }
+
+        return word;
+    }
+
+    template <std::size_t ByteCount>
+    [[ nodiscard ]] static constexpr std::uint64_t
+    load_word( const std::byte* const bytes ) noexcept
+    {
+        return [ bytes ]< std::size_t... ByteIdx >( std::index_sequence<ByteIdx...> )
+               {
+                   return ( ( std::uint64_t { std::to_integer<std::uint8_t>( bytes[ ByteIdx ] ) } << ( ByteIdx * 8 ) ) |
+                            ... );
+               }( std::make_index_sequence<ByteCount> { } );
+    }
+
+    static constexpr tables_t tables { make_tables( ) };
+};
+
+}
@@ -0,0 +1,236 @@
+#include "EventCounters.hpp"
+#include <algorithm>
+#include <array>
+#include <new>
+
+
+using std::uint64_t;
+using std::size_t;
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+// The shards of all the threads that have ever counted, which are never freed, so that a
+// reader can walk the list without taking a lock.
+constinit std::atomic<event_counter_shard_t*> event_counter_shards { };
+
+// Hands the shard of a thread over to the next thread that starts counting once the
+// former exits, so that there are no more shards than threads running at once.
+class EventCounterShardLease
+{
+public:
+    explicit
+    EventCounterShardLease( event_counter_shard_t& shard ) noexcept
+        : m_shard { &shard }
+    {
+    }
+
+    EventCounterShardLease( const EventCounterShardLease& ) = delete;
+    EventCounterShardLease& operator=( const EventCounterShardLease& ) = delete;
+
+    ~EventCounterShardLease( )
+    {
+        this_thread_event_counter_shard = nullptr;
+        m_shard->is_in_use.store( false, std::memory_order_release );
+    }
+
+private:
+    event_counter_shard_t* m_shard;
+};
+
+[[ nodiscard ]] event_counter_shard_t&
+claim_event_counter_shard( )
+{
+    for ( auto* shard { event_counter_shards.load( std::memory_order_acquire ) }; shard != nullptr; shard = shard->next )
+    {
+        if ( bool expected { false };
+             shard->is_in_use.compare_exchange_strong( expected, true, std::memory_order_acquire ) )
+        {
+            return *shard;
+        }
+    }
+
+    auto* const shard { new event_counter_shard_t { } };
+    shard->is_in_use.store( true, std::memory_order_relaxed );
+    shard->next = event_counter_shards.load( std::memory_order_relaxed );
+
+    while ( event_counter_shards.compare_exchange_weak( shard->next, shard, std::memory_order_release,
+                                                        std::memory_order_relaxed ) == false ) { }
+
+    return *shard;
+}
+
+template <class Counters>
+[[ nodiscard ]] counter_chunk_t<Counters>*
+allocate_chunk( counter_chunks_t<Counters>& chunks, const size_t chunk_idx ) noexcept
+{
+    auto* const chunk { new ( std::nothrow ) counter_chunk_t<Counters> { } };
+
+    if ( chunk != nullptr )
+    {
+        chunks[ chunk_idx ].store( chunk, std::memory_order_release );
+    }
+
+    return chunk;
+}
+
+// Sums the counters at the same index in the chunks of every shard into counts_OUT, by
+// way of add( counts, counters ).
+template <class Counters, class Counts, class Add>
+void
+sum_counter_chunks( counter_chunks_t<Counters> event_counter_shard_t::* const chunks_member,
+                    const std::span<Counts> counts_OUT, Add&& add ) noexcept
+{
+    std::ranges::fill( counts_OUT, Counts { } );
+
+    const auto counted_count { std::min( std::size( counts_OUT ), counters_per_chunk * max_counter_chunk_count ) };
+
+    for ( auto* shard { event_counter_shards.load( std::memory_order_acquire ) }; shard != nullptr; shard = shard->next )
+    {
+        const auto& chunks { shard->*chunks_member };
+
+        for ( auto first_idx { 0uz }; first_idx < counted_count; first_idx += counters_per_chunk )
+        {
+            const auto* const chunk { chunks[ first_idx / counters_per_chunk ].load( std::memory_order_acquire ) };
+
+            if ( chunk == nullptr )
+            {
+                continue;
+            }
+
+            const auto chunk_count { std::min( counters_per_chunk, counted_count - first_idx ) };
+
+            for ( auto idx { 0uz }; idx < chunk_count; ++idx )
+            {
+                add( counts_OUT[ first_idx + idx ], chunk->counters[ idx ] );
+            }
+        }
+    }
+}
+
+}
+
+
+[[ nodiscard ]] event_counter_shard_t&
+acquire_event_counter_shard( )
+{
+    auto& shard { claim_event_counter_shard( ) };
+
+    thread_local const EventCounterShardLease lease { shard };
+
+    return shard;
+}
+
+[[ nodiscard ]] counter_chunk_t<process_message_counters_t>*
+allocate_counter_chunk( counter_chunks_t<process_message_counters_t>& chunks, const size_t chunk_idx ) noexcept
+{
+    return allocate_chunk( chunks, chunk_idx );
+}
+
+[[ nodiscard ]] counter_chunk_t<connection_counters_t>*
+allocate_counter_chunk( counter_chunks_t<connection_counters_t>& chunks, const size_t chunk_idx ) noexcept
+{
+    return allocate_chunk( chunks, chunk_idx );
+}
+
+[[ nodiscard ]] event_counts_t
+read_event_counts( ) noexcept
+{
+    std::array<uint64_t, event_counter_count> counts { };
+
+    for ( auto* shard { event_counter_shards.load( std::memory_order_acquire ) }; shard != nullptr; shard = shard->next )
+    {
+        for ( auto counter_idx { 0uz }; counter_idx < event_counter_count; ++counter_idx )
+        {
+            counts[ counter_idx ] += shard->counters[ counter_idx ].load( std::memory_order_relaxed );
+        }
+    }
+
+    const auto get_count { [ &counts ]( const event_counter_t counter )
+                           {
+                               return counts[ static_cast<size_t>( counter ) ];
+                           } };
+
+    return event_counts_t { get_count( event_counter_t::sent_messages ),
+                            get_count( event_counter_t::received_messages ),
+                            get_count( event_counter_t::sent_segments ),
+                            get_count( event_counter_t::flipped_bits ),
+                            get_count( event_counter_t::detected_corruptions ),
+                            get_count( event_counter_t::undetected_corruptions ),
+                            get_count( event_counter_t::closed_connections ),
+                            get_count( event_counter_t::application_calls ),
+                            get_count( event_counter_t::transport_to_channel_calls ),
+                            get_count( event_counter_t::channel_calls ),
+                            get_count( event_counter_t::transport_from_channel_calls ) };
+}
+
+void
+read_process_message_counts( const std::span<process_message_counts_t> counts_OUT ) noexcept
+{
+    sum_counter_chunks( &event_counter_shard_t::process_chunks, counts_OUT,
+                        [ ]( process_message_counts_t& counts, const process_message_counters_t& counters )
+                        {
+                            counts.sent_count += counters.sent_count.load( std::memory_order_relaxed );
+                            counts.received_count += counters.received_count.load( std::memory_order_relaxed );
+                        } );
+}
+
+void
+read_connection_counts( const std::span<connection_counts_t> counts_OUT ) noexcept
+{
+    sum_counter_chunks( &event_counter_shard_t::connection_chunks, counts_OUT,
+                        [ ]( connection_counts_t& counts, const connection_counters_t& counters )
+                        {
+                            counts.sent_count += counters.sent_count.load( std::memory_order_relaxed );
+                            counts.received_count += counters.received_count.load( std::memory_order_relaxed );
+                            counts.corruption_count += counters.corruption_count.load( std::memory_order_relaxed );
+                        } );
+}
+
+void
+add_event_counts( const event_counts_t& counts )
+{
+    // Indexed by event_counter_t.
+    const std::array amounts { counts.sent_message_count, counts.received_message_count, counts.sent_segment_count,
+                               counts.flipped_bit_count, counts.detected_corruption_count,
+                               counts.undetected_corruption_count, counts.closed_connection_count,
+                               counts.application_call_count, counts.transport_to_channel_call_count,
+                               counts.channel_call_count, counts.transport_from_channel_call_count };
+
+    static_assert( std::size( amounts ) == event_counter_count );
+
+    auto& shard { get_event_counter_shard( ) };
+
+    for ( auto counter_idx { 0uz }; counter_idx < event_counter_count; ++counter_idx )
+    {
+        util::add_to_counter( shard.counters[ counter_idx ], amounts[ counter_idx ] );
+    }
+}
+
+void
+add_process_message_counts( const std::span<const process_message_counts_t> counts )
+{
+    auto& shard { get_event_counter_shard( ) };
+
+    for ( auto process_idx { 0uz }; process_idx < std::size( counts ); ++process_idx )
+    {
+        const auto [ sent_count, received_count ] { counts[ process_idx ] };
+
+        // Only the processes that did count get their counters allocated.
+        if ( sent_count == 0 && received_count == 0 )
+        {
+            continue;
+        }
+
+        if ( auto* const counters { util::find_counters( shard.process_chunks, process_idx ) }; counters != nullptr )
+        {
+            util::add_to_counter( counters->sent_count, sent_count );
+            util::add_to_counter( counters->received_count, received_count );
+        }
+    }
+}
+
+}
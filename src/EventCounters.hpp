@@ -0,0 +1,239 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <span>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace simple_network_simulation
+{
+
+// The protocol events counted over the whole run, whatever the mode, for all the
+// connections together.
+enum class event_counter_t : std::uint8_t
+{
+    sent_messages,
+    received_messages,
+    sent_segments,
+    flipped_bits,
+    detected_corruptions,       // caught by the check of the segments (and corrected, if it can)
+    undetected_corruptions,     // let through by the check, as found against the segments that were sent
+    closed_connections,
+    application_calls,
+    transport_to_channel_calls,
+    channel_calls,
+    transport_from_channel_calls
+};
+
+inline constexpr auto event_counter_count { 11uz };
+
+struct process_message_counters_t
+{
+    std::atomic<std::uint64_t> sent_count;
+    std::atomic<std::uint64_t> received_count;
+};
+
+struct connection_counters_t
+{
+    std::atomic<std::uint64_t> sent_count;
+    std::atomic<std::uint64_t> received_count;
+    std::atomic<std::uint64_t> corruption_count;    // detected or not
+};
+
+// The counters of the processes and of the connections are allocated in chunks as they
+// are first counted, up to a limit beyond which they are only counted in the totals.
+inline constexpr auto counters_per_chunk { 1024uz };
+inline constexpr auto max_counter_chunk_count { 1024uz };
+
+template <class Counters>
+struct alignas( 64 ) counter_chunk_t
+{
+    std::array<Counters, counters_per_chunk> counters;
+};
+
+template <class Counters>
+using counter_chunks_t = std::array<std::atomic<counter_chunk_t<Counters>*>, max_counter_chunk_count>;
+
+// The counters of a thread, which it alone writes to (with plain loads and stores, as
+// there is no other writer to race with) and which sit on cache lines of their own, so
+// that counting an event costs about as much as incrementing a local variable. They are
+// read back at any time, without a lock, by summing the shards of all the threads. A
+// shard outlives its thread and is taken over by the next thread that starts counting.
+struct alignas( 64 ) event_counter_shard_t
+{
+    std::array<std::atomic<std::uint64_t>, event_counter_count> counters;
+    counter_chunks_t<process_message_counters_t> process_chunks;
+    counter_chunks_t<connection_counters_t> connection_chunks;
+    std::atomic<bool> is_in_use;
+    event_counter_shard_t* next;
+};
+
+inline thread_local constinit event_counter_shard_t* this_thread_event_counter_shard { };
+
+[[ nodiscard ]] event_counter_shard_t&
+acquire_event_counter_shard( );
+
+// Both return nullptr if the chunk cannot be allocated.
+[[ nodiscard ]] counter_chunk_t<process_message_counters_t>*
+allocate_counter_chunk( counter_chunks_t<process_message_counters_t>& chunks, const std::size_t chunk_idx ) noexcept;
+
+[[ nodiscard ]] counter_chunk_t<connection_counters_t>*
+allocate_counter_chunk( counter_chunks_t<connection_counters_t>& chunks, const std::size_t chunk_idx ) noexcept;
+
+namespace util
+{
+
+void inline
+add_to_counter( std::atomic<std::uint64_t>& counter, const std::uint64_t amount ) noexcept
+{
+    counter.store( counter.load( std::memory_order_relaxed ) + amount, std::memory_order_relaxed );
+}
+
+// The counters at idx in the chunks of a shard, or nullptr past the last chunk or if the
+// chunk cannot be allocated.
+template <class Counters>
+[[ nodiscard ]] Counters*
+find_counters( counter_chunks_t<Counters>& chunks, const std::size_t idx ) noexcept
+{
+    const auto chunk_idx { idx / counters_per_chunk };
+
+    if ( chunk_idx >= max_counter_chunk_count ) [[ unlikely ]]
+    {
+        return nullptr;
+    }
+
+    auto* chunk { chunks[ chunk_idx ].load( std::memory_order_relaxed ) };
+
+    if ( chunk == nullptr ) [[ unlikely ]]
+    {
+        if ( chunk = allocate_counter_chunk( chunks, chunk_idx ); chunk == nullptr )
+        {
+            return nullptr;
+        }
+    }
+
+    return &chunk->counters[ idx % counters_per_chunk ];
+}
+
+}
+
+[[ nodiscard ]] event_counter_shard_t inline&
+get_event_counter_shard( )
+{
+    if ( this_thread_event_counter_shard == nullptr ) [[ unlikely ]]
+    {
+        this_thread_event_counter_shard = &acquire_event_counter_shard( );
+    }
+
+    return *this_thread_event_counter_shard;
+}
+
+void inline
+count_event( const event_counter_t counter, const std::uint64_t amount = 1 )
+{
+    util::add_to_counter( get_event_counter_shard( ).counters[ static_cast<std::size_t>( counter ) ], amount );
+}
+
+// Counts a message sent or received by the process at process_idx in the topology over
+// the connection numbered connection_num (from 1, or 0 outside of any), along with the
+// total of the messages sent or received.
+void inline
+count_process_message( const std::uint32_t process_idx, const std::uint32_t connection_num, const bool is_received )
+{
+    auto& shard { get_event_counter_shard( ) };
+
+    util::add_to_counter( shard.counters[ static_cast<std::size_t>( is_received ? event_counter_t::received_messages
+                                                                                : event_counter_t::sent_messages ) ],
+                          1 );
+
+    if ( auto* const counters { util::find_counters( shard.process_chunks, process_idx ) }; counters != nullptr )
+    {
+        util::add_to_counter( is_received ? counters->received_count : counters->sent_count, 1 );
+    }
+
+    if ( connection_num == 0 )
+    {
+        return;
+    }
+
+    if ( auto* const counters { util::find_counters( shard.connection_chunks, connection_num - 1uz ) };
+         counters != nullptr )
+    {
+        util::add_to_counter( is_received ? counters->received_count : counters->sent_count, 1 );
+    }
+}
+
+// Counts a corruption of a segment of the connection numbered connection_num (from 1, or
+// 0 outside of any), whether or not the check caught it.
+void inline
+count_corruption( const std::uint32_t connection_num, const bool is_detected )
+{
+    auto& shard { get_event_counter_shard( ) };
+
+    util::add_to_counter( shard.counters[ static_cast<std::size_t>( is_detected ? event_counter_t::detected_corruptions
+                                                                                : event_counter_t::undetected_corruptions ) ],
+                          1 );
+
+    if ( connection_num == 0 )
+    {
+        return;
+    }
+
+    if ( auto* const counters { util::find_counters( shard.connection_chunks, connection_num - 1uz ) };
+         counters != nullptr )
+    {
+        util::add_to_counter( counters->corruption_count, 1 );
+    }
+}
+
+struct [[ nodiscard ]] event_counts_t
+{
+    std::uint64_t sent_message_count;
+    std::uint64_t received_message_count;
+    std::uint64_t sent_segment_count;
+    std::uint64_t flipped_bit_count;
+    std::uint64_t detected_corruption_count;
+    std::uint64_t undetected_corruption_count;
+    std::uint64_t closed_connection_count;
+    std::uint64_t application_call_count;
+    std::uint64_t transport_to_channel_call_count;
+    std::uint64_t channel_call_count;
+    std::uint64_t transport_from_channel_call_count;
+};
+
+struct [[ nodiscard ]] process_message_counts_t
+{
+    std::uint64_t sent_count;
+    std::uint64_t received_count;
+};
+
+struct [[ nodiscard ]] connection_counts_t
+{
+    std::uint64_t sent_count;
+    std::uint64_t received_count;
+    std::uint64_t corruption_count;
+};
+
+// Sums the counters of every thread so far; may be called at any time from any thread.
+[[ nodiscard ]] event_counts_t
+read_event_counts( ) noexcept;
+
+// Writes the message counts of the processes from index 0 onwards to counts_OUT.
+void
+read_process_message_counts( const std::span<process_message_counts_t> counts_OUT ) noexcept;
+
+// Writes the counts of the connections from number 1 onwards to counts_OUT.
+void
+read_connection_counts( const std::span<connection_counts_t> counts_OUT ) noexcept;
+
+// Adds counts that were made elsewhere, such as in another OS process, to those of the
+// calling thread: the totals, and the message counts of the processes from index 0 onwards.
+void
+add_event_counts( const event_counts_t& counts );
+
+void
+add_process_message_counts( const std::span<const process_message_counts_t> counts );
+
+}
@@ -0,0 +1,91 @@
+#include "EventScheduler.hpp"
+#include <algorithm>
+#include <utility>
+
+
+namespace simple_network_simulation::des
+{
+
+namespace
+{
+
+thread_local constinit simulation_clock::time_point current_simulated_time { };
+
+}
+
+
+[[ nodiscard ]] simulation_clock::time_point
+simulation_clock::now( ) noexcept
+{
+    return current_simulated_time;
+}
+
+void
+simulation_clock::advance( const duration elapsed_time ) noexcept
+{
+    current_simulated_time += elapsed_time;
+}
+
+void
+simulation_clock::reset( const time_point time ) noexcept
+{
+    current_simulated_time = time;
+}
+
+// The heap algorithms of libstdc++ do signed iterator arithmetic that GCC assumes does not
+// overflow, and report it under -Wstrict-overflow.
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wstrict-overflow"
+#endif
+
+void
+EventScheduler::schedule_at( const time_point time, action_type&& action )
+{
+    m_events.emplace_back( time, m_next_sequence_num++, std::move( action ) );
+    std::ranges::push_heap( m_events, is_later { } );
+}
+
+void
+EventScheduler::schedule_after( const duration delay, action_type&& action )
+{
+    schedule_at( clock::now( ) + delay, std::move( action ) );
+}
+
+std::size_t
+EventScheduler::run( )
+{
+    auto dispatched_events_count { 0uz };
+
+    while ( std::empty( m_events ) == false )
+    {
+        std::ranges::pop_heap( m_events, is_later { } );
+        event_t event { std::move( m_events.back( ) ) };
+        m_events.pop_back( );
+
+        clock::reset( event.time );
+        event.action( );
+
+        ++dispatched_events_count;
+    }
+
+    return dispatched_events_count;
+}
+
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic pop
+#endif
+
+[[ nodiscard ]] bool
+EventScheduler::empty( ) const noexcept
+{
+    return std::empty( m_events );
+}
+
+[[ nodiscard ]] std::size_t
+EventScheduler::size( ) const noexcept
+{
+    return std::size( m_events );
+}
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <ratio>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace simple_network_simulation::des
+{
+
+// The clock of the simulated world. Every thread owns its own timeline which the
+// layers advance instead of sleeping, and which an EventScheduler running on that
+// thread moves forward to the time of each event it dispatches.
+struct simulation_clock
+{
+    using rep        = std::int64_t;
+    using period     = std::micro;
+    using duration   = std::chrono::duration<rep, period>;
+    using time_point = std::chrono::time_point<simulation_clock>;
+
+    static constexpr bool is_steady { true };
+
+    [[ nodiscard ]] static time_point
+    now( ) noexcept;
+
+    static void
+    advance( const duration elapsed_time ) noexcept;
+
+    static void
+    reset( const time_point time = time_point { } ) noexcept;
+};
+
+class EventScheduler
+{
+public:
+    using clock       = simulation_clock;
+    using duration    = clock::duration;
+    using time_point  = clock::time_point;
+    using action_type = std::move_only_function<void ( )>;
+
+    void
+    schedule_at( const time_point time, action_type&& action );
+
+    void
+    schedule_after( const duration delay, action_type&& action );
+
+    // Dispatches the events in the order of their simulated time (and in the order
+    // of their scheduling for equal times) until no event is left. Actions may
+    // schedule further events. Returns the number of dispatched events.
+    std::size_t
+    run( );
+
+    [[ nodiscard ]] bool
+    empty( ) const noexcept;
+
+    [[ nodiscard ]] std::size_t
+    size( ) const noexcept;
+
+private:
+    struct event_t
+    {
+        time_point time;
+        std::uint64_t sequence_num;
+        action_type action;
+    };
+
+    struct is_later
+    {
+        [[ nodiscard ]] bool
+        operator( )( const event_t& lhs, const event_t& rhs ) const noexcept
+        {
+            return lhs.time != rhs.time ? lhs.time > rhs.time : lhs.sequence_num > rhs.sequence_num;
+        }
+    };
+
+    std::vector<event_t> m_events;
+    std::uint64_t m_next_sequence_num { };
+};
+
+}
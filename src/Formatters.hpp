@@ -1,9 +1,9 @@
-
 #pragma once
 
 #include <bitset>
 #include <cstddef>
 #include <fmt/core.h>
+#include "BidirectionalMultimessageSimulation.hpp"
 
 
 template < std::size_t N >
@@ -19,3 +19,25 @@ struct fmt::formatter< std::bitset<N> >
         return fmt::format_to( ctx.out( ), "{}", value.to_string( ) );
     }
 };
+
+template <>
+struct fmt::formatter< simple_network_simulation::payload_t > : fmt::formatter< std::bitset<
+                                                                    simple_network_simulation::payload_bit_count > >
+{
+    auto format( const simple_network_simulation::payload_t value, fmt::format_context& ctx ) const
+    {
+        return fmt::formatter< std::bitset<simple_network_simulation::payload_bit_count> >::format(
+            value.to_bitset( ), ctx );
+    }
+};
+
+template <>
+struct fmt::formatter< simple_network_simulation::segment_t > : fmt::formatter< std::bitset<
+                                                                    simple_network_simulation::segment_bit_count > >
+{
+    auto format( const simple_network_simulation::segment_t value, fmt::format_context& ctx ) const
+    {
+        return fmt::formatter< std::bitset<simple_network_simulation::segment_bit_count> >::format(
+            value.to_bitset( ), ctx );
+    }
+};
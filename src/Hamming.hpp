@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace simple_network_simulation::util
+{
+
+struct [[ nodiscard ]] hamming_correction_t
+{
+    std::uint64_t error_mask;
+    bool is_correctable;
+};
+
+// An extended Hamming code (SECDED) in systematic form: the data bits stay where they
+// are and are followed by the Hamming bits and an overall parity bit. Each data bit is
+// assigned a distinct column, i.e. a value of the Hamming bits that is not a power of
+// two, so that a single flipped bit leaves behind a syndrome naming it while the overall
+// parity tells a single error from a double one. Both the check bits and the syndrome
+// are looked up in tables, a byte of data at a time.
+template <std::size_t DataBitCount>
+class ExtendedHammingCode
+{
+public:
+    static_assert( DataBitCount >= 1 && DataBitCount <= 32 );
+
+    static constexpr auto data_bit_count { DataBitCount };
+    static constexpr auto hamming_bit_count { [ ]
+                                              {
+                                                  auto bit_count { 2uz };
+
+                                                  while ( ( 1uz << bit_count ) < DataBitCount + bit_count + 1 )
+                                                  {
+                                                      ++bit_count;
+                                                  }
+
+                                                  return bit_count;
+                                              }( ) };
+    static constexpr auto check_bit_count { hamming_bit_count + 1 };
+    static constexpr auto codeword_bit_count { data_bit_count + check_bit_count };
+    static constexpr std::string_view name { "secded" };
+
+    // The Hamming bits of a data word, followed by the bit that makes the parity of the
+    // whole codeword even.
+    [[ nodiscard ]] static constexpr std::uint32_t
+    compute( const std::uint32_t data_bits ) noexcept
+    {
+        auto check_bits { 0u };
+
+        for ( auto byte_idx { 0uz }; byte_idx < data_byte_count; ++byte_idx )
+        {
+            check_bits ^= byte_tables[ byte_idx ][ ( data_bits >> ( byte_idx * 8 ) ) & 0xFF ];
+        }
+
+        return check_bits;
+    }
+
+    // Locates the flipped bit of a codeword whose data bits come first. Two flipped bits
+    // are only detected, and three or more may be mistaken for a single one.
+    [[ nodiscard ]] static constexpr hamming_correction_t
+    correct( const std::uint64_t codeword ) noexcept
+    {
+        const auto data_bits { static_cast<std::uint32_t>( codeword & data_bit_mask ) };
+        const auto stored_check_bits { static_cast<std::uint32_t>( codeword >> data_bit_count ) & check_bit_mask };
+        const auto syndrome { stored_check_bits ^ compute( data_bits ) };
+
+        if ( syndrome == 0 )
+        {
+            return hamming_correction_t { 0, true };
+        }
+
+        const auto bit_num { syndrome_table[ syndrome ] };
+
+        return bit_num == 0 ? hamming_correction_t { 0, false }
+                            : hamming_correction_t { std::uint64_t { 1 } << ( bit_num - 1 ), true };
+    }
+
+private:
+    static constexpr auto data_bit_mask { ( std::uint64_t { 1 } << data_bit_count ) - 1 };
+    static constexpr auto check_bit_mask { ( 1u << check_bit_count ) - 1 };
+    static constexpr auto data_byte_count { ( data_bit_count + 7 ) / 8 };
+
+    using columns_t = std::array<std::uint32_t, data_bit_count>;
+    using byte_tables_t = std::array<std::array<std::uint8_t, 256>, data_byte_count>;
+    using syndrome_table_t = std::array<std::uint8_t, 1uz << check_bit_count>;
+
+    // The column of a data bit, extended with the overall parity bit that it flips: its
+    // own and that of the Hamming bits it feeds.
+    [[ nodiscard ]] static consteval columns_t
+    make_columns( ) noexcept
+    {
+        columns_t result { };
+        auto column { 3u };
+
+        for ( auto& data_bit_column : result )
+        {
+            while ( std::has_single_bit( column ) )
+            {
+                ++column;
+            }
+
+            const auto parity_bit { static_cast<std::uint32_t>( std::popcount( column ) + 1 ) & 1u };
+            data_bit_column = column++ | ( parity_bit << hamming_bit_count );
+        }
+
+        return result;
+    }
+
+    // byte_tables[ k ][ b ] holds the check bits of byte b at byte position k, which are
+    // linear in the data, so those of a word are the XOR of those of its bytes.
+    [[ nodiscard ]] static consteval byte_tables_t
+    make_byte_tables( ) noexcept
+    {
+        byte_tables_t result { };
+
+        for ( auto bit_idx { 0uz }; bit_idx < data_bit_count; ++bit_idx )
+        {
+            for ( auto byte_value { 0uz }; byte_value < 256; ++byte_value )
+            {
+                if ( ( ( byte_value >> ( bit_idx % 8 ) ) & 1 ) != 0 )
+                {
+                    result[ bit_idx / 8 ][ byte_value ] ^= static_cast<std::uint8_t>( columns[ bit_idx ] );
+                }
+            }
+        }
+
+        return result;
+    }
+
+    // Maps a syndrome to the number ( 1-based ) of the codeword bit that flipping leaves
+    // it behind, or to 0 if no single flipped bit does.
+    [[ nodiscard ]] static consteval syndrome_table_t
+    make_syndrome_table( ) noexcept
+    {
+        syndrome_table_t result { };
+
+        for ( auto bit_idx { 0uz }; bit_idx < data_bit_count; ++bit_idx )
+        {
+            result[ columns[ bit_idx ] ] = static_cast<std::uint8_t>( bit_idx + 1 );
+        }
+
+        // A flipped check bit shows up as itself.
+        for ( auto bit_idx { 0uz }; bit_idx < check_bit_count; ++bit_idx )
+        {
+            result[ 1uz << bit_idx ] = static_cast<std::uint8_t>( data_bit_count + bit_idx + 1 );
+        }
+
+        return result;
+    }
+
+    static_assert( check_bit_count <= 8, "the check bits are looked up as bytes" );
+
+    static constexpr columns_t columns { make_columns( ) };
+    static constexpr byte_tables_t byte_tables { make_byte_tables( ) };
+    static constexpr syndrome_table_t syndrome_table { make_syndrome_table( ) };
+};
+
+}
@@ -0,0 +1,269 @@
+#include "LatencyHistogram.hpp"
+#include <memory>
+#include <mutex>
+#include <cmath>
+
+
+using std::uint32_t;
+using std::uint64_t;
+using std::size_t;
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+using std::string_view_literals::operator""sv;
+
+// Indexed by latency_layer_t.
+constexpr std::array latency_layer_names { "application"sv, "transport to channel"sv, "channel"sv,
+                                           "transport from channel"sv };
+
+constexpr std::array reported_percentiles { 50.0, 90.0, 99.0, 99.9 };
+
+using layer_histograms_t = std::array<util::LatencyHistogram, latency_layer_count>;
+
+// The histograms of each connection, by its number less one, allocated the first time it
+// records into them and never freed. A connection has a single set whichever threads
+// execute it, as it runs on one thread at a time and each stage of a pipeline calls into
+// a single layer, so that no histogram is ever updated by two threads at once. The calls
+// of the connections past the last chunk only count towards the layers.
+constexpr auto histograms_per_chunk { 1024uz };
+constexpr auto max_histogram_chunk_count { 1024uz };
+
+struct histogram_chunk_t
+{
+    std::array<std::atomic<layer_histograms_t*>, histograms_per_chunk> connections;
+};
+
+constinit std::array<std::atomic<histogram_chunk_t*>, max_histogram_chunk_count> connection_histogram_chunks { };
+
+// The registry owns the histograms of the layers, for all the connections together, of
+// every thread, so that they survive the threads that recorded into them until the report
+// merges them. They are the only ones that are read while the threads record. The mutex
+// also serializes the allocation of the histograms of the connections.
+constinit std::mutex registry_mutex { };
+constinit std::vector<std::unique_ptr<layer_histograms_t>> registry { };
+
+thread_local constinit layer_histograms_t* this_thread_histograms { };
+
+[[ nodiscard ]] layer_histograms_t&
+register_thread_histograms( )
+{
+    const std::lock_guard lock { registry_mutex };
+
+    return *registry.emplace_back( std::make_unique<layer_histograms_t>( ) );
+}
+
+// Loads the pointer in slot, or allocates what it points to if it is the first to get there.
+template <class T>
+[[ nodiscard ]] T&
+get_or_allocate( std::atomic<T*>& slot )
+{
+    if ( auto* const value { slot.load( std::memory_order_acquire ) }; value != nullptr ) [[ likely ]]
+    {
+        return *value;
+    }
+
+    const std::lock_guard lock { registry_mutex };
+    auto* value { slot.load( std::memory_order_relaxed ) };
+
+    if ( value == nullptr )
+    {
+        value = new T { };
+        slot.store( value, std::memory_order_release );
+    }
+
+    return *value;
+}
+
+// Returns nullptr for the connections past the last chunk.
+[[ nodiscard ]] layer_histograms_t*
+find_connection_histograms( const uint32_t connection_num )
+{
+    const auto connection_idx { connection_num - 1uz };
+    const auto chunk_idx { connection_idx / histograms_per_chunk };
+
+    if ( chunk_idx >= max_histogram_chunk_count ) [[ unlikely ]]
+    {
+        return nullptr;
+    }
+
+    auto& chunk { get_or_allocate( connection_histogram_chunks[ chunk_idx ] ) };
+
+    return &get_or_allocate( chunk.connections[ connection_idx % histograms_per_chunk ] );
+}
+
+[[ nodiscard ]] layer_latency_summary_t
+summarize( const util::LatencyHistogram& histogram, const latency_layer_t layer, const uint32_t connection_num )
+{
+    const auto get_percentile { [ &histogram ]( const size_t percentile_idx )
+                                {
+                                    return std::chrono::nanoseconds { histogram.get_value_at_percentile(
+                                                                          reported_percentiles[ percentile_idx ] ) };
+                                } };
+
+    return layer_latency_summary_t { layer, connection_num, histogram.get_count( ),
+                                     get_percentile( 0 ), get_percentile( 1 ), get_percentile( 2 ), get_percentile( 3 ),
+                                     std::chrono::nanoseconds { histogram.get_max( ) } };
+}
+
+}
+
+
+void
+util::LatencyHistogram::merge( const LatencyHistogram& rhs ) noexcept
+{
+    for ( auto bucket_idx { 0uz }; bucket_idx < bucket_count; ++bucket_idx )
+    {
+        m_counts[ bucket_idx ] += load( rhs.m_counts[ bucket_idx ] );
+    }
+
+    m_count += load( rhs.m_count );
+    m_max = std::max( m_max, load( rhs.m_max ) );
+}
+
+[[ nodiscard ]] uint64_t
+util::LatencyHistogram::get_value_at_percentile( const double percentile ) const noexcept
+{
+    if ( m_count == 0 )
+    {
+        return 0;
+    }
+
+    const auto rank { std::max( uint64_t { 1 },
+                                static_cast<uint64_t>( std::ceil( std::clamp( percentile, 0.0, 100.0 ) / 100.0 *
+                                                                  static_cast<double>( m_count ) ) ) ) };
+    auto cumulative_count { uint64_t { 0 } };
+
+    for ( auto bucket_idx { 0uz }; bucket_idx < bucket_count; ++bucket_idx )
+    {
+        cumulative_count += m_counts[ bucket_idx ];
+
+        if ( cumulative_count >= rank )
+        {
+            return std::min( get_bucket_highest_value( bucket_idx ), m_max );
+        }
+    }
+
+    return m_max;
+}
+
+[[ nodiscard ]] std::string_view
+get_latency_layer_name( const latency_layer_t layer ) noexcept
+{
+    const auto layer_idx { static_cast<size_t>( layer ) };
+
+    return layer_idx < std::size( latency_layer_names ) ? latency_layer_names[ layer_idx ] : "unknown"sv;
+}
+
+void
+record_layer_latency( const latency_layer_t layer, const uint32_t connection_num,
+                      const std::chrono::nanoseconds latency )
+{
+    if ( this_thread_histograms == nullptr ) [[ unlikely ]]
+    {
+        this_thread_histograms = &register_thread_histograms( );
+    }
+
+    const auto value { static_cast<uint64_t>( std::max( latency.count( ), decltype( latency.count( ) ) { 0 } ) ) };
+
+    ( *this_thread_histograms )[ static_cast<size_t>( layer ) ].record( value );
+
+    if ( connection_num == 0 )
+    {
+        return;
+    }
+
+    if ( auto* const histograms { find_connection_histograms( connection_num ) }; histograms != nullptr )
+    {
+        ( *histograms )[ static_cast<size_t>( layer ) ].record( value );
+    }
+}
+
+[[ nodiscard ]] latency_report_t
+collect_latency_report( )
+{
+    latency_report_t report { };
+    layer_histograms_t layers { };
+
+    {
+        const std::lock_guard lock { registry_mutex };
+
+        for ( const auto& thread_histograms : registry )
+        {
+            for ( auto layer_idx { 0uz }; layer_idx < latency_layer_count; ++layer_idx )
+            {
+                layers[ layer_idx ].merge( ( *thread_histograms )[ layer_idx ] );
+            }
+        }
+    }
+
+    for ( auto layer_idx { 0uz }; layer_idx < latency_layer_count; ++layer_idx )
+    {
+        report.layers.push_back( summarize( layers[ layer_idx ], static_cast<latency_layer_t>( layer_idx ), 0 ) );
+    }
+
+    for ( auto chunk_idx { 0uz }; chunk_idx < max_histogram_chunk_count; ++chunk_idx )
+    {
+        const auto* const chunk { connection_histogram_chunks[ chunk_idx ].load( std::memory_order_acquire ) };
+
+        if ( chunk == nullptr )
+        {
+            continue;
+        }
+
+        for ( auto histograms_idx { 0uz }; histograms_idx < histograms_per_chunk; ++histograms_idx )
+        {
+            const auto* const histograms { chunk->connections[ histograms_idx ].load( std::memory_order_acquire ) };
+
+            if ( histograms == nullptr )
+            {
+                continue;
+            }
+
+            const auto connection_num { static_cast<uint32_t>( chunk_idx * histograms_per_chunk + histograms_idx + 1 ) };
+
+            for ( auto layer_idx { 0uz }; layer_idx < latency_layer_count; ++layer_idx )
+            {
+                if ( const auto& histogram { ( *histograms )[ layer_idx ] }; histogram.get_count( ) != 0 )
+                {
+                    report.connections.push_back( summarize( histogram, static_cast<latency_layer_t>( layer_idx ),
+                                                             connection_num ) );
+                }
+            }
+        }
+    }
+
+    return report;
+}
+
+[[ nodiscard ]] std::array<layer_latency_summary_t, latency_layer_count>
+collect_live_layer_latencies( )
+{
+    layer_histograms_t layers { };
+
+    {
+        const std::lock_guard lock { registry_mutex };
+
+        for ( const auto& thread_histograms : registry )
+        {
+            for ( auto layer_idx { 0uz }; layer_idx < latency_layer_count; ++layer_idx )
+            {
+                layers[ layer_idx ].merge( ( *thread_histograms )[ layer_idx ] );
+            }
+        }
+    }
+
+    std::array<layer_latency_summary_t, latency_layer_count> summaries;
+
+    for ( auto layer_idx { 0uz }; layer_idx < latency_layer_count; ++layer_idx )
+    {
+        summaries[ layer_idx ] = summarize( layers[ layer_idx ], static_cast<latency_layer_t>( layer_idx ), 0 );
+    }
+
+    return summaries;
+}
+
+}
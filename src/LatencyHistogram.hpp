@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <string_view>
+#include <bit>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+
+// Building with -DSNS_LATENCY_HISTOGRAMS=1 times every call into a layer and reports the
+// distribution of its latencies at the end of the run. Otherwise the timers compile to
+// nothing at all.
+#ifndef SNS_LATENCY_HISTOGRAMS
+#   define SNS_LATENCY_HISTOGRAMS 0
+#endif
+
+namespace simple_network_simulation
+{
+
+namespace util
+{
+
+// A histogram of latencies in nanoseconds laid out like an HdrHistogram: each power of two
+// is split into as many linear sub-buckets, so that a value is recorded with a relative
+// error below 1 / sub_bucket_count whatever its magnitude, in a fixed-size array of
+// counters that takes no allocation and no more than an index computation to update.
+// The counters are updated by a single thread, with relaxed atomic stores that cost no
+// more than plain ones, so that another thread can merge them while they are updated.
+class LatencyHistogram
+{
+public:
+    static constexpr std::size_t sub_bucket_bit_count { 4 };
+    static constexpr std::size_t sub_bucket_count { 1uz << sub_bucket_bit_count };
+
+    // About 18 minutes; longer latencies land in the last bucket.
+    static constexpr std::size_t max_value_bit_count { 40 };
+    static constexpr std::size_t bucket_count { ( max_value_bit_count - sub_bucket_bit_count + 1 ) * sub_bucket_count };
+
+    void
+    record( const std::uint64_t value ) noexcept
+    {
+        increment( m_counts[ get_bucket_idx( value ) ] );
+        increment( m_count );
+
+        if ( value > m_max )
+        {
+            std::atomic_ref { m_max }.store( value, std::memory_order_relaxed );
+        }
+    }
+
+    // May run while another thread records into rhs, in which case it merges a snapshot of
+    // rhs that is at most a few values behind.
+    void
+    merge( const LatencyHistogram& rhs ) noexcept;
+
+    // The highest value that is recorded in the same bucket as the one at the percentile
+    // (between 0 and 100), or 0 if nothing was recorded.
+    [[ nodiscard ]] std::uint64_t
+    get_value_at_percentile( const double percentile ) const noexcept;
+
+    [[ nodiscard ]] std::uint64_t
+    get_count( ) const noexcept
+    {
+        return m_count;
+    }
+
+    [[ nodiscard ]] std::uint64_t
+    get_max( ) const noexcept
+    {
+        return m_max;
+    }
+
+private:
+    template <class Counter>
+    static void
+    increment( Counter& counter ) noexcept
+    {
+        const std::atomic_ref atomic_counter { counter };
+        atomic_counter.store( atomic_counter.load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+    }
+
+    // The histograms are never const objects, only seen through const references, so the
+    // const_cast does not lead to writes to a const object (atomic_ref<const T> is C++26).
+    template <class Counter>
+    [[ nodiscard ]] static Counter
+    load( const Counter& counter ) noexcept
+    {
+        return std::atomic_ref { const_cast<Counter&>( counter ) }.load( std::memory_order_relaxed );
+    }
+
+    [[ nodiscard ]] static constexpr std::size_t
+    get_bucket_idx( const std::uint64_t value ) noexcept
+    {
+        if ( value < sub_bucket_count )
+        {
+            return static_cast<std::size_t>( value );
+        }
+
+        const auto magnitude { std::min( static_cast<std::size_t>( std::bit_width( value ) ) - 1,
+                                         max_value_bit_count - 1 ) };
+        const auto shift { magnitude - sub_bucket_bit_count };
+        const auto sub_bucket_idx { std::min( static_cast<std::size_t>( value >> shift ), 2 * sub_bucket_count - 1 ) -
+                                    sub_bucket_count };
+
+        return ( shift + 1 ) * sub_bucket_count + sub_bucket_idx;
+    }
+
+    [[ nodiscard ]] static constexpr std::uint64_t
+    get_bucket_highest_value( const std::size_t bucket_idx ) noexcept
+    {
+        if ( bucket_idx < sub_bucket_count )
+        {
+            return bucket_idx;
+        }
+
+        const auto shift { bucket_idx / sub_bucket_count - 1 };
+        const auto sub_bucket_idx { bucket_idx % sub_bucket_count };
+
+        return ( ( ( sub_bucket_count + sub_bucket_idx + 1 ) << shift ) - 1 );
+    }
+
+    // Counted in 32 bits to keep the histograms of many connections within the caches; a
+    // connection does not get near 2^32 calls into a layer within a run.
+    std::array<std::uint32_t, bucket_count> m_counts { };
+    std::uint64_t m_count { };
+    std::uint64_t m_max { };
+};
+
+}
+
+enum class latency_layer_t : std::uint8_t
+{
+    application,
+    transport_to_channel,
+    channel,
+    transport_from_channel
+};
+
+inline constexpr auto latency_layer_count { 4uz };
+
+[[ nodiscard ]] std::string_view
+get_latency_layer_name( const latency_layer_t layer ) noexcept;
+
+// Records a latency into the histograms of the connection numbered connection_num (from 1,
+// or 0 outside of any) and into those of the layers of the calling thread, which are
+// updated by one thread at a time, so that the hot path takes neither a lock nor a
+// read-modify-write. The histograms are allocated the first time they are recorded into
+// and outlive the threads.
+void
+record_layer_latency( const latency_layer_t layer, const std::uint32_t connection_num,
+                      const std::chrono::nanoseconds latency );
+
+struct [[ nodiscard ]] layer_latency_summary_t
+{
+    latency_layer_t layer;
+    std::uint32_t connection_num;       // 0 for all the connections together
+    std::uint64_t call_count;
+    std::chrono::nanoseconds p50;
+    std::chrono::nanoseconds p90;
+    std::chrono::nanoseconds p99;
+    std::chrono::nanoseconds p999;
+    std::chrono::nanoseconds max;
+};
+
+struct [[ nodiscard ]] latency_report_t
+{
+    std::vector<layer_latency_summary_t> layers;
+    std::vector<layer_latency_summary_t> connections;   // by connection, then by layer
+};
+
+// Merges the histograms of the layers of every thread and summarizes those of every
+// connection. Must only be called once the threads that record into them are done.
+[[ nodiscard ]] latency_report_t
+collect_latency_report( );
+
+// Merges the histograms of the layers, for all the connections together, of every thread
+// while they go on recording into them. Indexed by latency_layer_t.
+[[ nodiscard ]] std::array<layer_latency_summary_t, latency_layer_count>
+collect_live_layer_latencies( );
+
+}
@@ -1,20 +1,33 @@
 
 #include <system_error>
+#include <chrono>
 #include <span>
 #include <thread>
 #include <exception>
 #include <functional>
+#include <algorithm>
+#include <vector>
 #include <cstdlib>
 #include <cstdio>
 #include <cstdint>
 #include <cstddef>
+#include <string_view>
 #include <spdlog/spdlog.h>
 #include <fmt/core.h>
 #include <fmt/chrono.h>
+#include "AsyncLogging.hpp"
 #include "BidirectionalMultimessageSimulation.hpp"
+#include "EventCounters.hpp"
+#include "LatencyHistogram.hpp"
+#include "ParityKernels.hpp"
+#include "ReliableTransport.hpp"
+#include "StatisticsPublisher.hpp"
+#include "Sweep.hpp"
 #include "Util.hpp"
 
 
+using simple_network_simulation::util::get_basic_logger;
+
 extern constinit int exit_code { };
 
 
@@ -28,6 +41,234 @@ register_loggers( ) noexcept;
 register_exit_handlers( ) noexcept;
 
 
+void static
+print_benchmark_report( const simple_network_simulation::benchmark_report_t& report )
+{
+    const auto& statistics { report.statistics };
+    const std::chrono::duration<double> elapsed_seconds { report.elapsed_time };
+    const auto per_second { [ &elapsed_seconds ]( const std::uint64_t count )
+                            {
+                                return static_cast<double>( count ) / elapsed_seconds.count( );
+                            } };
+    const auto caught_corruption_count { statistics.corruption_count + statistics.correction_count };
+    const auto corruption_count { caught_corruption_count + statistics.undetected_corruption_count };
+    const auto catch_rate { corruption_count == 0 ? 1.0 : static_cast<double>( caught_corruption_count ) /
+                                                          static_cast<double>( corruption_count ) };
+
+    fmt::print( "Benchmark finished in {:.3f} s\n"
+                "  connections:  {}\n"
+                "  round trips:  {}\n"
+                "  messages:     {} ({:.0f} messages/sec)\n"
+                "  segments:     {} ({:.0f} segments/sec)\n"
+                "  goodput:      {} ({:.0f} messages/sec)\n"
+                "  corruptions:  {} ({} undetected)\n"
+                "  corrections:  {}\n"
+                "  losses:       {}\n"
+                "  duplicates:   {}\n"
+                "  retransmissions: {}\n"
+                "  arq protocol: {}, window of {}\n"
+                "  seed: {}\n"
+                "  memory per connection: {} bytes\n"
+                "  segment check: {}, {:.2f} ns/segment, {:.4f}% of the corruptions caught\n"
+                "  parity kernel: {}\n\n",
+                elapsed_seconds.count( ),
+                statistics.connection_count,
+                statistics.round_trip_count,
+                statistics.message_count, per_second( statistics.message_count ),
+                statistics.segment_count, per_second( statistics.segment_count ),
+                statistics.delivered_message_count, per_second( statistics.delivered_message_count ),
+                statistics.corruption_count, statistics.undetected_corruption_count,
+                statistics.correction_count,
+                statistics.loss_count,
+                statistics.duplicate_count,
+                statistics.retransmission_count,
+                simple_network_simulation::get_arq_protocol_name( report.arq_protocol ), report.arq_window_size,
+                report.random_seed,
+                report.memory_per_connection,
+                report.segment_check_name, report.segment_check_time.count( ), catch_rate * 100.0,
+                simple_network_simulation::get_parity_kernel_name( ) );
+}
+
+// Latencies from the schedule include the time that the requests spent waiting to go out
+// behind the earlier ones, those from the send do not, and the gap between them shows how
+// far the offered load is beyond what the benchmark manages to carry.
+void static
+print_open_loop_report( const simple_network_simulation::open_loop_report_t& report )
+{
+    namespace sns = simple_network_simulation;
+
+    const std::chrono::duration<double> elapsed_seconds { report.benchmark.elapsed_time };
+    const auto& traffic_model { report.traffic_model };
+    const auto print_latencies { [ ]( const std::string_view name, const sns::open_loop_latencies_t& latencies )
+                                 {
+                                     fmt::print( "  {:<14} {:>12} {:>12} {:>12} {:>12} {:>12}\n", name,
+                                                 latencies.p50, latencies.p90, latencies.p99, latencies.p999,
+                                                 latencies.max );
+                                 } };
+
+    fmt::print( "Open-loop benchmark of {} traffic at {:.0f} requests/sec per connection\n"
+                "  offered:   {} requests ({:.0f} requests/sec for {} connections)\n"
+                "  answered:  {} requests ({:.0f} requests/sec)\n"
+                "  latency (wall clock):\n"
+                "  {:<14} {:>12} {:>12} {:>12} {:>12} {:>12}\n",
+                sns::get_traffic_pattern_name( traffic_model.pattern ), traffic_model.message_rate,
+                report.scheduled_request_count,
+                static_cast<double>( report.scheduled_request_count ) / elapsed_seconds.count( ), report.connection_count,
+                report.answered_request_count,
+                static_cast<double>( report.answered_request_count ) / elapsed_seconds.count( ),
+                "measured from", "p50", "p90", "p99", "p99.9", "max" );
+
+    print_latencies( "schedule", report.latencies_from_schedule );
+    print_latencies( "send", report.latencies_from_send );
+    fmt::print( "\n" );
+
+    print_benchmark_report( report.benchmark );
+}
+
+void static
+print_round_trip_latencies( const simple_network_simulation::connection_statistics_t& statistics )
+{
+    const std::chrono::duration<double> latency_sum { statistics.round_trip_latency_sum };
+    const std::chrono::duration<double> latency_max { statistics.round_trip_latency_max };
+    const auto round_trip_count { static_cast<double>( statistics.round_trip_count ) };
+    const auto latency_mean { round_trip_count == 0.0 ? 0.0 : latency_sum.count( ) / round_trip_count };
+
+    fmt::print( "{} round trips, round-trip latency mean {:.6f} s, max {:.6f} s\n",
+                statistics.round_trip_count, latency_mean, latency_max.count( ) );
+}
+
+void static
+print_simulation_report( const simple_network_simulation::simulation_report_t& report )
+{
+    constexpr auto max_listed_connections_count { 8uz };
+
+    const std::chrono::duration<double> simulated_seconds { report.simulated_time };
+    const std::chrono::duration<double> elapsed_seconds { report.elapsed_time };
+
+    fmt::print( "Simulated {:.6f} s in {:.6f} s of wall-clock time ({} events)\n",
+                simulated_seconds.count( ), elapsed_seconds.count( ), report.event_count );
+
+    simple_network_simulation::connection_statistics_t total_statistics { };
+
+    for ( auto connection_idx { 0uz }; const auto& statistics : report.connections )
+    {
+        total_statistics += statistics;
+
+        if ( ++connection_idx <= max_listed_connections_count )
+        {
+            fmt::print( "  connection{}: ", connection_idx );
+            print_round_trip_latencies( statistics );
+        }
+    }
+
+    fmt::print( "  all {} connections: ", std::size( report.connections ) );
+    print_round_trip_latencies( total_statistics );
+    fmt::print( "  corruptions: {} ({} undetected), corrections: {}, losses: {}, duplicates: {}, retransmissions: {}\n",
+                total_statistics.corruption_count, total_statistics.undetected_corruption_count,
+                total_statistics.correction_count, total_statistics.loss_count, total_statistics.duplicate_count,
+                total_statistics.retransmission_count );
+    fmt::print( "  seed: {}\n", report.random_seed );
+    fmt::print( "  memory per connection: {} bytes\n\n", report.memory_per_connection );
+}
+
+void static
+print_sweep_report( const simple_network_simulation::sweep_report_t& report )
+{
+    namespace sns = simple_network_simulation;
+
+    const std::chrono::duration<double> elapsed_seconds { report.elapsed_time };
+
+    fmt::print( "Sweep of {} points finished in {:.3f} s (seed {})\n\n"
+                "{:<9} {:>9} {:>6} {:>5} {:<16} {:>6} {:>6}  {:>19}  {:>21}  {:>11} {:>10} {:>9}\n",
+                std::size( report.points ), elapsed_seconds.count( ), report.random_seed,
+                "model", "p", "delays", "conns", "arq", "window", "reps", "goodput (95% CI)",
+                "round trip (s, 95% CI)", "corruptions", "undetected", "detected" );
+
+    for ( const auto& point : report.points )
+    {
+        const auto detection_rate { point.corruption_count == 0 ? 1.0 : 1.0 - static_cast<double>( point.undetected_corruption_count ) /
+                                                                           static_cast<double>( point.corruption_count ) };
+
+        fmt::print( "{:<9} {:>9.3g} {:>6} {:>5} {:<16} {:>6} {:>5}{:1}  {:>9.6f} ± {:<8.6f}  {:>10.4f} ± {:<8.4f}  {:>11} {:>10} {:>8.4f}%\n",
+                    sns::get_sweep_fault_model_name( point.fault_model ), point.fault_probability,
+                    point.are_layers_delays_enabled ? "on" : "off", point.connection_count,
+                    sns::get_arq_protocol_name( point.arq_protocol ), point.window_size,
+                    point.replication_count, point.is_converged ? "" : "*",
+                    point.goodput.mean, point.goodput.half_width,
+                    point.round_trip_latency.mean, point.round_trip_latency.half_width,
+                    point.corruption_count, point.undetected_corruption_count, detection_rate * 100.0 );
+    }
+
+    fmt::print( "\n" );
+
+    if ( std::ranges::any_of( report.points, [ ]( const auto& point ) noexcept { return point.is_converged == false; } ) )
+    {
+        fmt::print( "* stopped at the maximum number of replications before the confidence interval of the\n"
+                    "  goodput narrowed down to the target width\n\n" );
+    }
+}
+
+// Lists the processes of the topology (process_count of them, or none when the run spans
+// several topologies) after the totals.
+void static
+print_event_counts( const std::size_t process_count )
+{
+    namespace sns = simple_network_simulation;
+
+    constexpr auto max_listed_processes_count { 8uz };
+
+    const sns::event_counts_t counts { sns::read_event_counts( ) };
+
+    fmt::print( "Events: {} messages sent, {} received, {} segments sent, {} bits flipped, "
+                "{} corruptions detected, {} undetected, {} connections closed\n",
+                counts.sent_message_count, counts.received_message_count, counts.sent_segment_count,
+                counts.flipped_bit_count, counts.detected_corruption_count, counts.undetected_corruption_count,
+                counts.closed_connection_count );
+
+    std::vector<sns::process_message_counts_t> process_counts( std::min( process_count, max_listed_processes_count ) );
+    sns::read_process_message_counts( process_counts );
+
+    for ( auto process_idx { 0uz }; const auto& counts_of_process : process_counts )
+    {
+        fmt::print( "  process{}: {} messages sent, {} received\n",
+                    ++process_idx, counts_of_process.sent_count, counts_of_process.received_count );
+    }
+
+    if ( process_count > max_listed_processes_count )
+    {
+        fmt::print( "  ... and {} more processes\n", process_count - max_listed_processes_count );
+    }
+
+    fmt::print( "\n" );
+}
+
+#if SNS_LATENCY_HISTOGRAMS == 1
+void static
+print_latency_report( const simple_network_simulation::latency_report_t& report )
+{
+    namespace sns = simple_network_simulation;
+
+    fmt::print( "Latencies of the layers (wall clock):\n"
+                "{:>10}  {:<22} {:>12} {:>12} {:>12} {:>12} {:>12} {:>12}\n",
+                "connection", "layer", "calls", "p50", "p90", "p99", "p99.9", "max" );
+
+    const auto print_summary { [ ]( const sns::layer_latency_summary_t& summary )
+                               {
+                                   fmt::print( "{:>10}  {:<22} {:>12} {:>12} {:>12} {:>12} {:>12} {:>12}\n",
+                                               summary.connection_num == 0 ? "all"
+                                                                           : fmt::format( "{}", summary.connection_num ),
+                                               sns::get_latency_layer_name( summary.layer ), summary.call_count,
+                                               summary.p50, summary.p90, summary.p99, summary.p999, summary.max );
+                               } };
+
+    std::ranges::for_each( report.layers, print_summary );
+    std::ranges::for_each( report.connections, print_summary );
+
+    fmt::print( "\n" );
+}
+#endif
+
+
 void inline static
 launch( const std::span<const char* const> command_line_arguments, int& exit_code_OUT ) noexcept
 {
@@ -37,12 +278,12 @@ launch( const std::span<const char* const> command_line_arguments, int& exit_cod
         if ( init_result_code.value( ) == static_cast<int>( std::errc::operation_canceled ) ) [[ likely ]]
         {
             exit_code_OUT = EXIT_SUCCESS;
-            spdlog::get( "basic_logger" )->info( "{}", init_result_code.message( ) );
+            get_basic_logger( ).info( "{}", init_result_code.message( ) );
         }
         else [[ unlikely ]]
         {
             exit_code_OUT = EXIT_FAILURE;
-            spdlog::get( "basic_logger" )->error( "{}", init_result_code.message( ) );
+            get_basic_logger( ).error( "{}", init_result_code.message( ) );
         }
 
         return;
@@ -52,36 +293,81 @@ launch( const std::span<const char* const> command_line_arguments, int& exit_cod
     {
         namespace sns = simple_network_simulation;
 
+        const sns::topology_t topology { sns::generate_topology( ) };
+        const auto execution_mode { sns::get_execution_mode( ) };
+
+        // The points of a sweep run topologies of their own, so only their totals are published.
+        const sns::StatisticsPublisher statistics_publisher {
+            execution_mode == sns::execution_mode_t::sweep ? 0u : static_cast<std::uint32_t>( std::size( topology.connections ) ) };
+
+        if ( execution_mode != sns::execution_mode_t::interactive )
+        {
+            if ( execution_mode == sns::execution_mode_t::sweep )
+            {
+                print_sweep_report( sns::execute_sweep( ) );
+            }
+            else if ( execution_mode == sns::execution_mode_t::open_loop_benchmark )
+            {
+                print_open_loop_report( sns::execute_open_loop_benchmark( topology ) );
+            }
+            else
+            {
+                print_benchmark_report( execution_mode == sns::execution_mode_t::benchmark
+                                        ? sns::execute_benchmark( topology )
+                                        : execution_mode == sns::execution_mode_t::pipelined_benchmark
+                                        ? sns::execute_pipelined_benchmark( topology )
+                                        : sns::execute_multiprocess_benchmark( topology ) );
+            }
+
+            print_event_counts( execution_mode == sns::execution_mode_t::sweep ? 0uz : std::size( topology.processes ) );
+#if SNS_LATENCY_HISTOGRAMS == 1
+            print_latency_report( sns::collect_latency_report( ) );
+#endif
+            sns::util::flush_stdout( );
+
+            exit_code_OUT = EXIT_SUCCESS;
+
+            return;
+        }
+
         fmt::print( "\n\nConnection simulation started...\n\n\n" );
         sns::util::flush_stdout( );
 
+        if ( sns::is_running_in_virtual_time( ) )
         {
-            const std::uint32_t node1_process1_num { 5001 };
-            const std::uint32_t node1_process2_num { 5002 };
-            const std::uint32_t node2_process1_num { 7001 };
-            const std::uint32_t node2_process2_num { 7002 };
+            const sns::simulation_report_t report { sns::execute_discrete_event_simulation( topology ) };
 
-            std::jthread connection1_thread { sns::execute_connection1, node1_process1_num, node2_process2_num };
+            fmt::print( "\nConnection simulation finished...\n\n\n" );
+            print_simulation_report( report );
+        }
+        else
+        {
+            sns::execute_real_time_simulation( topology );
 
-            std::jthread connection2_thread { sns::execute_connection2, node1_process2_num, node2_process1_num };
+            fmt::print( "\nConnection simulation finished...\n\n\n" );
         }
 
-        fmt::print( "\nConnection simulation finished...\n\n\n" );
+        print_event_counts( std::size( topology.processes ) );
         sns::util::flush_stdout( );
 
+#if SNS_LATENCY_HISTOGRAMS == 1
+        print_latency_report( sns::collect_latency_report( ) );
+        sns::util::flush_stdout( );
+#endif
+
         exit_code_OUT = EXIT_SUCCESS;
     }
     catch ( const std::exception& ex )
     {
         exit_code_OUT = EXIT_FAILURE;
-        spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+        get_basic_logger( ).error( "{}", ex.what( ) );
         try
         {
             fmt::print( stderr, "\nSomething went wrong!\n\n" );
         }
         catch ( const std::exception& exc )
         {
-            spdlog::get( "basic_logger" )->error( "{}", exc.what( ) );
+            get_basic_logger( ).error( "{}", exc.what( ) );
         }
     }
 
@@ -96,7 +382,7 @@ initiate( const int argc, const char* const* const argv ) noexcept
     using simple_network_simulation::util::ScopedTimer;
     const ScopedTimer timer { [ ]( const auto duration ) noexcept
                               {
-                                  spdlog::get( "basic_logger" )->debug( "Timer took {}", duration );
+                                  get_basic_logger( ).debug( "Timer took {}", duration );
                                   try
                                   {
                                       fmt::print( stderr, "\nTimer took {}\n", duration );
@@ -104,7 +390,7 @@ initiate( const int argc, const char* const* const argv ) noexcept
                                   catch ( const std::exception& ex )
                                   {
                                       exit_code = EXIT_FAILURE;
-                                      spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+                                      get_basic_logger( ).error( "{}", ex.what( ) );
                                   }
                               } };
 #endif
@@ -132,14 +418,14 @@ initiate( const int argc, const char* const* const argv ) noexcept
     catch ( const std::exception& ex )
     {
         exit_code = EXIT_FAILURE;
-        spdlog::get( "basic_logger" )->error( "{}", ex.what( ) );
+        get_basic_logger( ).error( "{}", ex.what( ) );
         try
         {
             fmt::print( stderr, "\nSomething went wrong!\n\n" );
         }
         catch ( const std::exception& exc )
         {
-            spdlog::get( "basic_logger" )->error( "{}", exc.what( ) );
+            get_basic_logger( ).error( "{}", exc.what( ) );
         }
     }
 
@@ -0,0 +1,248 @@
+#include "ParityKernels.hpp"
+#include <array>
+#include <bit>
+#include <span>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include "BidirectionalMultimessageSimulation.hpp"
+
+
+// The vector kernels work on 16-bit lanes, i.e. on segments whose port and sequence
+// number fields take up to 6 bits next to the payload, the acknowledgement flag and a
+// parity bit; wider segments, and those protected by a CRC or a SECDED code, always
+// take the scalar path.
+#if defined( __x86_64__ ) && defined( __GNUC__ ) && 2 * SNS_PORT_NUM_BIT_COUNT + SNS_SEQUENCE_NUM_BIT_COUNT <= 6 && \
+    SNS_CRC_BIT_COUNT == 0 && SNS_SECDED == 0
+#   define SNS_SIMD_PARITY_KERNELS 1
+#   include <immintrin.h>
+#else
+#   define SNS_SIMD_PARITY_KERNELS 0
+#endif
+
+using std::uint16_t;
+using std::uint32_t;
+using std::size_t;
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+void
+generate_parity_scalar( segment_t* const segments, const size_t count ) noexcept
+{
+    for ( auto idx { 0uz }; idx < count; ++idx )
+    {
+        const auto data_bits { static_cast<segment_word_t>( segments[ idx ].bits & data_bit_mask ) };
+        segments[ idx ].bits = static_cast<segment_word_t>( data_bits | compute_segment_check_bits( data_bits ) );
+    }
+}
+
+[[ nodiscard ]] size_t
+verify_parity_scalar( const segment_t* const segments, bool* const are_intact, const size_t count ) noexcept
+{
+    auto corrupt_count { 0uz };
+
+    for ( auto idx { 0uz }; idx < count; ++idx )
+    {
+        const auto bits { segments[ idx ].bits };
+        const bool is_intact { ( bits & check_bit_mask ) == compute_segment_check_bits( bits ) };
+        are_intact[ idx ] = is_intact;
+        corrupt_count += is_intact ? 0uz : 1uz;
+    }
+
+    return corrupt_count;
+}
+
+#if SNS_SIMD_PARITY_KERNELS == 1
+
+constexpr auto parity_bit_shift { static_cast<int>( check_bit_offset ) };
+constexpr auto data_bits_mask { static_cast<short>( static_cast<segment_word_t>( ~check_bit_mask ) ) };
+
+// Folds each 16-bit lane onto its lowest bit, which ends up holding the parity of the lane.
+[[ nodiscard, gnu::target( "avx2" ) ]] __m256i
+fold_parity_avx2( __m256i lanes ) noexcept
+{
+    lanes = _mm256_xor_si256( lanes, _mm256_srli_epi16( lanes, 8 ) );
+    lanes = _mm256_xor_si256( lanes, _mm256_srli_epi16( lanes, 4 ) );
+    lanes = _mm256_xor_si256( lanes, _mm256_srli_epi16( lanes, 2 ) );
+    lanes = _mm256_xor_si256( lanes, _mm256_srli_epi16( lanes, 1 ) );
+
+    return _mm256_and_si256( lanes, _mm256_set1_epi16( 1 ) );
+}
+
+[[ gnu::target( "avx2" ) ]] void
+generate_parity_avx2( segment_t* const segments, const size_t count ) noexcept
+{
+    constexpr auto segments_per_block { sizeof( __m256i ) / sizeof( segment_t ) };
+
+    const auto data_mask { _mm256_set1_epi16( data_bits_mask ) };
+    auto idx { 0uz };
+
+    for ( ; idx + segments_per_block <= count; idx += segments_per_block )
+    {
+        auto* const block { reinterpret_cast<__m256i*>( segments + idx ) };
+        const auto data_bits { _mm256_and_si256( _mm256_loadu_si256( block ), data_mask ) };
+        const auto parity_bits { _mm256_slli_epi16( fold_parity_avx2( data_bits ), parity_bit_shift ) };
+        _mm256_storeu_si256( block, _mm256_or_si256( data_bits, parity_bits ) );
+    }
+
+    generate_parity_scalar( segments + idx, count - idx );
+}
+
+[[ nodiscard, gnu::target( "avx2" ) ]] size_t
+verify_parity_avx2( const segment_t* const segments, bool* const are_intact, const size_t count ) noexcept
+{
+    constexpr auto segments_per_block { 2 * sizeof( __m256i ) / sizeof( segment_t ) };
+
+    const auto ones { _mm256_set1_epi8( 1 ) };
+    auto corrupt_count { 0uz };
+    auto idx { 0uz };
+
+    for ( ; idx + segments_per_block <= count; idx += segments_per_block )
+    {
+        const auto* const block { reinterpret_cast<const __m256i*>( segments + idx ) };
+        const auto low_half_parities { fold_parity_avx2( _mm256_loadu_si256( block ) ) };
+        const auto high_half_parities { fold_parity_avx2( _mm256_loadu_si256( block + 1 ) ) };
+
+        // Packing interleaves the 128-bit lanes of both halves, the permutation restores their order.
+        const auto parities { _mm256_permute4x64_epi64( _mm256_packus_epi16( low_half_parities, high_half_parities ),
+                                                        0b11'01'10'00 ) };
+
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( are_intact + idx ), _mm256_xor_si256( parities, ones ) );
+
+        const auto corrupt_flags { static_cast<uint32_t>( _mm256_movemask_epi8( _mm256_slli_epi16( parities, 7 ) ) ) };
+        corrupt_count += static_cast<size_t>( std::popcount( corrupt_flags ) );
+    }
+
+    return corrupt_count + verify_parity_scalar( segments + idx, are_intact + idx, count - idx );
+}
+
+[[ gnu::target( "avx512bw,avx512vl,avx512bitalg" ) ]] void
+generate_parity_avx512( segment_t* const segments, const size_t count ) noexcept
+{
+    constexpr auto segments_per_block { sizeof( __m512i ) / sizeof( segment_t ) };
+
+    const auto data_mask { _mm512_set1_epi16( data_bits_mask ) };
+    const auto ones { _mm512_set1_epi16( 1 ) };
+    auto idx { 0uz };
+
+    for ( ; idx + segments_per_block <= count; idx += segments_per_block )
+    {
+        auto* const block { segments + idx };
+        const auto data_bits { _mm512_and_si512( _mm512_loadu_si512( block ), data_mask ) };
+        const auto parity_bits { _mm512_slli_epi16( _mm512_and_si512( _mm512_popcnt_epi16( data_bits ), ones ),
+                                                    parity_bit_shift ) };
+        _mm512_storeu_si512( block, _mm512_or_si512( data_bits, parity_bits ) );
+    }
+
+    generate_parity_scalar( segments + idx, count - idx );
+}
+
+[[ nodiscard, gnu::target( "avx512bw,avx512vl,avx512bitalg" ) ]] size_t
+verify_parity_avx512( const segment_t* const segments, bool* const are_intact, const size_t count ) noexcept
+{
+    constexpr auto segments_per_block { sizeof( __m512i ) / sizeof( segment_t ) };
+
+    const auto ones { _mm512_set1_epi16( 1 ) };
+    const auto intact_flags { _mm256_set1_epi8( 1 ) };
+    auto corrupt_count { 0uz };
+    auto idx { 0uz };
+
+    for ( ; idx + segments_per_block <= count; idx += segments_per_block )
+    {
+        const auto set_bit_counts { _mm512_popcnt_epi16( _mm512_loadu_si512( segments + idx ) ) };
+        const __mmask32 corrupt_mask { _mm512_test_epi16_mask( set_bit_counts, ones ) };
+
+        _mm256_storeu_si256( reinterpret_cast<__m256i*>( are_intact + idx ),
+                             _mm256_maskz_mov_epi8( static_cast<__mmask32>( ~corrupt_mask ), intact_flags ) );
+
+        corrupt_count += static_cast<size_t>( std::popcount( corrupt_mask ) );
+    }
+
+    return corrupt_count + verify_parity_scalar( segments + idx, are_intact + idx, count - idx );
+}
+
+#endif
+
+struct [[ nodiscard ]] supported_parity_kernels_t
+{
+    std::array<parity_kernels_t, 3> kernels;
+    size_t count;
+};
+
+[[ nodiscard ]] supported_parity_kernels_t
+detect_supported_parity_kernels( ) noexcept
+{
+    supported_parity_kernels_t supported_kernels { };
+    auto& [ kernels, count ] { supported_kernels };
+
+    kernels[ count++ ] = parity_kernels_t { generate_parity_scalar, verify_parity_scalar, "scalar" };
+
+#if SNS_SIMD_PARITY_KERNELS == 1
+    __builtin_cpu_init( );
+
+    if ( __builtin_cpu_supports( "avx2" ) )
+    {
+        kernels[ count++ ] = parity_kernels_t { generate_parity_avx2, verify_parity_avx2, "avx2" };
+    }
+
+    if ( __builtin_cpu_supports( "avx512bw" ) && __builtin_cpu_supports( "avx512vl" ) &&
+         __builtin_cpu_supports( "avx512bitalg" ) )
+    {
+        kernels[ count++ ] = parity_kernels_t { generate_parity_avx512, verify_parity_avx512, "avx512" };
+    }
+#endif
+
+    return supported_kernels;
+}
+
+[[ nodiscard ]] const supported_parity_kernels_t&
+get_supported_parity_kernel_set( ) noexcept
+{
+    static const supported_parity_kernels_t supported_kernels { detect_supported_parity_kernels( ) };
+
+    return supported_kernels;
+}
+
+// The widest of the kernels that the CPU supports.
+[[ nodiscard ]] const parity_kernels_t&
+get_parity_kernels( ) noexcept
+{
+    const auto& [ kernels, count ] { get_supported_parity_kernel_set( ) };
+
+    return kernels[ count - 1 ];
+}
+
+}
+
+
+void
+generate_parity( const std::span<segment_t> segments ) noexcept
+{
+    get_parity_kernels( ).generate( std::data( segments ), std::size( segments ) );
+}
+
+[[ nodiscard ]] std::size_t
+verify_parity( const std::span<const segment_t> segments, const std::span<bool> are_intact_OUT ) noexcept
+{
+    return get_parity_kernels( ).verify( std::data( segments ), std::data( are_intact_OUT ), std::size( segments ) );
+}
+
+[[ nodiscard ]] std::string_view
+get_parity_kernel_name( ) noexcept
+{
+    return get_parity_kernels( ).name;
+}
+
+[[ nodiscard ]] std::span<const parity_kernels_t>
+get_supported_parity_kernels( ) noexcept
+{
+    const auto& [ kernels, count ] { get_supported_parity_kernel_set( ) };
+
+    return std::span { kernels }.first( count );
+}
+
+}
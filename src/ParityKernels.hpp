@@ -0,0 +1,41 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+#include <cstddef>
+#include "BidirectionalMultimessageSimulation.hpp"
+
+
+namespace simple_network_simulation
+{
+
+// Batch counterparts of the parity handling of encode_segment( ) and decode_segment( ),
+// dispatched on first use to the widest kernel the CPU supports (AVX-512, AVX2 or
+// plain scalar code) so that a portable build still runs them at full speed. Segments
+// protected by a CRC or a SECDED code are handled by the scalar kernels.
+
+struct [[ nodiscard ]] parity_kernels_t
+{
+    void ( *generate )( segment_t* const segments, const std::size_t count ) noexcept;
+    std::size_t ( *verify )( const segment_t* const segments, bool* const are_intact, const std::size_t count ) noexcept;
+    std::string_view name;
+};
+
+// Sets the parity bit of every segment so that each one has an even number of set bits.
+void
+generate_parity( const std::span<segment_t> segments ) noexcept;
+
+// Flags every segment as intact or corrupt and returns the number of corrupt ones.
+// are_intact_OUT must be at least as long as segments.
+[[ nodiscard ]] std::size_t
+verify_parity( const std::span<const segment_t> segments, const std::span<bool> are_intact_OUT ) noexcept;
+
+[[ nodiscard ]] std::string_view
+get_parity_kernel_name( ) noexcept;
+
+// All the kernels that the CPU supports, from the scalar ones to the widest ones, which
+// are those that generate_parity( ) and verify_parity( ) dispatch to.
+[[ nodiscard ]] std::span<const parity_kernels_t>
+get_supported_parity_kernels( ) noexcept;
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace simple_network_simulation::util
+{
+
+// The Philox4x32-10 counter-based generator of Salmon et al. (Random123): every 128-bit
+// counter is turned into 4 random words by 10 rounds of multiply-and-xor keyed by a
+// 64-bit key, so a stream is fully determined by its key and can be jumped anywhere
+// or filled in blocks with no dependency from one block on the previous one. The upper
+// half of the counter selects one of 2^64 independent streams under the same key and
+// the lower half counts the blocks along it.
+class Philox4x32
+{
+public:
+    using result_type = std::uint32_t;
+    using counter_type = std::array<std::uint32_t, 4>;
+
+    static constexpr auto words_per_block { 4uz };
+
+    constexpr explicit
+    Philox4x32( const std::uint64_t key, const std::uint64_t stream = 0, const std::uint64_t counter = 0 ) noexcept
+        : m_key { static_cast<std::uint32_t>( key ), static_cast<std::uint32_t>( key >> 32 ) },
+          m_stream { static_cast<std::uint32_t>( stream ), static_cast<std::uint32_t>( stream >> 32 ) },
+          m_counter { counter }
+    {
+    }
+
+    [[ nodiscard ]] static constexpr result_type
+    min( ) noexcept
+    {
+        return std::numeric_limits<result_type>::min( );
+    }
+
+    [[ nodiscard ]] static constexpr result_type
+    max( ) noexcept
+    {
+        return std::numeric_limits<result_type>::max( );
+    }
+
+    [[ nodiscard ]] constexpr result_type
+    operator( )( ) noexcept
+    {
+        if ( m_buffered_word_idx == words_per_block )
+        {
+            m_buffered_words = generate_block( m_counter++ );
+            m_buffered_word_idx = 0;
+        }
+
+        return m_buffered_words[ m_buffered_word_idx++ ];
+    }
+
+    // Fills the words a block at a time straight from the counter, bypassing the words
+    // buffered for operator( ).
+    constexpr void
+    fill( const std::span<result_type> words ) noexcept
+    {
+        const auto full_block_count { std::size( words ) / words_per_block };
+
+        for ( auto block_idx { 0uz }; block_idx < full_block_count; ++block_idx )
+        {
+            const auto block { generate_block( m_counter + block_idx ) };
+
+            for ( auto word_idx { 0uz }; word_idx < words_per_block; ++word_idx )
+            {
+                words[ block_idx * words_per_block + word_idx ] = block[ word_idx ];
+            }
+        }
+
+        m_counter += full_block_count;
+
+        for ( auto word_idx { full_block_count * words_per_block }; word_idx < std::size( words ); ++word_idx )
+        {
+            words[ word_idx ] = ( *this )( );
+        }
+    }
+
+    [[ nodiscard ]] constexpr counter_type
+    generate_block( const std::uint64_t counter ) const noexcept
+    {
+        counter_type block { static_cast<std::uint32_t>( counter ), static_cast<std::uint32_t>( counter >> 32 ),
+                             m_stream[ 0 ], m_stream[ 1 ] };
+        auto key { m_key };
+
+        for ( auto round_idx { 0uz }; round_idx < round_count; ++round_idx )
+        {
+            const auto product0 { std::uint64_t { multiplier0 } * block[ 0 ] };
+            const auto product1 { std::uint64_t { multiplier1 } * block[ 2 ] };
+
+            block = counter_type { static_cast<std::uint32_t>( product1 >> 32 ) ^ block[ 1 ] ^ key[ 0 ],
+                                   static_cast<std::uint32_t>( product1 ),
+                                   static_cast<std::uint32_t>( product0 >> 32 ) ^ block[ 3 ] ^ key[ 1 ],
+                                   static_cast<std::uint32_t>( product0 ) };
+
+            key[ 0 ] += weyl_increment0;
+            key[ 1 ] += weyl_increment1;
+        }
+
+        return block;
+    }
+
+private:
+    static constexpr auto round_count { 10uz };
+    static constexpr std::uint32_t multiplier0 { 0xD251'1F53 };
+    static constexpr std::uint32_t multiplier1 { 0xCD9E'8D57 };
+    static constexpr std::uint32_t weyl_increment0 { 0x9E37'79B9 };
+    static constexpr std::uint32_t weyl_increment1 { 0xBB67'AE85 };
+
+    std::array<std::uint32_t, 2> m_key;
+    std::array<std::uint32_t, 2> m_stream;
+    std::uint64_t m_counter;
+    counter_type m_buffered_words { };
+    std::size_t m_buffered_word_idx { words_per_block };
+};
+
+}
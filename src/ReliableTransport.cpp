@@ -0,0 +1,304 @@
+#include "ReliableTransport.hpp"
+#include <array>
+#include <span>
+#include <string_view>
+#include <expected>
+#include <system_error>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "BidirectionalMultimessageSimulation.hpp"
+
+
+using std::uint32_t;
+using std::uint64_t;
+using std::size_t;
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+using std::string_view_literals::operator""sv;
+
+constinit auto configured_arq_protocol { arq_protocol_t::none };
+constinit auto configured_arq_window_size { 0u };
+
+// Indexed by arq_protocol_t.
+constexpr std::array arq_protocol_names { "none"sv, "stop-and-wait"sv, "go-back-n"sv, "selective-repeat"sv };
+
+// The distance from one sequence number forward to another, modulo the wrap-around.
+[[ nodiscard ]] constexpr uint32_t
+get_sequence_distance( const uint64_t from_sequence_num, const uint32_t to_sequence_num ) noexcept
+{
+    return static_cast<uint32_t>( ( to_sequence_num - from_sequence_num ) % sequence_num_modulus );
+}
+
+}
+
+
+[[ nodiscard ]] std::expected<arq_protocol_t, std::errc>
+parse_arq_protocol( const std::string_view name ) noexcept
+{
+    const auto it { std::ranges::find( arq_protocol_names, name ) };
+
+    if ( it == std::cend( arq_protocol_names ) )
+    {
+        return std::unexpected { std::errc::invalid_argument };
+    }
+
+    return static_cast<arq_protocol_t>( std::distance( std::cbegin( arq_protocol_names ), it ) );
+}
+
+[[ nodiscard ]] std::string_view
+get_arq_protocol_name( const arq_protocol_t protocol ) noexcept
+{
+    return arq_protocol_names[ std::to_underlying( protocol ) ];
+}
+
+[[ nodiscard ]] uint32_t
+get_max_arq_window_size( const arq_protocol_t protocol ) noexcept
+{
+    // Go-Back-N must not let the window span every sequence number, or a whole window
+    // of lost acknowledgements would look like none was lost, and Selective Repeat must
+    // keep the windows of the sender and the receiver from overlapping.
+    if ( protocol == arq_protocol_t::go_back_n )
+    {
+        return sequence_num_modulus - 1;
+    }
+
+    if ( protocol == arq_protocol_t::selective_repeat )
+    {
+        return sequence_num_modulus / 2;
+    }
+
+    return 1;
+}
+
+[[ nodiscard ]] std::errc
+validate_arq_window_size( const uint32_t window_size ) noexcept
+{
+    if ( window_size < 1 )
+    {
+        return std::errc::argument_out_of_domain;
+    }
+
+    if ( window_size > get_max_arq_window_size( arq_protocol_t::go_back_n ) )
+    {
+        return std::errc::value_too_large;
+    }
+
+    return std::errc { };
+}
+
+void
+set_arq_protocol( const arq_protocol_t protocol ) noexcept
+{
+    configured_arq_protocol = protocol;
+}
+
+void
+set_arq_window_size( const uint32_t window_size ) noexcept
+{
+    configured_arq_window_size = window_size;
+}
+
+[[ nodiscard ]] arq_protocol_t
+get_arq_protocol( ) noexcept
+{
+    return configured_arq_protocol;
+}
+
+[[ nodiscard ]] uint32_t
+get_arq_window_size( ) noexcept
+{
+    return configured_arq_window_size == 0 ? get_max_arq_window_size( configured_arq_protocol )
+                                           : configured_arq_window_size;
+}
+
+ArqSender::ArqSender( const arq_protocol_t protocol, const uint32_t window_size ) noexcept
+    : m_window_size { window_size },
+      m_protocol { protocol }
+{
+}
+
+[[ nodiscard ]] uint32_t
+ArqSender::get_next_sequence_num( ) const noexcept
+{
+    return static_cast<uint32_t>( m_end_idx % sequence_num_modulus );
+}
+
+void
+ArqSender::push( const segment_t segment ) noexcept
+{
+    get_buffered_segment( m_end_idx++ ) = buffered_segment_t { segment, false, 0 };
+}
+
+[[ nodiscard ]] size_t
+ArqSender::collect_due_segments( const uint32_t round, const std::span<segment_t> segments_OUT,
+                                 size_t& retransmission_count_OUT ) noexcept
+{
+    const auto is_timed_out { [ round ]( const buffered_segment_t& buffered_segment )
+                              {
+                                  return round - buffered_segment.sent_round >= retransmission_timeout_rounds;
+                              } };
+
+    auto segment_count { 0uz };
+
+    if ( m_base_idx != m_next_idx )
+    {
+        const bool is_go_back_n { m_protocol != arq_protocol_t::selective_repeat };
+        const bool is_window_timed_out { is_go_back_n && is_timed_out( get_buffered_segment( m_base_idx ) ) };
+
+        for ( auto segment_idx { m_base_idx }; segment_idx != m_next_idx; ++segment_idx )
+        {
+            auto& buffered_segment { get_buffered_segment( segment_idx ) };
+
+            if ( is_go_back_n ? is_window_timed_out
+                              : buffered_segment.is_acknowledged == false && is_timed_out( buffered_segment ) )
+            {
+                buffered_segment.sent_round = round;
+                segments_OUT[ segment_count++ ] = buffered_segment.segment;
+            }
+        }
+    }
+
+    retransmission_count_OUT = segment_count;
+
+    for ( ; m_next_idx != m_end_idx && m_next_idx - m_base_idx < m_window_size; ++m_next_idx )
+    {
+        auto& buffered_segment { get_buffered_segment( m_next_idx ) };
+        buffered_segment.sent_round = round;
+        segments_OUT[ segment_count++ ] = buffered_segment.segment;
+    }
+
+    return segment_count;
+}
+
+bool
+ArqSender::acknowledge( const uint32_t acknowledgement_num ) noexcept
+{
+    const auto in_flight_count { m_next_idx - m_base_idx };
+
+    if ( m_protocol != arq_protocol_t::selective_repeat )
+    {
+        // A cumulative acknowledgement names the next segment expected, so it covers every
+        // segment before that one; naming the oldest segment in flight covers none.
+        const auto acknowledged_count { get_sequence_distance( m_base_idx, acknowledgement_num ) };
+
+        if ( acknowledged_count == 0 || acknowledged_count > in_flight_count )
+        {
+            return false;
+        }
+
+        m_base_idx += acknowledged_count;
+    }
+    else
+    {
+        const auto offset { get_sequence_distance( m_base_idx, acknowledgement_num ) };
+
+        if ( offset >= in_flight_count || get_buffered_segment( m_base_idx + offset ).is_acknowledged )
+        {
+            return false;
+        }
+
+        get_buffered_segment( m_base_idx + offset ).is_acknowledged = true;
+
+        while ( m_base_idx != m_next_idx && get_buffered_segment( m_base_idx ).is_acknowledged )
+        {
+            ++m_base_idx;
+        }
+    }
+
+    return true;
+}
+
+[[ nodiscard ]] ArqSender::buffered_segment_t&
+ArqSender::get_buffered_segment( const uint64_t segment_idx ) noexcept
+{
+    return m_buffer[ segment_idx % buffer_capacity ];
+}
+
+ArqReceiver::ArqReceiver( const arq_protocol_t protocol, const uint32_t window_size ) noexcept
+    : m_window_size { window_size },
+      m_protocol { protocol }
+{
+}
+
+[[ nodiscard ]] arq_reception_t
+ArqReceiver::receive( const uint32_t sequence_num, const segment_t segment,
+                      const std::span<segment_t> delivered_OUT ) noexcept
+{
+    if ( m_protocol != arq_protocol_t::selective_repeat )
+    {
+        const bool is_expected { sequence_num == m_expected_sequence_num };
+
+        if ( is_expected )
+        {
+            delivered_OUT[ 0 ] = segment;
+            m_expected_sequence_num = ( m_expected_sequence_num + 1 ) % sequence_num_modulus;
+        }
+
+        m_owed_acknowledgements.reset( );
+        m_owed_acknowledgements.set( m_expected_sequence_num );
+
+        return arq_reception_t { is_expected ? 1u : 0u, is_expected == false };
+    }
+
+    const auto offset { get_sequence_distance( m_expected_sequence_num, sequence_num ) };
+
+    if ( offset >= m_window_size )
+    {
+        // A segment from before the window was delivered already, so its acknowledgement
+        // got lost and is owed again; anything further off is not acknowledged at all.
+        if ( offset >= sequence_num_modulus - m_window_size )
+        {
+            m_owed_acknowledgements.set( sequence_num );
+        }
+
+        return arq_reception_t { 0, true };
+    }
+
+    m_owed_acknowledgements.set( sequence_num );
+
+    if ( m_buffered_sequence_nums.test( sequence_num ) )
+    {
+        return arq_reception_t { 0, true };
+    }
+
+    m_buffer[ sequence_num ] = segment;
+    m_buffered_sequence_nums.set( sequence_num );
+
+    auto delivered_count { 0u };
+
+    while ( m_buffered_sequence_nums.test( m_expected_sequence_num ) )
+    {
+        m_buffered_sequence_nums.reset( m_expected_sequence_num );
+        delivered_OUT[ delivered_count++ ] = m_buffer[ m_expected_sequence_num ];
+        m_expected_sequence_num = ( m_expected_sequence_num + 1 ) % sequence_num_modulus;
+    }
+
+    return arq_reception_t { delivered_count, false };
+}
+
+[[ nodiscard ]] size_t
+ArqReceiver::take_acknowledgements( const std::span<uint32_t> acknowledgement_nums_OUT ) noexcept
+{
+    auto acknowledgement_count { 0uz };
+
+    for ( auto sequence_num { 0u }; sequence_num < sequence_num_modulus; ++sequence_num )
+    {
+        if ( m_owed_acknowledgements.test( sequence_num ) )
+        {
+            acknowledgement_nums_OUT[ acknowledgement_count++ ] = sequence_num;
+        }
+    }
+
+    m_owed_acknowledgements.reset( );
+
+    return acknowledgement_count;
+}
+
+}
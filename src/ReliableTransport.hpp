@@ -0,0 +1,139 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <bitset>
+#include <string_view>
+#include <expected>
+#include <system_error>
+#include <cstddef>
+#include <cstdint>
+#include "BidirectionalMultimessageSimulation.hpp"
+
+
+namespace simple_network_simulation
+{
+
+// Parses one of none, stop-and-wait, go-back-n and selective-repeat.
+[[ nodiscard ]] std::expected<arq_protocol_t, std::errc>
+parse_arq_protocol( const std::string_view name ) noexcept;
+
+[[ nodiscard ]] std::string_view
+get_arq_protocol_name( const arq_protocol_t protocol ) noexcept;
+
+// The widest window a protocol can keep in flight without mistaking a retransmitted
+// segment for a new one once the sequence numbers wrap around.
+[[ nodiscard ]] std::uint32_t
+get_max_arq_window_size( const arq_protocol_t protocol ) noexcept;
+
+[[ nodiscard ]] std::errc
+validate_arq_window_size( const std::uint32_t window_size ) noexcept;
+
+void
+set_arq_protocol( const arq_protocol_t protocol ) noexcept;
+
+// A zero size means the widest window the protocol allows.
+void
+set_arq_window_size( const std::uint32_t window_size ) noexcept;
+
+[[ nodiscard ]] arq_protocol_t
+get_arq_protocol( ) noexcept;
+
+// The configured window size, or the widest window of the configured protocol if none
+// is. It is up to the caller not to configure a window wider than the protocol allows.
+[[ nodiscard ]] std::uint32_t
+get_arq_window_size( ) noexcept;
+
+// The sending half of an ARQ endpoint. It buffers the segments handed to it until they
+// are acknowledged, sends as many of them as fit in the window and resends those whose
+// acknowledgement does not come back within a round trip: under Go-Back-N (of which
+// stop-and-wait is the case of a window of one) the whole window once the oldest segment
+// times out, under Selective Repeat only the segments that timed out.
+class ArqSender
+{
+public:
+    // An acknowledgement that was sent within a round trip is back before the next
+    // chance to send, so that is when a segment times out.
+    static constexpr std::uint32_t retransmission_timeout_rounds { 1 };
+
+    // The segments waiting for the window to open come on top of the ones in it, and
+    // neither end of a connection ever lets either kind outnumber the window.
+    static constexpr auto buffer_capacity { 2uz * sequence_num_modulus };
+
+    ArqSender( const arq_protocol_t protocol, const std::uint32_t window_size ) noexcept;
+
+    [[ nodiscard ]] std::uint32_t
+    get_next_sequence_num( ) const noexcept;
+
+    // Buffers a segment carrying get_next_sequence_num( ) to be sent once it fits in the window.
+    void
+    push( const segment_t segment ) noexcept;
+
+    // Writes the segments due at a chance to send to segments_OUT, the retransmissions
+    // first and then the segments entering the window, and returns how many there are.
+    // segments_OUT must hold at least as many segments as the window.
+    [[ nodiscard ]] std::size_t
+    collect_due_segments( const std::uint32_t round, const std::span<segment_t> segments_OUT,
+                          std::size_t& retransmission_count_OUT ) noexcept;
+
+    // Returns whether the acknowledgement covered a segment that was not acknowledged yet.
+    bool
+    acknowledge( const std::uint32_t acknowledgement_num ) noexcept;
+
+private:
+    struct buffered_segment_t
+    {
+        segment_t segment;
+        bool is_acknowledged;
+        std::uint32_t sent_round;   // only ever subtracted from, so it may wrap around
+    };
+
+    [[ nodiscard ]] buffered_segment_t&
+    get_buffered_segment( const std::uint64_t segment_idx ) noexcept;
+
+    std::array<buffered_segment_t, buffer_capacity> m_buffer { };
+    std::uint64_t m_base_idx { };       // the oldest unacknowledged segment
+    std::uint64_t m_next_idx { };       // the next segment to be sent for the first time
+    std::uint64_t m_end_idx { };        // one past the last segment pushed
+    std::uint32_t m_window_size;
+    arq_protocol_t m_protocol;
+};
+
+struct [[ nodiscard ]] arq_reception_t
+{
+    std::uint32_t delivered_count;
+    bool is_duplicate;
+};
+
+// The receiving half of an ARQ endpoint. It passes the data segments on in order and
+// keeps track of the acknowledgements owed to the sender: under Go-Back-N a cumulative
+// one naming the next segment expected, after every segment, with those out of order
+// dropped; under Selective Repeat one per segment, with those out of order buffered
+// until the gap before them is filled.
+class ArqReceiver
+{
+public:
+    ArqReceiver( const arq_protocol_t protocol, const std::uint32_t window_size ) noexcept;
+
+    // Takes an intact data segment in and writes the segments it lets through, in order,
+    // to delivered_OUT, which must hold at least as many segments as the window.
+    [[ nodiscard ]] arq_reception_t
+    receive( const std::uint32_t sequence_num, const segment_t segment,
+             const std::span<segment_t> delivered_OUT ) noexcept;
+
+    // Writes the numbers of the acknowledgements owed to the sender to
+    // acknowledgement_nums_OUT, which must hold sequence_num_modulus of them, clears
+    // them and returns how many there are.
+    [[ nodiscard ]] std::size_t
+    take_acknowledgements( const std::span<std::uint32_t> acknowledgement_nums_OUT ) noexcept;
+
+private:
+    std::array<segment_t, sequence_num_modulus> m_buffer { };
+    std::bitset<sequence_num_modulus> m_buffered_sequence_nums { };
+    std::bitset<sequence_num_modulus> m_owed_acknowledgements { };
+    std::uint32_t m_expected_sequence_num { };
+    std::uint32_t m_window_size;
+    arq_protocol_t m_protocol;
+};
+
+}
@@ -0,0 +1,611 @@
+#include "Scenario.hpp"
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <array>
+#include <chrono>
+#include <charconv>
+#include <algorithm>
+#include <utility>
+#include <limits>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include "BidirectionalMultimessageSimulation.hpp"
+#include "PlatformMacros.hpp"
+
+#if PLATFORM_NAME != OS_WINDOWS
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+
+using std::uint8_t;
+using std::uint32_t;
+using std::size_t;
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+using std::string_view_literals::operator""sv;
+
+constexpr char comment_character { '#' };
+
+constexpr auto no_script_idx { std::numeric_limits<uint32_t>::max( ) };
+
+// Maps the whole file read-only, so that the parser takes the lines and their tokens as
+// views into it instead of copying them out.
+class [[ nodiscard ]] MappedFile
+{
+public:
+    MappedFile( ) noexcept = default;
+    MappedFile( const MappedFile& ) = delete;
+    MappedFile& operator=( const MappedFile& ) = delete;
+
+    ~MappedFile( )
+    {
+#if PLATFORM_NAME != OS_WINDOWS
+        if ( m_mapping != nullptr )
+        {
+            ::munmap( m_mapping, m_mapping_size );
+        }
+#endif
+    }
+
+    [[ nodiscard ]] std::errc
+    map( const std::filesystem::path& path ) noexcept
+    {
+#if PLATFORM_NAME != OS_WINDOWS
+        const int file_descriptor { ::open( path.c_str( ), O_RDONLY ) };
+
+        if ( file_descriptor == -1 )
+        {
+            return static_cast<std::errc>( errno );
+        }
+
+        struct stat status;
+
+        if ( ::fstat( file_descriptor, &status ) == -1 )
+        {
+            const auto error_code { static_cast<std::errc>( errno ) };
+            ::close( file_descriptor );
+
+            return error_code;
+        }
+
+        m_mapping_size = static_cast<size_t>( status.st_size );
+
+        // An empty file cannot be mapped, and has nothing to parse anyway.
+        if ( m_mapping_size == 0 )
+        {
+            ::close( file_descriptor );
+
+            return std::errc { };
+        }
+
+        void* const mapping { ::mmap( nullptr, m_mapping_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0 ) };
+        ::close( file_descriptor );
+
+        if ( mapping == MAP_FAILED )
+        {
+            return static_cast<std::errc>( errno );
+        }
+
+        ::madvise( mapping, m_mapping_size, MADV_SEQUENTIAL );
+        m_mapping = static_cast<char*>( mapping );
+
+        return std::errc { };
+#else
+        static_cast<void>( path );
+
+        return std::errc::not_supported;
+#endif
+    }
+
+    [[ nodiscard ]] std::string_view
+    get_contents( ) const noexcept
+    {
+        return m_mapping != nullptr ? std::string_view { m_mapping, m_mapping_size } : std::string_view { };
+    }
+
+private:
+    char* m_mapping { };
+    size_t m_mapping_size { };
+};
+
+[[ nodiscard ]] constexpr bool
+is_blank( const char character ) noexcept
+{
+    return character == ' ' || character == '\t' || character == '\r';
+}
+
+// A plain loop, as find_first_not_of( ) and find_first_of( ) search a set of characters
+// for every character of the text, which takes the better part of the loading time.
+[[ nodiscard ]] std::string_view
+take_token( std::string_view& text_IN_OUT ) noexcept
+{
+    const auto* position { std::data( text_IN_OUT ) };
+    const auto* const end { position + std::size( text_IN_OUT ) };
+
+    while ( position != end && is_blank( *position ) )
+    {
+        ++position;
+    }
+
+    const auto* const token_start { position };
+
+    while ( position != end && is_blank( *position ) == false )
+    {
+        ++position;
+    }
+
+    text_IN_OUT = std::string_view { position, end };
+
+    return std::string_view { token_start, position };
+}
+
+[[ nodiscard ]] std::string_view
+take_item( std::string_view& list_IN_OUT, const char separator ) noexcept
+{
+    const auto item_size { std::min( list_IN_OUT.find( separator ), std::size( list_IN_OUT ) ) };
+    const auto item { list_IN_OUT.substr( 0, item_size ) };
+    list_IN_OUT.remove_prefix( std::min( item_size + 1, std::size( list_IN_OUT ) ) );
+
+    return item;
+}
+
+template <typename T>
+[[ nodiscard ]] std::expected<T, std::errc>
+parse_number( const std::string_view token, const int base = 10 ) noexcept
+{
+    T number { };
+    const auto [ end, error_code ] { std::from_chars( std::data( token ), std::data( token ) + std::size( token ),
+                                                      number, base ) };
+
+    if ( error_code != std::errc { } )
+    {
+        return std::unexpected { error_code };
+    }
+
+    if ( std::empty( token ) || end != std::data( token ) + std::size( token ) )
+    {
+        return std::unexpected { std::errc::invalid_argument };
+    }
+
+    return number;
+}
+
+[[ nodiscard ]] std::expected<uint8_t, std::errc>
+parse_payload( const std::string_view token ) noexcept
+{
+    if ( token.starts_with( "0x"sv ) || token.starts_with( "0X"sv ) )
+    {
+        return parse_number<uint8_t>( token.substr( 2 ), 16 );
+    }
+
+    if ( token.starts_with( "0b"sv ) || token.starts_with( "0B"sv ) )
+    {
+        return parse_number<uint8_t>( token.substr( 2 ), 2 );
+    }
+
+    return parse_number<uint8_t>( token );
+}
+
+class [[ nodiscard ]] ScenarioParser
+{
+public:
+    [[ nodiscard ]] std::expected<scenario_t, scenario_error_t>
+    parse( std::string_view contents )
+    {
+        while ( std::empty( contents ) == false )
+        {
+            ++m_line_num;
+
+            auto line { take_item( contents, '\n' ) };
+            line = line.substr( 0, line.find( comment_character ) );
+
+            const auto keyword { take_token( line ) };
+            std::errc error_code { };
+
+            if ( std::empty( keyword ) )
+            {
+                continue;
+            }
+            else if ( keyword == "process"sv )
+            {
+                error_code = parse_process( line );
+            }
+            else if ( keyword == "connect"sv )
+            {
+                error_code = parse_connection( line );
+            }
+            else if ( keyword == "node"sv )
+            {
+                error_code = parse_node( line );
+            }
+            else if ( keyword == "script"sv )
+            {
+                error_code = parse_script( line );
+            }
+            else if ( keyword == "channel"sv )
+            {
+                error_code = parse_channel( line );
+            }
+            else
+            {
+                m_reason = "unknown statement"sv;
+                error_code = std::errc::invalid_argument;
+            }
+
+            if ( error_code == std::errc { } && std::empty( take_token( line ) ) == false )
+            {
+                m_reason = "unexpected text at the end of the line"sv;
+                error_code = std::errc::invalid_argument;
+            }
+
+            if ( error_code != std::errc { } )
+            {
+                return std::unexpected { scenario_error_t { error_code, m_line_num, m_reason } };
+            }
+        }
+
+        return finish( );
+    }
+
+private:
+    [[ nodiscard ]] std::errc
+    fail( const std::errc error_code, const std::string_view reason ) noexcept
+    {
+        m_reason = reason;
+
+        return error_code;
+    }
+
+    [[ nodiscard ]] std::errc
+    parse_channel( std::string_view& line )
+    {
+        const auto direction { take_token( line ) };
+        const auto fault_model { parse_channel_fault_model( take_token( line ) ) };
+
+        if ( fault_model.has_value( ) == false )
+        {
+            return fail( fault_model.error( ), "invalid fault model of the channel"sv );
+        }
+
+        if ( direction == "forward"sv )
+        {
+            m_scenario.forward_fault_model = *fault_model;
+        }
+        else if ( direction == "backward"sv )
+        {
+            m_scenario.backward_fault_model = *fault_model;
+        }
+        else
+        {
+            return fail( std::errc::invalid_argument, "the direction of the channel is neither forward nor backward"sv );
+        }
+
+        return std::errc { };
+    }
+
+    [[ nodiscard ]] std::errc
+    parse_script( std::string_view& line )
+    {
+        const auto name { take_token( line ) };
+
+        if ( std::empty( name ) )
+        {
+            return fail( std::errc::invalid_argument, "missing name of the script"sv );
+        }
+
+        // The payloads go through buffers that are reused from one script to the next.
+        m_request_payloads.clear( );
+        m_response_payloads.clear( );
+
+        uint8_t default_response_payload { };
+        uint8_t closing_payload { };
+        bool has_default_response_payload { false };
+        bool has_closing_payload { false };
+
+        for ( auto field { take_token( line ) }; std::empty( field ) == false; field = take_token( line ) )
+        {
+            auto value { take_token( line ) };
+
+            if ( field == "requests"sv )
+            {
+                while ( std::empty( value ) == false )
+                {
+                    const auto payload { parse_payload( take_item( value, ',' ) ) };
+
+                    if ( payload.has_value( ) == false )
+                    {
+                        return fail( payload.error( ), "invalid request payload"sv );
+                    }
+
+                    m_request_payloads.push_back( *payload );
+                }
+            }
+            else if ( field == "responses"sv )
+            {
+                while ( std::empty( value ) == false )
+                {
+                    auto pair { take_item( value, ',' ) };
+                    const auto request_payload { parse_payload( take_item( pair, ':' ) ) };
+                    const auto response_payload { parse_payload( pair ) };
+
+                    if ( request_payload.has_value( ) == false || response_payload.has_value( ) == false )
+                    {
+                        return fail( std::errc::invalid_argument, "invalid REQUEST:RESPONSE payload pair"sv );
+                    }
+
+                    m_response_payloads.emplace_back( *request_payload, *response_payload );
+                }
+            }
+            else if ( field == "default"sv || field == "closing"sv )
+            {
+                const auto payload { parse_payload( value ) };
+
+                if ( payload.has_value( ) == false )
+                {
+                    return fail( payload.error( ), "invalid default or closing payload"sv );
+                }
+
+                if ( field == "default"sv )
+                {
+                    default_response_payload = *payload;
+                    has_default_response_payload = true;
+                }
+                else
+                {
+                    closing_payload = *payload;
+                    has_closing_payload = true;
+                }
+            }
+            else
+            {
+                return fail( std::errc::invalid_argument, "unknown field of the script"sv );
+            }
+        }
+
+        if ( std::empty( m_request_payloads ) || has_default_response_payload == false || has_closing_payload == false )
+        {
+            return fail( std::errc::invalid_argument, "a script needs requests, a default and a closing payload"sv );
+        }
+
+        if ( std::size( m_request_payloads ) > max_request_count )
+        {
+            return fail( std::errc::value_too_large, "a script holds at most 256 requests"sv );
+        }
+
+        auto& protocols { m_scenario.topology.protocols };
+
+        if ( m_script_indices.try_emplace( name, static_cast<uint32_t>( std::size( protocols ) ) ).second == false )
+        {
+            return fail( std::errc::file_exists, "the script is already defined"sv );
+        }
+
+        protocols.push_back( make_application_protocol( m_request_payloads, m_response_payloads,
+                                                        default_response_payload, closing_payload ) );
+
+        return std::errc { };
+    }
+
+    [[ nodiscard ]] std::errc
+    parse_node( std::string_view& line )
+    {
+        const auto first_port_num { parse_number<uint32_t>( take_token( line ) ) };
+        const auto to_channel_delay { parse_number<uint32_t>( take_token( line ) ) };
+        const auto from_channel_delay { parse_number<uint32_t>( take_token( line ) ) };
+
+        if ( first_port_num.has_value( ) == false || to_channel_delay.has_value( ) == false ||
+             from_channel_delay.has_value( ) == false )
+        {
+            return fail( std::errc::invalid_argument, "a node needs its first port and two delays in ms"sv );
+        }
+
+        if ( *first_port_num == 0 )
+        {
+            return fail( std::errc::argument_out_of_domain, "port 0 is reserved"sv );
+        }
+
+        auto& nodes { m_scenario.topology.nodes };
+
+        if ( std::empty( nodes ) == false )
+        {
+            if ( const auto error_code { finish_node( ) }; error_code != std::errc { } )
+            {
+                return error_code;
+            }
+
+            // Keeping the nodes in the order of their ports rules out overlapping ranges in one comparison.
+            if ( *first_port_num < nodes.back( ).first_port_num + nodes.back( ).process_count )
+            {
+                return fail( std::errc::argument_out_of_domain,
+                             "the ports of a node must come after those of the previous node"sv );
+            }
+        }
+
+        node_t node { };
+        node.node_num = static_cast<uint32_t>( std::size( nodes ) + 1 );
+        node.first_process_idx = static_cast<uint32_t>( std::size( m_scenario.topology.processes ) );
+        node.first_port_num = *first_port_num;
+        node.transport_to_channel_delay = std::chrono::milliseconds { *to_channel_delay };
+        node.transport_from_channel_delay = std::chrono::milliseconds { *from_channel_delay };
+        nodes.push_back( node );
+
+        return std::errc { };
+    }
+
+    [[ nodiscard ]] std::errc
+    parse_process( std::string_view& line )
+    {
+        auto& nodes { m_scenario.topology.nodes };
+
+        if ( std::empty( nodes ) )
+        {
+            return fail( std::errc::invalid_argument, "a process must come after its node"sv );
+        }
+
+        auto& node { nodes.back( ) };
+
+        if ( node.process_count == max_processes_per_node ||
+             node.first_port_num > std::numeric_limits<uint32_t>::max( ) - node.process_count )
+        {
+            return fail( std::errc::value_too_large, "too many processes on the node"sv );
+        }
+
+        const auto application_delay { parse_number<uint32_t>( take_token( line ) ) };
+
+        if ( application_delay.has_value( ) == false )
+        {
+            return fail( application_delay.error( ), "a process needs the delay of its application layer in ms"sv );
+        }
+
+        auto script_idx { no_script_idx };
+
+        if ( const auto script_name { take_token( line ) }; std::empty( script_name ) == false )
+        {
+            script_idx = find_script( script_name );
+
+            if ( script_idx == no_script_idx )
+            {
+                return fail( std::errc::invalid_argument, "no such script"sv );
+            }
+        }
+
+        process_spec_t process { };
+        process.node_idx = static_cast<uint32_t>( std::size( nodes ) - 1 );
+        process.process_num = node.process_count + 1;
+        process.port_num = node.first_port_num + node.process_count;
+        process.application_delay = std::chrono::milliseconds { *application_delay };
+        m_scenario.topology.processes.push_back( process );
+        m_process_script_indices.push_back( script_idx );
+        ++node.process_count;
+
+        return std::errc { };
+    }
+
+    [[ nodiscard ]] std::errc
+    parse_connection( std::string_view& line )
+    {
+        const auto& processes { m_scenario.topology.processes };
+        const auto initiator_process_num { parse_number<uint32_t>( take_token( line ) ) };
+        const auto responder_process_num { parse_number<uint32_t>( take_token( line ) ) };
+
+        if ( initiator_process_num.has_value( ) == false || responder_process_num.has_value( ) == false )
+        {
+            return fail( std::errc::invalid_argument, "a connection needs the numbers of its two processes"sv );
+        }
+
+        if ( *initiator_process_num == 0 || *initiator_process_num > std::size( processes ) ||
+             *responder_process_num == 0 || *responder_process_num > std::size( processes ) )
+        {
+            return fail( std::errc::argument_out_of_domain, "no such process"sv );
+        }
+
+        const auto initiator_process_idx { *initiator_process_num - 1 };
+        const auto responder_process_idx { *responder_process_num - 1 };
+
+        if ( processes[ initiator_process_idx ].node_idx == processes[ responder_process_idx ].node_idx )
+        {
+            return fail( std::errc::argument_out_of_domain, "the processes of a connection must be on different nodes"sv );
+        }
+
+        auto script_idx { m_process_script_indices[ initiator_process_idx ] };
+
+        if ( const auto script_name { take_token( line ) }; std::empty( script_name ) == false )
+        {
+            script_idx = find_script( script_name );
+        }
+
+        if ( script_idx == no_script_idx )
+        {
+            return fail( std::errc::invalid_argument, "no such script, and none for the initiator either"sv );
+        }
+
+        m_scenario.topology.connections.push_back( connection_spec_t { initiator_process_idx, responder_process_idx,
+                                                                       script_idx } );
+
+        return std::errc { };
+    }
+
+    // Consecutive lines tend to name the same script, so the last lookup is remembered.
+    [[ nodiscard ]] uint32_t
+    find_script( const std::string_view name ) noexcept
+    {
+        if ( name != m_last_script_name )
+        {
+            const auto script_idx_iter { m_script_indices.find( name ) };
+
+            if ( script_idx_iter == std::cend( m_script_indices ) )
+            {
+                return no_script_idx;
+            }
+
+            m_last_script_name = name;
+            m_last_script_idx = script_idx_iter->second;
+        }
+
+        return m_last_script_idx;
+    }
+
+    [[ nodiscard ]] std::errc
+    finish_node( ) noexcept
+    {
+        return m_scenario.topology.nodes.back( ).process_count == 0
+               ? fail( std::errc::invalid_argument, "a node needs at least one process"sv )
+               : std::errc { };
+    }
+
+    [[ nodiscard ]] std::expected<scenario_t, scenario_error_t>
+    finish( )
+    {
+        const auto& topology { m_scenario.topology };
+        auto error_code { std::empty( topology.nodes ) ? std::errc { } : finish_node( ) };
+
+        if ( error_code == std::errc { } && std::empty( topology.connections ) )
+        {
+            error_code = fail( std::errc::invalid_argument, "the scenario has no connections"sv );
+        }
+
+        if ( error_code != std::errc { } )
+        {
+            return std::unexpected { scenario_error_t { error_code, m_line_num, m_reason } };
+        }
+
+        return std::move( m_scenario );
+    }
+
+    scenario_t m_scenario { };
+    std::vector<uint8_t> m_request_payloads;
+    std::vector< std::pair<uint8_t, uint8_t> > m_response_payloads;
+    std::unordered_map<std::string_view, uint32_t> m_script_indices;
+    std::vector<uint32_t> m_process_script_indices;
+    std::string_view m_last_script_name;
+    uint32_t m_last_script_idx { no_script_idx };
+    std::string_view m_reason;
+    size_t m_line_num { };
+};
+
+}
+
+
+[[ nodiscard ]] std::expected<scenario_t, scenario_error_t>
+load_scenario( const std::filesystem::path& path )
+{
+    MappedFile file { };
+
+    if ( const auto error_code { file.map( path ) }; error_code != std::errc { } )
+    {
+        return std::unexpected { scenario_error_t { error_code, 0, "cannot read the file"sv } };
+    }
+
+    return ScenarioParser { }.parse( file.get_contents( ) );
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <expected>
+#include <string_view>
+#include <system_error>
+#include <cstddef>
+#include "ChannelFaults.hpp"
+#include "Topology.hpp"
+
+
+namespace simple_network_simulation
+{
+
+// A scenario is a text file with one statement per line ('#' starts a comment):
+//
+//   channel forward|backward SPEC    the fault model of a direction, as per --forward-channel
+//   script NAME requests B,B,... [responses B:B,...] default B closing B
+//                                    a dialogue of at most 256 requests, with payloads in
+//                                    decimal, 0x or 0b notation
+//   node FIRST_PORT TO_MS FROM_MS    a node, with the port of its first process and the
+//                                    delays of its transport layer towards and from the channel
+//   process APP_MS [SCRIPT]          a process of the last node, on the node's next port,
+//                                    with the delay of its application layer and the script
+//                                    that it follows on the connections that it opens
+//   connect INITIATOR RESPONDER [SCRIPT]
+//                                    a connection between two processes on different nodes,
+//                                    numbered from 1 in the order of the file, following the
+//                                    given script or else the one of the initiator
+//
+// A statement may only refer to scripts and processes that come before it, so that the
+// file is loaded in a single pass.
+struct [[ nodiscard ]] scenario_t
+{
+    topology_t topology;
+    std::optional<channel_fault_model_t> forward_fault_model;
+    std::optional<channel_fault_model_t> backward_fault_model;
+};
+
+struct [[ nodiscard ]] scenario_error_t
+{
+    std::errc error_code;
+    std::size_t line_num;   // 0 if the file itself could not be read
+    std::string_view reason;
+};
+
+// Maps the file into memory and parses it in place, turning each script into the tables
+// of a protocol of the topology.
+[[ nodiscard ]] std::expected<scenario_t, scenario_error_t>
+load_scenario( const std::filesystem::path& path );
+
+}
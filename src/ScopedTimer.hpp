@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <type_traits>
+#include <functional>
+#include <exception>
+#include <utility>
+#include <cstddef>
+
+
+namespace simple_network_simulation::util
+{
+
+#define NODISCARD_WARNING_MSG "ignoring returned value of type 'ScopedTimer' might " \
+                              "change the program's behavior since it has side effects"
+
+
+template < class Duration, class Clock >
+using scoped_timer_callback_t = std::conditional_t<
+                                  noexcept( Clock::now( ) ),
+                                  std::move_only_function<void ( Duration ) noexcept>,
+                                  std::move_only_function<void ( Duration, std::exception_ptr ) noexcept> >;
+
+// The callback is type-erased by default. A timer on a hot path can take a callable type
+// of its own instead, which is then called directly (and always, as it cannot be unset).
+template < class Duration = std::chrono::microseconds,
+           class Clock    = std::chrono::steady_clock,
+           class Callback = scoped_timer_callback_t<Duration, Clock> >
+requires ( std::chrono::is_clock_v<Clock> &&
+           requires { std::chrono::time_point<Clock, Duration>{ }; } )
+class [[ nodiscard( NODISCARD_WARNING_MSG ) ]] ScopedTimer
+{
+public:
+    using clock         = Clock;
+    using duration      = Duration;
+    using rep           = Duration::rep;
+    using period        = Duration::period;
+    using time_point    = std::chrono::time_point<Clock, Duration>;
+    using callback_type = Callback;
+
+    static constexpr bool is_callback_nullable { std::is_assignable_v<callback_type&, std::nullptr_t> };
+
+    [[ nodiscard( "implicit destruction of temporary object" ) ]] explicit
+    ScopedTimer( callback_type&& callback = callback_type { } ) noexcept( noexcept( now( ) ) )
+        : m_callback { std::move( callback ) }
+    {
+    }
+
+    [[ nodiscard( "implicit destruction of temporary object" ) ]]
+    ScopedTimer( ScopedTimer&& rhs ) noexcept = default;
+
+    ~ScopedTimer( )
+    {
+        if constexpr ( is_callback_nullable )
+        {
+            if ( m_callback == nullptr )
+                return;
+        }
+
+        if constexpr ( noexcept( now( ) ) )
+        {
+            const time_point end { now( ) };
+            m_callback( end - m_start );
+        }
+        else
+        {
+            try
+            {
+                const time_point end { now( ) };
+                m_callback( end - m_start, nullptr );
+            }
+            catch ( ... )
+            {
+                const std::exception_ptr ex_ptr { std::current_exception( ) };
+                m_callback( duration { }, ex_ptr );
+            }
+        }
+    }
+
+    [[ nodiscard ]] const time_point&
+    get_start( ) const& noexcept
+    {
+        return m_start;
+    }
+
+    [[ nodiscard ]] const time_point&
+    get_start( ) const&& noexcept = delete;
+
+    [[ nodiscard ]] const callback_type&
+    get_callback( ) const& noexcept
+    {
+        return m_callback;
+    }
+
+    [[ nodiscard ]] const callback_type&
+    get_callback( ) const&& noexcept = delete;
+
+    void
+    set_callback( callback_type&& callback ) & noexcept
+    {
+        m_callback = std::move( callback );
+    }
+
+    void
+    set_callback( callback_type&& callback ) && noexcept = delete;
+
+    duration
+    unset_callback( ) & noexcept( noexcept( elapsed_time( ) ) )
+    requires is_callback_nullable
+    {
+        m_callback = nullptr;
+        return elapsed_time( );
+    }
+
+    duration
+    unset_callback( ) && noexcept( noexcept( elapsed_time( ) ) ) = delete;
+
+    [[ nodiscard ]] duration
+    elapsed_time( ) const& noexcept( noexcept( now( ) ) )
+    {
+        return now( ) - m_start;
+    }
+
+    [[ nodiscard ]] duration
+    elapsed_time( ) const&& noexcept( noexcept( now( ) ) ) = delete;
+
+    [[ nodiscard ]] time_point static
+    now( ) noexcept( noexcept( clock::now( ) ) )
+    {
+        return std::chrono::time_point_cast<duration>( clock::now( ) );
+    }
+
+private:
+    time_point const m_start { now( ) };
+    [[ no_unique_address ]] callback_type m_callback;
+};
+
+template <class Callback>
+ScopedTimer( Callback&& ) -> ScopedTimer<>;
+
+template <class Duration>
+ScopedTimer( std::move_only_function<void ( Duration ) noexcept> ) -> ScopedTimer<Duration>;
+
+}
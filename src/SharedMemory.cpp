@@ -0,0 +1,108 @@
+#include "SharedMemory.hpp"
+#include <utility>
+#include <cerrno>
+#include "PlatformMacros.hpp"
+
+#if PLATFORM_NAME != OS_WINDOWS
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+
+namespace simple_network_simulation::util
+{
+
+[[ nodiscard ]] std::system_error
+make_system_error( const char* const what ) noexcept
+{
+    return std::system_error { errno, std::generic_category( ), what };
+}
+
+[[ nodiscard ]] std::string
+get_shared_memory_path( const std::string_view name )
+{
+    if ( name.starts_with( '/' ) )
+    {
+        return std::string { name };
+    }
+
+    std::string path { '/' };
+    path += name;
+
+    return path;
+}
+
+SharedMemorySegment::SharedMemorySegment( const std::string_view name, const std::size_t size,
+                                          const std::filesystem::perms permissions )
+    : m_path { get_shared_memory_path( name ) },
+      m_mapping { },
+      m_mapping_size { size }
+{
+#if PLATFORM_NAME != OS_WINDOWS
+    ::shm_unlink( m_path.c_str( ) );
+
+    const int file_descriptor { ::shm_open( m_path.c_str( ), O_RDWR | O_CREAT | O_EXCL,
+                                            static_cast<mode_t>( std::to_underlying( permissions ) ) ) };
+
+    if ( file_descriptor == -1 )
+    {
+        throw make_system_error( "Failure in creating the shared-memory segment" );
+    }
+
+    if ( ::ftruncate( file_descriptor, static_cast<off_t>( m_mapping_size ) ) == -1 )
+    {
+        const auto error { make_system_error( "Failure in sizing the shared-memory segment" ) };
+        ::close( file_descriptor );
+        ::shm_unlink( m_path.c_str( ) );
+
+        throw error;
+    }
+
+#   if PLATFORM_NAME == OS_GNULINUX
+    constexpr int mapping_flags { MAP_SHARED | MAP_POPULATE };
+#   else
+    constexpr int mapping_flags { MAP_SHARED };
+#   endif
+
+    void* const mapping { ::mmap( nullptr, m_mapping_size, PROT_READ | PROT_WRITE, mapping_flags, file_descriptor, 0 ) };
+
+    // The mapping keeps the segment alive on its own.
+    ::close( file_descriptor );
+
+    if ( mapping == MAP_FAILED )
+    {
+        const auto error { make_system_error( "Failure in mapping the shared-memory segment" ) };
+        ::shm_unlink( m_path.c_str( ) );
+
+        throw error;
+    }
+
+    m_mapping = static_cast<std::byte*>( mapping );
+#else
+    throw std::system_error { std::make_error_code( std::errc::not_supported ), "Shared-memory segments are not supported" };
+#endif
+}
+
+SharedMemorySegment::~SharedMemorySegment( )
+{
+#if PLATFORM_NAME != OS_WINDOWS
+    ::munmap( m_mapping, m_mapping_size );
+    ::shm_unlink( m_path.c_str( ) );
+#endif
+}
+
+[[ nodiscard ]] std::byte*
+SharedMemorySegment::get_data( ) const noexcept
+{
+    return m_mapping;
+}
+
+[[ nodiscard ]] std::size_t
+SharedMemorySegment::get_size( ) const noexcept
+{
+    return m_mapping_size;
+}
+
+}
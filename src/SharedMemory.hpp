@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <cstddef>
+
+
+namespace simple_network_simulation::util
+{
+
+// Wraps the errno of the system call that just failed.
+[[ nodiscard ]] std::system_error
+make_system_error( const char* const what ) noexcept;
+
+// Names the segments as shm_open wants them, with a single leading slash.
+[[ nodiscard ]] std::string
+get_shared_memory_path( const std::string_view name );
+
+// A named POSIX shared-memory segment (under /dev/shm on Linux), created zero-filled and
+// mapped read-write with its pages faulted in up front, so that the processes that share
+// it never take a page fault on it once they are running. The mapping is inherited by
+// the processes forked off afterwards. The creator removes the segment once destroyed;
+// a forked process that is done with it leaves by _exit without destroying it.
+class SharedMemorySegment
+{
+public:
+    // Throws std::system_error if the segment cannot be created or mapped. Only its
+    // owner gets to open it by name unless permissions say otherwise.
+    SharedMemorySegment( const std::string_view name, const std::size_t size,
+                         const std::filesystem::perms permissions = std::filesystem::perms::owner_read |
+                                                                    std::filesystem::perms::owner_write );
+
+    SharedMemorySegment( const SharedMemorySegment& ) = delete;
+    SharedMemorySegment& operator=( const SharedMemorySegment& ) = delete;
+
+    ~SharedMemorySegment( );
+
+    [[ nodiscard ]] std::byte*
+    get_data( ) const noexcept;
+
+    [[ nodiscard ]] std::size_t
+    get_size( ) const noexcept;
+
+private:
+    std::string m_path;
+    std::byte* m_mapping;
+    std::size_t m_mapping_size;
+};
+
+}
@@ -0,0 +1,346 @@
+#include <string_view>
+#include <string>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <array>
+#include <chrono>
+#include <thread>
+#include <charconv>
+#include <functional>
+#include <utility>
+#include <stdexcept>
+#include <exception>
+#include <optional>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <cerrno>
+#include <fmt/core.h>
+#include "StatisticsRegion.hpp"
+#include "PlatformMacros.hpp"
+
+#if PLATFORM_NAME != OS_WINDOWS
+#   include <signal.h>
+#   include <sys/types.h>
+#endif
+
+
+namespace sns = simple_network_simulation;
+
+namespace
+{
+
+using std::string_view_literals::operator""sv;
+
+constexpr auto tool_name { "sns-top"sv };
+
+constexpr auto interval_option { "--interval="sv };
+constexpr auto connections_option { "--connections="sv };
+
+constexpr std::chrono::milliseconds default_refresh_interval { 1000 };
+constexpr auto default_listed_connection_count { 10uz };
+
+// A torn read is retried this many times before the refresh is skipped.
+constexpr auto max_read_attempt_count { 16 };
+
+// Indexed by latency_layer_t, as the layers of the snapshot are.
+constexpr std::array layer_names { "application"sv, "transport to channel"sv, "channel"sv, "transport from channel"sv };
+
+static_assert( std::size( layer_names ) == sns::statistics_layer_count );
+
+struct options_t
+{
+    std::string_view region_name;
+    std::chrono::milliseconds refresh_interval { default_refresh_interval };
+    std::size_t listed_connection_count { default_listed_connection_count };
+};
+
+struct sample_t
+{
+    sns::statistics_snapshot_t snapshot;
+    std::vector<sns::statistics_connection_t> connections;
+};
+
+[[ nodiscard ]] std::optional<std::uint64_t>
+parse_number( const std::string_view text ) noexcept
+{
+    std::uint64_t number { };
+    const auto [ end, error_code ] { std::from_chars( std::data( text ), std::data( text ) + std::size( text ), number ) };
+
+    return error_code == std::errc { } && end == std::data( text ) + std::size( text ) ? std::optional { number }
+                                                                                       : std::nullopt;
+}
+
+[[ nodiscard ]] std::optional<options_t>
+parse_options( const std::span<const char* const> arguments ) noexcept
+{
+    options_t options { };
+
+    for ( const std::string_view argument : arguments )
+    {
+        if ( argument.starts_with( interval_option ) )
+        {
+            const auto interval_ms { parse_number( argument.substr( std::size( interval_option ) ) ) };
+
+            if ( interval_ms.has_value( ) == false || *interval_ms == 0 )
+            {
+                return std::nullopt;
+            }
+
+            options.refresh_interval = std::chrono::milliseconds { *interval_ms };
+        }
+        else if ( argument.starts_with( connections_option ) )
+        {
+            const auto connection_count { parse_number( argument.substr( std::size( connections_option ) ) ) };
+
+            if ( connection_count.has_value( ) == false )
+            {
+                return std::nullopt;
+            }
+
+            options.listed_connection_count = static_cast<std::size_t>( *connection_count );
+        }
+        else if ( argument.starts_with( "-"sv ) == false && std::empty( options.region_name ) )
+        {
+            options.region_name = argument;
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
+    return std::empty( options.region_name ) ? std::nullopt : std::optional { options };
+}
+
+// A simulator that gets killed leaves its region behind, with no one to ever mark it
+// finished.
+[[ nodiscard ]] bool
+is_process_alive( [[ maybe_unused ]] const std::uint64_t process_id ) noexcept
+{
+#if PLATFORM_NAME != OS_WINDOWS
+    return ::kill( static_cast<pid_t>( process_id ), 0 ) == 0 || errno == EPERM;
+#else
+    return true;
+#endif
+}
+
+// Retries a torn read, which only happens when the simulator publishes in the middle of
+// it, and gives up on this refresh if the simulator keeps beating it to it.
+[[ nodiscard ]] bool
+read_sample( const sns::StatisticsRegionReader& region, sample_t& sample_OUT ) noexcept
+{
+    for ( auto attempt_idx { 0 }; attempt_idx < max_read_attempt_count; ++attempt_idx )
+    {
+        if ( region.try_read( sample_OUT.snapshot, sample_OUT.connections ) )
+        {
+            return true;
+        }
+
+        std::this_thread::yield( );
+    }
+
+    return false;
+}
+
+[[ nodiscard ]] double
+get_rate( const std::uint64_t count, const std::uint64_t previous_count, const double elapsed_seconds ) noexcept
+{
+    return elapsed_seconds > 0.0 && count >= previous_count ? static_cast<double>( count - previous_count ) / elapsed_seconds
+                                                            : 0.0;
+}
+
+[[ nodiscard ]] double
+get_percentage( const std::uint64_t part, const std::uint64_t whole ) noexcept
+{
+    return whole == 0 ? 0.0 : 100.0 * static_cast<double>( part ) / static_cast<double>( whole );
+}
+
+[[ nodiscard ]] std::string
+format_latency( const std::uint64_t latency_ns, const bool are_latencies_recorded )
+{
+    return are_latencies_recorded ? fmt::format( "{}ns", latency_ns ) : std::string { "-" };
+}
+
+// The heap of libstdc++'s partial_sort does signed iterator arithmetic that GCC assumes
+// does not overflow, and reports it under -Wstrict-overflow against monitor( ), which
+// show_sample( ) gets inlined into.
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic push
+#   pragma GCC diagnostic ignored "-Wstrict-overflow"
+#endif
+
+// Shows the rates over the last refresh interval, next to the totals since the start.
+void
+show_sample( const sns::statistics_region_header_t& header, const sample_t& sample, const sample_t& previous_sample,
+             const std::size_t listed_connection_count )
+{
+    const auto& snapshot { sample.snapshot };
+    const auto& previous_snapshot { previous_sample.snapshot };
+    const auto elapsed_seconds { static_cast<double>( snapshot.elapsed_time_ns - std::min( snapshot.elapsed_time_ns,
+                                                                                           previous_snapshot.elapsed_time_ns ) ) /
+                                 1e9 };
+    const bool are_latencies_recorded { snapshot.are_latencies_recorded != 0 };
+    const auto corruption_count { snapshot.detected_corruption_count + snapshot.undetected_corruption_count };
+
+    // Moves the cursor home and clears the screen, so that each refresh overwrites the last.
+    fmt::print( "\x1b[H\x1b[J" );
+
+    fmt::print( "{} - simulator pid {}, {:.1f} s{}\n\n", tool_name, header.process_id,
+                static_cast<double>( snapshot.elapsed_time_ns ) / 1e9, snapshot.is_finished != 0 ? ", finished" : "" );
+
+    fmt::print( "messages: {} sent ({:.0f}/s), {} received ({:.0f}/s)\n"
+                "segments: {} sent ({:.0f}/s), {} bits flipped\n"
+                "corruptions: {} ({:.4f}% of the segments), {} of them undetected\n"
+                "connections closed: {}\n\n",
+                snapshot.sent_message_count,
+                get_rate( snapshot.sent_message_count, previous_snapshot.sent_message_count, elapsed_seconds ),
+                snapshot.received_message_count,
+                get_rate( snapshot.received_message_count, previous_snapshot.received_message_count, elapsed_seconds ),
+                snapshot.sent_segment_count,
+                get_rate( snapshot.sent_segment_count, previous_snapshot.sent_segment_count, elapsed_seconds ),
+                snapshot.flipped_bit_count, corruption_count,
+                get_percentage( corruption_count, snapshot.sent_segment_count ),
+                snapshot.undetected_corruption_count, snapshot.closed_connection_count );
+
+    fmt::print( "{:<22} {:>14} {:>12} {:>10} {:>10} {:>10} {:>10} {:>12}\n",
+                "layer", "calls", "calls/s", "p50", "p90", "p99", "p99.9", "max" );
+
+    for ( auto layer_idx { 0uz }; layer_idx < sns::statistics_layer_count; ++layer_idx )
+    {
+        const auto& layer { snapshot.layers[ layer_idx ] };
+
+        fmt::print( "{:<22} {:>14} {:>12.0f} {:>10} {:>10} {:>10} {:>10} {:>12}\n",
+                    layer_names[ layer_idx ], layer.call_count,
+                    get_rate( layer.call_count, previous_snapshot.layers[ layer_idx ].call_count, elapsed_seconds ),
+                    format_latency( layer.p50_ns, are_latencies_recorded ),
+                    format_latency( layer.p90_ns, are_latencies_recorded ),
+                    format_latency( layer.p99_ns, are_latencies_recorded ),
+                    format_latency( layer.p999_ns, are_latencies_recorded ),
+                    format_latency( layer.max_ns, are_latencies_recorded ) );
+    }
+
+    if ( std::empty( sample.connections ) || listed_connection_count == 0 )
+    {
+        std::fflush( stdout );
+
+        return;
+    }
+
+    // The busiest connections over the last interval come first.
+    std::vector<std::size_t> connection_indices( std::size( sample.connections ) );
+    std::iota( std::begin( connection_indices ), std::end( connection_indices ), 0uz );
+
+    const auto get_received_delta { [ &sample, &previous_sample ]( const std::size_t connection_idx ) noexcept
+                                    {
+                                        const auto count { sample.connections[ connection_idx ].received_message_count };
+                                        const auto previous_count { previous_sample.connections[ connection_idx ]
+                                                                        .received_message_count };
+
+                                        return count >= previous_count ? count - previous_count : 0;
+                                    } };
+
+    const auto listed_count { std::min( listed_connection_count, std::size( connection_indices ) ) };
+
+    std::ranges::partial_sort( connection_indices, std::begin( connection_indices ) + static_cast<std::ptrdiff_t>( listed_count ),
+                               std::ranges::greater { }, get_received_delta );
+    fmt::print( "\n{:>10} {:>14} {:>12} {:>14} {:>12} {:>12} {:>12}\n",
+                "connection", "sent", "sent/s", "received", "received/s", "corruptions", "corrupt %" );
+
+    for ( const auto connection_idx : std::span { connection_indices }.first( listed_count ) )
+    {
+        const auto& connection { sample.connections[ connection_idx ] };
+        const auto& previous_connection { previous_sample.connections[ connection_idx ] };
+
+        fmt::print( "{:>10} {:>14} {:>12.0f} {:>14} {:>12.0f} {:>12} {:>11.4f}%\n",
+                    connection_idx + 1, connection.sent_message_count,
+                    get_rate( connection.sent_message_count, previous_connection.sent_message_count, elapsed_seconds ),
+                    connection.received_message_count,
+                    get_rate( connection.received_message_count, previous_connection.received_message_count,
+                              elapsed_seconds ),
+                    connection.corruption_count,
+                    get_percentage( connection.corruption_count, connection.sent_message_count ) );
+    }
+
+    if ( std::size( sample.connections ) > listed_count )
+    {
+        fmt::print( "{:>10}\n", fmt::format( "({} more)", std::size( sample.connections ) - listed_count ) );
+    }
+
+    std::fflush( stdout );
+}
+
+void
+monitor( const options_t& options )
+{
+    const sns::StatisticsRegionReader region { options.region_name };
+    const auto& header { region.get_header( ) };
+
+    sample_t previous_sample { sns::statistics_snapshot_t { },
+                               std::vector<sns::statistics_connection_t>( header.connection_count ) };
+    auto sample { previous_sample };
+
+    while ( true )
+    {
+        // Checked ahead of the read, so that a simulator that published its last sample
+        // and exited in between is not taken for one that died.
+        const auto is_publisher_alive { is_process_alive( header.process_id ) };
+
+        if ( read_sample( region, sample ) )
+        {
+            show_sample( header, sample, previous_sample, options.listed_connection_count );
+
+            if ( sample.snapshot.is_finished != 0 )
+            {
+                return;
+            }
+
+            std::swap( sample, previous_sample );
+        }
+
+        if ( is_publisher_alive == false )
+        {
+            throw std::runtime_error { fmt::format( "the simulator (pid {}) exited before finishing", header.process_id ) };
+        }
+
+        std::this_thread::sleep_for( options.refresh_interval );
+    }
+}
+
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#   pragma GCC diagnostic pop
+#endif
+
+}
+
+
+int main( const int argc, const char* const* const argv )
+{
+    const auto options { parse_options( std::span { argv, static_cast<std::size_t>( argc ) }.subspan( 1 ) ) };
+
+    if ( options.has_value( ) == false )
+    {
+        fmt::print( stderr, "Usage: {} [--interval=MS] [--connections=N] NAME\n"
+                            "Show the statistics that the simulator publishes with --stats-shm=NAME, refreshed\n"
+                            "every MS milliseconds (1000 by default), with the N busiest connections (10 by default).\n",
+                    tool_name );
+
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        monitor( *options );
+    }
+    catch ( const std::exception& ex )
+    {
+        fmt::print( stderr, "{}: {}: {}\n", tool_name, options->region_name, ex.what( ) );
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+
+namespace simple_network_simulation::util
+{
+
+// A bounded lock-free queue between exactly one producer thread and one consumer
+// thread. Each side owns one index and publishes it with a release store; it only
+// reloads the index of the other side when its cached copy says that the ring is full
+// ( or empty ), so in the steady state neither side touches the other's cache line.
+template <class T, std::size_t Capacity>
+requires ( Capacity >= 2 && ( Capacity & ( Capacity - 1 ) ) == 0 )
+class SpscRing
+{
+public:
+    static constexpr auto capacity { Capacity };
+
+    SpscRing( ) = default;
+
+    SpscRing( const SpscRing& ) = delete;
+    SpscRing& operator=( const SpscRing& ) = delete;
+
+    // Producer side only. Returns false, leaving the ring as it is, if the ring is full.
+    [[ nodiscard ]] bool
+    try_push( const T& item ) noexcept
+    {
+        const auto tail { m_tail.load( std::memory_order_relaxed ) };
+
+        if ( tail - m_cached_head == Capacity )
+        {
+            m_cached_head = m_head.load( std::memory_order_acquire );
+
+            if ( tail - m_cached_head == Capacity )
+            {
+                return false;
+            }
+        }
+
+        m_slots[ tail & ( Capacity - 1 ) ] = item;
+        m_tail.store( tail + 1, std::memory_order_release );
+
+        return true;
+    }
+
+    // Consumer side only. Returns false, leaving item_OUT as it is, if the ring is empty.
+    [[ nodiscard ]] bool
+    try_pop( T& item_OUT ) noexcept
+    {
+        const auto head { m_head.load( std::memory_order_relaxed ) };
+
+        if ( head == m_cached_tail )
+        {
+            m_cached_tail = m_tail.load( std::memory_order_acquire );
+
+            if ( head == m_cached_tail )
+            {
+                return false;
+            }
+        }
+
+        item_OUT = m_slots[ head & ( Capacity - 1 ) ];
+        m_head.store( head + 1, std::memory_order_release );
+
+        return true;
+    }
+
+private:
+    // The consumer's index and its copy of the producer's, then the other way round,
+    // each pair on a cache line of its own.
+    alignas( 64 ) std::atomic<std::size_t> m_head { };
+    std::size_t m_cached_tail { };
+    alignas( 64 ) std::atomic<std::size_t> m_tail { };
+    std::size_t m_cached_head { };
+    alignas( 64 ) std::array<T, Capacity> m_slots { };
+};
+
+}
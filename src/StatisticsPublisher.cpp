@@ -0,0 +1,127 @@
+#include "StatisticsPublisher.hpp"
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#include "EventCounters.hpp"
+#include "LatencyHistogram.hpp"
+
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+static_assert( statistics_layer_count == latency_layer_count );
+
+// An empty name means that no statistics are published.
+constinit std::string statistics_region_name { };
+
+[[ nodiscard ]] std::uint64_t
+to_nanoseconds( const std::chrono::nanoseconds duration ) noexcept
+{
+    return static_cast<std::uint64_t>( std::max( duration.count( ), decltype( duration.count( ) ) { 0 } ) );
+}
+
+}
+
+
+StatisticsPublisher::StatisticsPublisher( const std::uint32_t connection_count )
+    : m_start_time { std::chrono::steady_clock::now( ) }
+{
+    if ( std::empty( statistics_region_name ) )
+    {
+        return;
+    }
+
+    m_writer.emplace( statistics_region_name, connection_count, statistics_publish_interval );
+    m_connections.resize( connection_count );
+
+    publish( false );
+
+    m_thread = std::jthread { [ this ]( const std::stop_token stop_token )
+                              {
+                                  std::unique_lock lock { m_mutex };
+
+                                  // Wakes up every interval, or at once when asked to stop.
+                                  while ( m_condition.wait_for( lock, stop_token, statistics_publish_interval,
+                                                                [ &stop_token ] { return stop_token.stop_requested( ); } ) == false )
+                                  {
+                                      publish( false );
+                                  }
+                              } };
+}
+
+StatisticsPublisher::~StatisticsPublisher( )
+{
+    if ( m_writer.has_value( ) == false )
+    {
+        return;
+    }
+
+    m_thread.request_stop( );
+    m_thread.join( );
+
+    publish( true );
+}
+
+void
+StatisticsPublisher::publish( const bool is_finished )
+{
+    const event_counts_t counts { read_event_counts( ) };
+
+    statistics_snapshot_t snapshot { };
+    snapshot.elapsed_time_ns = to_nanoseconds( std::chrono::steady_clock::now( ) - m_start_time );
+    snapshot.sent_message_count = counts.sent_message_count;
+    snapshot.received_message_count = counts.received_message_count;
+    snapshot.sent_segment_count = counts.sent_segment_count;
+    snapshot.flipped_bit_count = counts.flipped_bit_count;
+    snapshot.detected_corruption_count = counts.detected_corruption_count;
+    snapshot.undetected_corruption_count = counts.undetected_corruption_count;
+    snapshot.closed_connection_count = counts.closed_connection_count;
+    snapshot.is_finished = is_finished ? 1 : 0;
+
+    snapshot.layers[ std::to_underlying( latency_layer_t::application ) ].call_count = counts.application_call_count;
+    snapshot.layers[ std::to_underlying( latency_layer_t::transport_to_channel ) ].call_count =
+        counts.transport_to_channel_call_count;
+    snapshot.layers[ std::to_underlying( latency_layer_t::channel ) ].call_count = counts.channel_call_count;
+    snapshot.layers[ std::to_underlying( latency_layer_t::transport_from_channel ) ].call_count =
+        counts.transport_from_channel_call_count;
+
+#if SNS_LATENCY_HISTOGRAMS == 1
+    snapshot.are_latencies_recorded = 1;
+
+    for ( const auto& summary : collect_live_layer_latencies( ) )
+    {
+        auto& layer { snapshot.layers[ std::to_underlying( summary.layer ) ] };
+        layer.p50_ns = to_nanoseconds( summary.p50 );
+        layer.p90_ns = to_nanoseconds( summary.p90 );
+        layer.p99_ns = to_nanoseconds( summary.p99 );
+        layer.p999_ns = to_nanoseconds( summary.p999 );
+        layer.max_ns = to_nanoseconds( summary.max );
+    }
+#endif
+
+    std::vector<connection_counts_t> connection_counts( std::size( m_connections ) );
+    read_connection_counts( connection_counts );
+
+    std::ranges::transform( connection_counts, std::begin( m_connections ),
+                            [ ]( const connection_counts_t& connection_counts_of_one ) noexcept
+                            {
+                                return statistics_connection_t { connection_counts_of_one.sent_count,
+                                                                 connection_counts_of_one.received_count,
+                                                                 connection_counts_of_one.corruption_count };
+                            } );
+
+    m_writer->publish( snapshot, m_connections );
+}
+
+void
+set_statistics_region_name( const std::string_view name )
+{
+    statistics_region_name = name;
+}
+
+}
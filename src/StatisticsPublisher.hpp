@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <string_view>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <vector>
+#include <cstdint>
+#include "StatisticsRegion.hpp"
+
+
+namespace simple_network_simulation
+{
+
+inline constexpr std::chrono::milliseconds statistics_publish_interval { 100 };
+
+// Publishes the event counters (and the latencies of the layers, if they are recorded)
+// into the statistics region of the run, if one is requested, for as long as it lives.
+// A thread of its own reads the counters and writes them to the region every interval,
+// so the threads that run the simulation pay nothing more than for the counting.
+class [[ nodiscard ]] StatisticsPublisher
+{
+public:
+    // Throws std::system_error if the region cannot be created. connection_count is the
+    // number of connections whose counts are published, which may be 0.
+    explicit
+    StatisticsPublisher( const std::uint32_t connection_count );
+
+    StatisticsPublisher( const StatisticsPublisher& ) = delete;
+    StatisticsPublisher& operator=( const StatisticsPublisher& ) = delete;
+
+    // Publishes the counts one last time, flagged as final, and removes the region.
+    ~StatisticsPublisher( );
+
+private:
+    void
+    publish( const bool is_finished );
+
+    std::optional<StatisticsRegionWriter> m_writer;
+    std::vector<statistics_connection_t> m_connections;
+    std::chrono::steady_clock::time_point m_start_time;
+    std::mutex m_mutex;
+    std::condition_variable_any m_condition;
+    std::jthread m_thread;
+};
+
+// Names the shared-memory region that the publishers of the run write to; none is
+// created unless one is named.
+void
+set_statistics_region_name( const std::string_view name );
+
+}
@@ -0,0 +1,203 @@
+#include "StatisticsRegion.hpp"
+#include <system_error>
+#include <stdexcept>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include "PlatformMacros.hpp"
+
+#if PLATFORM_NAME != OS_WINDOWS
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+[[ nodiscard ]] constexpr std::size_t
+get_region_size( const std::uint32_t connection_count ) noexcept
+{
+    return sizeof( statistics_region_header_t ) +
+           connection_count * statistics_word_count<statistics_connection_t> * sizeof( std::atomic<std::uint64_t> );
+}
+
+[[ nodiscard ]] statistics_region_header_t&
+get_region_header( std::byte* const mapping ) noexcept
+{
+    return *std::launder( reinterpret_cast<statistics_region_header_t*>( mapping ) );
+}
+
+[[ nodiscard ]] std::atomic<std::uint64_t>*
+get_connection_words( std::byte* const mapping ) noexcept
+{
+    return std::launder( reinterpret_cast<std::atomic<std::uint64_t>*>( mapping + sizeof( statistics_region_header_t ) ) );
+}
+
+}
+
+
+StatisticsRegionWriter::StatisticsRegionWriter( const std::string_view name, const std::uint32_t connection_count,
+                                                const std::chrono::nanoseconds publish_interval )
+    : m_segment { name, get_region_size( connection_count ),
+                  std::filesystem::perms::owner_read | std::filesystem::perms::owner_write |
+                  std::filesystem::perms::group_read | std::filesystem::perms::others_read }
+{
+    auto* const mapping { m_segment.get_data( ) };
+    auto& header { *::new ( mapping ) statistics_region_header_t { } };
+    std::uninitialized_value_construct_n( get_connection_words( mapping ),
+                                          connection_count * statistics_word_count<statistics_connection_t> );
+
+    header.version = statistics_region_header_t::current_version;
+    header.connection_count = connection_count;
+    header.publish_interval_ns = static_cast<std::uint64_t>( publish_interval.count( ) );
+#if PLATFORM_NAME != OS_WINDOWS
+    header.process_id = static_cast<std::uint64_t>( ::getpid( ) );
+#endif
+
+    // A reader only looks past the magic once it is there.
+    std::atomic_thread_fence( std::memory_order_release );
+    header.magic = statistics_region_header_t::expected_magic;
+}
+
+void
+StatisticsRegionWriter::publish( const statistics_snapshot_t& snapshot,
+                                 const std::span<const statistics_connection_t> connections ) noexcept
+{
+    auto& header { get_region_header( m_segment.get_data( ) ) };
+    auto* const connection_words { get_connection_words( m_segment.get_data( ) ) };
+    const auto connection_count { std::min( std::size( connections ), std::size_t { header.connection_count } ) };
+
+    const auto sequence { header.sequence.load( std::memory_order_relaxed ) };
+    header.sequence.store( sequence + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    util::store_statistics_words( std::data( header.snapshot_words ), snapshot );
+
+    for ( auto connection_idx { 0uz }; connection_idx < connection_count; ++connection_idx )
+    {
+        util::store_statistics_words( connection_words + connection_idx * statistics_word_count<statistics_connection_t>,
+                                      connections[ connection_idx ] );
+    }
+
+    header.sequence.store( sequence + 2, std::memory_order_release );
+}
+
+StatisticsRegionReader::StatisticsRegionReader( const std::string_view name )
+    : m_mapping { },
+      m_mapping_size { }
+{
+#if PLATFORM_NAME != OS_WINDOWS
+    const auto path { util::get_shared_memory_path( name ) };
+    const int file_descriptor { ::shm_open( path.c_str( ), O_RDONLY, 0 ) };
+
+    if ( file_descriptor == -1 )
+    {
+        throw util::make_system_error( "Failure in opening the statistics region" );
+    }
+
+    struct stat status;
+
+    if ( ::fstat( file_descriptor, &status ) == -1 )
+    {
+        const auto error { util::make_system_error( "Failure in sizing up the statistics region" ) };
+        ::close( file_descriptor );
+
+        throw error;
+    }
+
+    m_mapping_size = static_cast<std::size_t>( status.st_size );
+
+    if ( m_mapping_size < sizeof( statistics_region_header_t ) )
+    {
+        ::close( file_descriptor );
+
+        throw std::runtime_error { "not a statistics region of the simulator" };
+    }
+
+    void* const mapping { ::mmap( nullptr, m_mapping_size, PROT_READ, MAP_SHARED, file_descriptor, 0 ) };
+    ::close( file_descriptor );
+
+    if ( mapping == MAP_FAILED )
+    {
+        throw util::make_system_error( "Failure in mapping the statistics region" );
+    }
+
+    m_mapping = static_cast<std::byte*>( mapping );
+#else
+    throw std::system_error { std::make_error_code( std::errc::not_supported ), "Statistics regions are not supported" };
+#endif
+
+    const auto& header { get_header( ) };
+    const bool is_region { header.magic == statistics_region_header_t::expected_magic };
+    std::atomic_thread_fence( std::memory_order_acquire );
+
+    const char* error_message { nullptr };
+
+    if ( is_region == false )
+    {
+        error_message = "not a statistics region of the simulator";
+    }
+    else if ( header.version != statistics_region_header_t::current_version ||
+              m_mapping_size < get_region_size( header.connection_count ) )
+    {
+        error_message = "unsupported version of the statistics region";
+    }
+
+    if ( error_message != nullptr )
+    {
+#if PLATFORM_NAME != OS_WINDOWS
+        ::munmap( m_mapping, m_mapping_size );
+#endif
+
+        throw std::runtime_error { error_message };
+    }
+}
+
+StatisticsRegionReader::~StatisticsRegionReader( )
+{
+#if PLATFORM_NAME != OS_WINDOWS
+    ::munmap( m_mapping, m_mapping_size );
+#endif
+}
+
+[[ nodiscard ]] const statistics_region_header_t&
+StatisticsRegionReader::get_header( ) const noexcept
+{
+    return get_region_header( m_mapping );
+}
+
+[[ nodiscard ]] bool
+StatisticsRegionReader::try_read( statistics_snapshot_t& snapshot_OUT,
+                                  const std::span<statistics_connection_t> connections_OUT ) const noexcept
+{
+    const auto& header { get_header( ) };
+    const auto* const connection_words { get_connection_words( m_mapping ) };
+    const auto connection_count { std::min( std::size( connections_OUT ), std::size_t { header.connection_count } ) };
+
+    const auto sequence { header.sequence.load( std::memory_order_acquire ) };
+
+    if ( sequence % 2 != 0 )
+    {
+        return false;
+    }
+
+    snapshot_OUT = util::load_statistics_words<statistics_snapshot_t>( std::data( header.snapshot_words ) );
+
+    for ( auto connection_idx { 0uz }; connection_idx < connection_count; ++connection_idx )
+    {
+        connections_OUT[ connection_idx ] = util::load_statistics_words<statistics_connection_t>(
+                                                connection_words + connection_idx * statistics_word_count<statistics_connection_t> );
+    }
+
+    std::atomic_thread_fence( std::memory_order_acquire );
+
+    return header.sequence.load( std::memory_order_relaxed ) == sequence;
+}
+
+}
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <span>
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
+#include "SharedMemory.hpp"
+
+
+namespace simple_network_simulation
+{
+
+// The statistics that a running simulator publishes for sns-top: the totals of its event
+// counters and of the calls into each layer, with their latencies if they are recorded.
+// The structs are made of 64-bit words only, so that they can be copied word by word in
+// and out of the shared memory.
+struct statistics_layer_t
+{
+    std::uint64_t call_count;
+    std::uint64_t p50_ns;
+    std::uint64_t p90_ns;
+    std::uint64_t p99_ns;
+    std::uint64_t p999_ns;
+    std::uint64_t max_ns;
+};
+
+inline constexpr auto statistics_layer_count { 4uz };   // as many as latency_layer_t has
+
+struct statistics_snapshot_t
+{
+    std::uint64_t elapsed_time_ns;          // since the simulator started publishing
+    std::uint64_t sent_message_count;
+    std::uint64_t received_message_count;
+    std::uint64_t sent_segment_count;
+    std::uint64_t flipped_bit_count;
+    std::uint64_t detected_corruption_count;
+    std::uint64_t undetected_corruption_count;
+    std::uint64_t closed_connection_count;
+    std::uint64_t are_latencies_recorded;   // 1 if the layers carry latencies, 0 otherwise
+    std::uint64_t is_finished;              // 1 once the run is over, 0 before
+    std::array<statistics_layer_t, statistics_layer_count> layers;  // indexed by latency_layer_t
+};
+
+struct statistics_connection_t
+{
+    std::uint64_t sent_message_count;
+    std::uint64_t received_message_count;
+    std::uint64_t corruption_count;
+};
+
+template <class T>
+inline constexpr auto statistics_word_count { sizeof( T ) / sizeof( std::uint64_t ) };
+
+static_assert( sizeof( statistics_snapshot_t ) % sizeof( std::uint64_t ) == 0 );
+static_assert( sizeof( statistics_connection_t ) % sizeof( std::uint64_t ) == 0 );
+static_assert( std::atomic<std::uint64_t>::is_always_lock_free, "the region is shared between processes" );
+
+// The region starts with this header and is followed by the words of connection_count
+// statistics_connection_t. The writer guards the snapshot and the connections with a
+// seqlock: it makes the sequence odd, stores the words and makes it even again, so that
+// it never waits for the readers, while a reader that sees the sequence change under it
+// knows that what it copied is torn and tries again.
+struct statistics_region_header_t
+{
+    static constexpr std::array<char, 8> expected_magic { 'S', 'N', 'S', 'S', 'T', 'A', 'T', 'S' };
+    static constexpr std::uint32_t current_version { 1 };
+
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t connection_count;
+    std::uint64_t process_id;
+    std::uint64_t publish_interval_ns;
+    alignas( 64 ) std::atomic<std::uint64_t> sequence;
+    std::array<std::atomic<std::uint64_t>, statistics_word_count<statistics_snapshot_t>> snapshot_words;
+};
+
+// Creates the shared-memory segment of the region, replacing any left over under the same
+// name, and removes it once destroyed.
+class StatisticsRegionWriter
+{
+public:
+    // Throws std::system_error if the segment cannot be created or mapped.
+    StatisticsRegionWriter( const std::string_view name, const std::uint32_t connection_count,
+                            const std::chrono::nanoseconds publish_interval );
+
+    StatisticsRegionWriter( const StatisticsRegionWriter& ) = delete;
+    StatisticsRegionWriter& operator=( const StatisticsRegionWriter& ) = delete;
+
+    // Must only be called by one thread at a time; connections holds at most as many
+    // connections as the region does.
+    void
+    publish( const statistics_snapshot_t& snapshot, const std::span<const statistics_connection_t> connections ) noexcept;
+
+private:
+    util::SharedMemorySegment m_segment;
+};
+
+// Maps the region of a simulator for reading.
+class StatisticsRegionReader
+{
+public:
+    // Throws std::system_error if the segment cannot be opened or mapped, and
+    // std::runtime_error if it is not a region of a supported version.
+    explicit
+    StatisticsRegionReader( const std::string_view name );
+
+    StatisticsRegionReader( const StatisticsRegionReader& ) = delete;
+    StatisticsRegionReader& operator=( const StatisticsRegionReader& ) = delete;
+
+    ~StatisticsRegionReader( );
+
+    [[ nodiscard ]] const statistics_region_header_t&
+    get_header( ) const noexcept;
+
+    // Copies the snapshot and the first connections out of the region, and returns false
+    // if the writer published in the meantime, in which case they are torn.
+    [[ nodiscard ]] bool
+    try_read( statistics_snapshot_t& snapshot_OUT, const std::span<statistics_connection_t> connections_OUT ) const noexcept;
+
+private:
+    std::byte* m_mapping;
+    std::size_t m_mapping_size;
+};
+
+namespace util
+{
+
+template <class T>
+void inline
+store_statistics_words( std::atomic<std::uint64_t>* const words_OUT, const T& value ) noexcept
+{
+    const auto value_words { std::bit_cast<std::array<std::uint64_t, statistics_word_count<T>>>( value ) };
+
+    for ( auto word_idx { 0uz }; word_idx < std::size( value_words ); ++word_idx )
+    {
+        words_OUT[ word_idx ].store( value_words[ word_idx ], std::memory_order_relaxed );
+    }
+}
+
+template <class T>
+[[ nodiscard ]] T inline
+load_statistics_words( const std::atomic<std::uint64_t>* const words ) noexcept
+{
+    std::array<std::uint64_t, statistics_word_count<T>> value_words;
+
+    for ( auto word_idx { 0uz }; word_idx < std::size( value_words ); ++word_idx )
+    {
+        value_words[ word_idx ] = words[ word_idx ].load( std::memory_order_relaxed );
+    }
+
+    return std::bit_cast<T>( value_words );
+}
+
+}
+
+}
@@ -0,0 +1,564 @@
+#include "Sweep.hpp"
+#include <array>
+#include <span>
+#include <vector>
+#include <string_view>
+#include <charconv>
+#include <expected>
+#include <system_error>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "BidirectionalMultimessageSimulation.hpp"
+#include "ChannelFaults.hpp"
+#include "ReliableTransport.hpp"
+#include "ThreadPool.hpp"
+#include "Topology.hpp"
+
+
+using std::uint32_t;
+using std::uint64_t;
+using std::size_t;
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+using std::string_view_literals::operator""sv;
+
+// Indexed by sweep_fault_model_t.
+constexpr std::array sweep_fault_model_names { "ber"sv, "burst"sv, "loss"sv, "duplicate"sv, "reorder"sv };
+
+constexpr auto max_values_per_axis { 1000uz };
+constexpr auto max_point_count { 10'000uz };
+
+// The replications of a point run in batches of this many, and the sweep only checks
+// whether a point has converged in between, so that how many replications a point gets
+// does not depend on the number of threads.
+constexpr auto replications_per_batch { 32u };
+
+constexpr auto default_confidence_width { 0.01 };
+constexpr auto default_max_replication_count { 10'000u };
+
+// A burst lasts for 10 bits on average and flips half of them.
+constexpr auto sweep_burst_exit_probability { 0.1 };
+constexpr auto sweep_burst_bit_error_rate { 0.5 };
+
+constinit sweep_specification_t configured_sweep_specification { };
+constinit auto sweep_confidence_width { default_confidence_width };
+constinit auto sweep_max_replication_count { default_max_replication_count };
+
+[[ nodiscard ]] std::expected<sweep_fault_model_t, std::errc>
+parse_sweep_fault_model( const std::string_view name ) noexcept
+{
+    const auto it { std::ranges::find( sweep_fault_model_names, name ) };
+
+    if ( it == std::cend( sweep_fault_model_names ) )
+    {
+        return std::unexpected { std::errc::invalid_argument };
+    }
+
+    return static_cast<sweep_fault_model_t>( std::distance( std::cbegin( sweep_fault_model_names ), it ) );
+}
+
+[[ nodiscard ]] std::expected<bool, std::errc>
+parse_layers_delays( const std::string_view name ) noexcept
+{
+    if ( name == "on"sv || name == "off"sv )
+    {
+        return name == "on"sv;
+    }
+
+    return std::unexpected { std::errc::invalid_argument };
+}
+
+template <class Number>
+[[ nodiscard ]] std::expected<Number, std::errc>
+parse_number( const std::string_view text ) noexcept
+{
+    const auto text_end { std::data( text ) + std::size( text ) };
+
+    Number value { };
+    const auto [ ptr, err_code ] { std::from_chars( std::data( text ), text_end, value ) };
+
+    if ( err_code != std::errc { } )
+    {
+        return std::unexpected { err_code };
+    }
+
+    if ( std::empty( text ) || ptr != text_end )
+    {
+        return std::unexpected { std::errc::invalid_argument };
+    }
+
+    return value;
+}
+
+// Expands a range FROM..TO, FROM..TO:STEP or FROM..TO:xFACTOR into values_OUT.
+template <class Number>
+[[ nodiscard ]] std::errc
+expand_range( const std::string_view range, std::vector<Number>& values_OUT )
+{
+    const auto dots_pos { range.find( ".."sv ) };
+    const auto colon_pos { range.find( ':', dots_pos ) };
+    const auto step_text { colon_pos == std::string_view::npos ? std::string_view { } : range.substr( colon_pos + 1 ) };
+    const bool is_geometric { step_text.starts_with( 'x' ) };
+
+    const auto from { parse_number<Number>( range.substr( 0, dots_pos ) ) };
+    const auto to { parse_number<Number>( range.substr( dots_pos + 2, colon_pos - ( dots_pos + 2 ) ) ) };
+    const auto step { std::empty( step_text ) ? Number { 1 }
+                                              : parse_number<Number>( is_geometric ? step_text.substr( 1 ) : step_text )
+                                                .value_or( Number { } ) };
+
+    if ( from.has_value( ) == false || to.has_value( ) == false )
+    {
+        return from.has_value( ) ? to.error( ) : from.error( );
+    }
+
+    const bool is_step_valid { is_geometric ? ( step > Number { 1 } && *from > Number { 0 } ) : step > Number { 0 } };
+
+    if ( is_step_valid == false || *to < *from )
+    {
+        return std::errc::argument_out_of_domain;
+    }
+
+    // Steps in doubles, which hold any integer value exactly and cannot wrap around, and
+    // lets a geometric range reach its end despite the rounding on the way.
+    const auto end { static_cast<double>( *to ) * ( 1.0 + 1e-9 ) };
+
+    for ( auto value { static_cast<double>( *from ) }; value <= end;
+          value = is_geometric ? value * static_cast<double>( step ) : value + static_cast<double>( step ) )
+    {
+        if ( std::size( values_OUT ) == max_values_per_axis )
+        {
+            return std::errc::value_too_large;
+        }
+
+        values_OUT.push_back( std::min( static_cast<Number>( value ), *to ) );
+    }
+
+    return std::errc { };
+}
+
+// Parses a slash-separated list of values, or of ranges if there is a number parser.
+template <class Value, class ParseValue>
+[[ nodiscard ]] std::errc
+parse_axis( std::string_view text, std::vector<Value>& values_OUT, ParseValue&& parse_value )
+{
+    values_OUT.clear( );
+
+    while ( std::empty( text ) == false )
+    {
+        const auto separator_pos { text.find( '/' ) };
+        const auto item { text.substr( 0, separator_pos ) };
+        text.remove_prefix( separator_pos == std::string_view::npos ? std::size( text ) : separator_pos + 1 );
+
+        if constexpr ( std::is_arithmetic_v<Value> && std::is_same_v<Value, bool> == false )
+        {
+            if ( item.find( ".."sv ) != std::string_view::npos )
+            {
+                if ( const auto result { expand_range( item, values_OUT ) }; result != std::errc { } )
+                {
+                    return result;
+                }
+
+                continue;
+            }
+        }
+
+        const auto value { parse_value( item ) };
+
+        if ( value.has_value( ) == false )
+        {
+            return value.error( );
+        }
+
+        if ( std::size( values_OUT ) == max_values_per_axis )
+        {
+            return std::errc::value_too_large;
+        }
+
+        values_OUT.push_back( *value );
+    }
+
+    return std::empty( values_OUT ) ? std::errc::invalid_argument : std::errc { };
+}
+
+[[ nodiscard ]] channel_fault_model_t
+make_channel_fault_model( const sweep_fault_model_t fault_model, const double probability ) noexcept
+{
+    channel_fault_model_t model { };
+
+    switch ( fault_model )
+    {
+        case sweep_fault_model_t::bit_errors:
+            model.bit_error_rate = probability;
+            break;
+        case sweep_fault_model_t::bursts:
+            model.burst = burst_error_model_t { probability, sweep_burst_exit_probability, sweep_burst_bit_error_rate };
+            break;
+        case sweep_fault_model_t::losses:
+            model.loss_probability = probability;
+            break;
+        case sweep_fault_model_t::duplicates:
+            model.duplication_probability = probability;
+            break;
+        case sweep_fault_model_t::reorderings:
+            model.reordering_probability = probability;
+            break;
+        default:
+            break;
+    }
+
+    return model;
+}
+
+// The quantile of the Student's t-distribution that bounds a two-sided 95% confidence
+// interval, by the Cornish-Fisher expansion around the normal quantile, which is within
+// 0.1% of the exact value from 8 degrees of freedom on.
+[[ nodiscard ]] double
+get_student_t_quantile( const double degrees_of_freedom ) noexcept
+{
+    constexpr auto z { 1.959963984540054 };
+    constexpr auto z3 { z * z * z };
+    constexpr auto z5 { z3 * z * z };
+    constexpr auto z7 { z5 * z * z };
+
+    const auto v { degrees_of_freedom };
+
+    return z + ( z3 + z ) / ( 4.0 * v ) + ( 5.0 * z5 + 16.0 * z3 + 3.0 * z ) / ( 96.0 * v * v ) +
+           ( 3.0 * z7 + 19.0 * z5 + 17.0 * z3 - 15.0 * z ) / ( 384.0 * v * v * v );
+}
+
+// Accumulates the mean and the variance of a quantity in a single pass (Welford).
+struct [[ nodiscard ]] running_estimate_t
+{
+    uint64_t sample_count;
+    double mean;
+    double squared_deviation_sum;
+
+    void
+    add( const double sample ) noexcept
+    {
+        ++sample_count;
+
+        const auto deviation { sample - mean };
+        mean += deviation / static_cast<double>( sample_count );
+        squared_deviation_sum += deviation * ( sample - mean );
+    }
+
+    [[ nodiscard ]] sweep_estimate_t
+    get_estimate( ) const noexcept
+    {
+        if ( sample_count < 2 )
+        {
+            return sweep_estimate_t { mean, 0.0 };
+        }
+
+        const auto degrees_of_freedom { static_cast<double>( sample_count - 1 ) };
+        const auto standard_error { std::sqrt( squared_deviation_sum / degrees_of_freedom /
+                                               static_cast<double>( sample_count ) ) };
+
+        return sweep_estimate_t { mean, get_student_t_quantile( degrees_of_freedom ) * standard_error };
+    }
+};
+
+// Connects as many processes per node as the ports allow, and lays out as many pairs of
+// nodes as the connections need, dropping the ones beyond the count from the last pair.
+[[ nodiscard ]] std::pair<uint32_t, uint32_t>
+get_topology_dimensions( const uint32_t connection_count ) noexcept
+{
+    const auto processes_per_node { validate_processes_per_node( connection_count ) == std::errc { }
+                                    ? connection_count : default_processes_per_node };
+    const auto node_pair_count { ( connection_count + processes_per_node - 1 ) / processes_per_node };
+
+    return { 2 * node_pair_count, processes_per_node };
+}
+
+[[ nodiscard ]] topology_t
+generate_sweep_topology( const uint32_t connection_count )
+{
+    const auto [ node_count, processes_per_node ] { get_topology_dimensions( connection_count ) };
+
+    auto topology { generate_topology( node_count, processes_per_node ) };
+    topology.connections.resize( connection_count );
+
+    return topology;
+}
+
+[[ nodiscard ]] connection_statistics_t
+execute_replication( const topology_t& topology, const uint32_t replication )
+{
+    connection_statistics_t statistics { };
+
+    for ( auto connection_idx { 0u }; connection_idx < std::size( topology.connections ); ++connection_idx )
+    {
+        Connection connection { topology, connection_idx, 0, replication };
+
+        while ( connection.step( ) ) { }
+
+        statistics += connection.get_statistics( );
+    }
+
+    return statistics;
+}
+
+// Runs the replications of the point that is configured, a batch at a time, until the
+// confidence interval of its goodput is narrow enough.
+void
+execute_sweep_point( util::WorkStealingThreadPool& pool, sweep_point_t& point )
+{
+    const topology_t topology { generate_sweep_topology( point.connection_count ) };
+
+    std::vector<connection_statistics_t> batch_statistics( replications_per_batch );
+    running_estimate_t goodput { };
+    running_estimate_t round_trip_latency { };
+
+    for ( auto first_replication { 0u }; first_replication < sweep_max_replication_count;
+          first_replication += replications_per_batch )
+    {
+        const auto batch_size { std::min( replications_per_batch, sweep_max_replication_count - first_replication ) };
+
+        for ( auto idx { 0u }; idx < batch_size; ++idx )
+        {
+            pool.submit( [ &topology, &batch_statistics, first_replication, idx ]
+                         {
+                             batch_statistics[ idx ] = execute_replication( topology, first_replication + idx );
+                         } );
+        }
+
+        pool.wait( );
+
+        // Goes over the replications in order, so that the estimates come out the same
+        // whatever order the workers finished them in.
+        for ( const auto& statistics : std::span { batch_statistics }.first( batch_size ) )
+        {
+            goodput.add( statistics.segment_count == 0 ? 0.0 : static_cast<double>( statistics.delivered_message_count ) /
+                                                               static_cast<double>( statistics.segment_count ) );
+
+            if ( statistics.round_trip_count != 0 )
+            {
+                const std::chrono::duration<double> latency_sum { statistics.round_trip_latency_sum };
+                round_trip_latency.add( latency_sum.count( ) / static_cast<double>( statistics.round_trip_count ) );
+            }
+
+            point.corruption_count += statistics.corruption_count + statistics.correction_count +
+                                      statistics.undetected_corruption_count;
+            point.undetected_corruption_count += statistics.undetected_corruption_count;
+        }
+
+        point.replication_count += batch_size;
+        point.goodput = goodput.get_estimate( );
+        point.round_trip_latency = round_trip_latency.get_estimate( );
+
+        if ( 2.0 * point.goodput.half_width <= sweep_confidence_width )
+        {
+            point.is_converged = true;
+
+            break;
+        }
+    }
+}
+
+}
+
+
+[[ nodiscard ]] std::expected<sweep_specification_t, std::errc>
+parse_sweep_specification( std::string_view specification )
+{
+    sweep_specification_t sweep { { sweep_fault_model_t::bit_errors }, { 1e-3 }, { false },
+                                  { default_processes_per_node }, { arq_protocol_t::none }, { 0u } };
+
+    while ( std::empty( specification ) == false )
+    {
+        const auto separator_pos { specification.find( ',' ) };
+        const auto axis { specification.substr( 0, separator_pos ) };
+        specification.remove_prefix( separator_pos == std::string_view::npos ? std::size( specification )
+                                                                             : separator_pos + 1 );
+
+        const auto equals_sign_pos { axis.find( '=' ) };
+
+        if ( equals_sign_pos == std::string_view::npos )
+        {
+            return std::unexpected { std::errc::invalid_argument };
+        }
+
+        const auto key { axis.substr( 0, equals_sign_pos ) };
+        const auto values_text { axis.substr( equals_sign_pos + 1 ) };
+
+        auto result { std::errc { } };
+
+        if ( key == "model"sv )
+        {
+            result = parse_axis( values_text, sweep.fault_models, parse_sweep_fault_model );
+        }
+        else if ( key == "p"sv )
+        {
+            result = parse_axis( values_text, sweep.fault_probabilities, parse_number<double> );
+
+            if ( result == std::errc { } &&
+                 std::ranges::all_of( sweep.fault_probabilities, [ ]( const double p ) noexcept { return p >= 0.0 && p <= 1.0; } ) == false )
+            {
+                result = std::errc::argument_out_of_domain;
+            }
+        }
+        else if ( key == "delays"sv )
+        {
+            result = parse_axis( values_text, sweep.layers_delays, parse_layers_delays );
+        }
+        else if ( key == "connections"sv )
+        {
+            result = parse_axis( values_text, sweep.connection_counts, parse_number<uint32_t> );
+
+            for ( const auto connection_count : sweep.connection_counts )
+            {
+                if ( result == std::errc { } )
+                {
+                    result = connection_count == 0 ? std::errc::argument_out_of_domain
+                                                   : validate_node_count( get_topology_dimensions( connection_count ).first );
+                }
+            }
+        }
+        else if ( key == "arq"sv )
+        {
+            result = parse_axis( values_text, sweep.arq_protocols, parse_arq_protocol );
+        }
+        else if ( key == "window"sv )
+        {
+            result = parse_axis( values_text, sweep.window_sizes, parse_number<uint32_t> );
+
+            for ( const auto window_size : sweep.window_sizes )
+            {
+                if ( result == std::errc { } )
+                {
+                    result = validate_arq_window_size( window_size );
+                }
+            }
+        }
+        else
+        {
+            result = std::errc::invalid_argument;
+        }
+
+        if ( result != std::errc { } )
+        {
+            return std::unexpected { result };
+        }
+    }
+
+    const auto point_count { std::size( sweep.fault_models ) * std::size( sweep.fault_probabilities ) *
+                             std::size( sweep.layers_delays ) * std::size( sweep.connection_counts ) *
+                             std::size( sweep.arq_protocols ) * std::size( sweep.window_sizes ) };
+
+    if ( point_count > max_point_count )
+    {
+        return std::unexpected { std::errc::value_too_large };
+    }
+
+    return sweep;
+}
+
+void
+set_sweep_specification( sweep_specification_t specification ) noexcept
+{
+    configured_sweep_specification = std::move( specification );
+}
+
+void
+set_sweep_confidence_width( const double confidence_width ) noexcept
+{
+    sweep_confidence_width = confidence_width;
+}
+
+void
+set_sweep_max_replication_count( const uint32_t max_replication_count ) noexcept
+{
+    sweep_max_replication_count = max_replication_count;
+}
+
+[[ nodiscard ]] std::string_view
+get_sweep_fault_model_name( const sweep_fault_model_t fault_model ) noexcept
+{
+    return sweep_fault_model_names[ std::to_underlying( fault_model ) ];
+}
+
+[[ nodiscard ]] sweep_report_t
+execute_sweep( )
+{
+    const auto start_time { std::chrono::steady_clock::now( ) };
+    const auto& sweep { configured_sweep_specification };
+
+    // A sweep has no use for the wall clock, and its latencies are simulated ones.
+    set_virtual_time( true );
+
+    util::WorkStealingThreadPool pool { get_thread_count( ) };
+    sweep_report_t report { };
+
+    for ( const auto fault_model : sweep.fault_models )
+    {
+        for ( const auto fault_probability : sweep.fault_probabilities )
+        {
+            const auto channel_fault_model { make_channel_fault_model( fault_model, fault_probability ) };
+            set_channel_fault_model( channel_direction_t::forward, channel_fault_model );
+            set_channel_fault_model( channel_direction_t::backward, channel_fault_model );
+
+            for ( const bool are_layers_delays_enabled : sweep.layers_delays )
+            {
+                set_layers_delays( are_layers_delays_enabled );
+
+                for ( const auto connection_count : sweep.connection_counts )
+                {
+                    for ( const auto arq_protocol : sweep.arq_protocols )
+                    {
+                        // Nothing overtakes the single segment in flight of a connection
+                        // without a reliable transport.
+                        if ( fault_model == sweep_fault_model_t::reorderings && arq_protocol == arq_protocol_t::none )
+                        {
+                            continue;
+                        }
+
+                        set_arq_protocol( arq_protocol );
+
+                        for ( const auto window_size : sweep.window_sizes )
+                        {
+                            // Without a reliable transport there is a single message in
+                            // flight whatever the window, and a window wider than the
+                            // protocol allows would only repeat the widest one.
+                            if ( arq_protocol == arq_protocol_t::none ? window_size != sweep.window_sizes.front( )
+                                                                      : window_size > get_max_arq_window_size( arq_protocol ) )
+                            {
+                                continue;
+                            }
+
+                            set_arq_window_size( arq_protocol == arq_protocol_t::none ? 0 : window_size );
+
+                            sweep_point_t point { };
+                            point.fault_model = fault_model;
+                            point.fault_probability = fault_probability;
+                            point.are_layers_delays_enabled = are_layers_delays_enabled;
+                            point.connection_count = connection_count;
+                            point.arq_protocol = arq_protocol;
+                            point.window_size = get_arq_window_size( );
+
+                            execute_sweep_point( pool, point );
+                            report.points.push_back( point );
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    report.random_seed = get_random_seed( );
+    report.elapsed_time = std::chrono::steady_clock::now( ) - start_time;
+
+    return report;
+}
+
+}
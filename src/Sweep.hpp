@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <string_view>
+#include <expected>
+#include <system_error>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "BidirectionalMultimessageSimulation.hpp"
+
+
+namespace simple_network_simulation
+{
+
+// The fault models that a sweep can put both directions of the channel under, each of
+// which is driven by a single probability.
+enum class sweep_fault_model_t : std::uint8_t
+{
+    bit_errors,     // independent bit errors at that rate
+    bursts,         // error bursts entered at that rate, 10 bits long on average, flipping half of their bits
+    losses,
+    duplicates,
+    reorderings
+};
+
+// The axes of a parameter sweep, which runs every combination of their values. A window
+// size of 0 stands for the widest window the protocol allows.
+struct [[ nodiscard ]] sweep_specification_t
+{
+    std::vector<sweep_fault_model_t> fault_models;
+    std::vector<double> fault_probabilities;
+    std::vector<bool> layers_delays;
+    std::vector<std::uint32_t> connection_counts;
+    std::vector<arq_protocol_t> arq_protocols;
+    std::vector<std::uint32_t> window_sizes;
+};
+
+// Parses a comma-separated list of axes such as "model=ber/burst,p=1e-5..1e-2:x10",
+// with the keys model (ber, burst, loss, duplicate, reorder), p, delays (off, on),
+// connections, arq and window. An axis takes a slash-separated list of values, or for
+// the numeric ones a range FROM..TO that steps by 1, by :STEP or by a factor of :xFACTOR.
+// The axes left out keep a single value: ber, 1e-3, off, 2, none and 0 respectively.
+[[ nodiscard ]] std::expected<sweep_specification_t, std::errc>
+parse_sweep_specification( const std::string_view specification );
+
+void
+set_sweep_specification( sweep_specification_t specification ) noexcept;
+
+// The sweep moves on from a point once the 95% confidence interval of its goodput is no
+// wider than this, or once it has run the maximum number of replications.
+void
+set_sweep_confidence_width( const double confidence_width ) noexcept;
+
+void
+set_sweep_max_replication_count( const std::uint32_t max_replication_count ) noexcept;
+
+[[ nodiscard ]] std::string_view
+get_sweep_fault_model_name( const sweep_fault_model_t fault_model ) noexcept;
+
+// The mean of a quantity over the replications of a point and the half width of its
+// 95% confidence interval.
+struct [[ nodiscard ]] sweep_estimate_t
+{
+    double mean;
+    double half_width;
+};
+
+struct [[ nodiscard ]] sweep_point_t
+{
+    sweep_fault_model_t fault_model;
+    double fault_probability;
+    bool are_layers_delays_enabled;
+    std::uint32_t connection_count;
+    arq_protocol_t arq_protocol;
+    std::uint32_t window_size;
+    std::uint32_t replication_count;
+    bool is_converged;
+    sweep_estimate_t goodput;               // messages delivered intact per segment sent
+    sweep_estimate_t round_trip_latency;    // in simulated seconds
+    std::uint64_t corruption_count;
+    std::uint64_t undetected_corruption_count;
+};
+
+struct [[ nodiscard ]] sweep_report_t
+{
+    std::vector<sweep_point_t> points;
+    std::uint64_t random_seed;
+    std::chrono::nanoseconds elapsed_time;
+};
+
+// Runs the points of the configured sweep one after another, and the replications of
+// each point in parallel on a thread pool. A replication runs every connection from its
+// opening to its closing, with faults drawn from streams of its own.
+[[ nodiscard ]] sweep_report_t
+execute_sweep( );
+
+}
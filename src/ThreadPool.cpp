@@ -0,0 +1,191 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <utility>
+
+
+namespace simple_network_simulation::util
+{
+
+namespace
+{
+
+thread_local constinit const WorkStealingThreadPool* current_pool { };
+thread_local constinit std::size_t current_worker_idx { };
+
+constexpr auto idle_spin_count { 64uz };
+
+}
+
+
+WorkStealingThreadPool::WorkStealingThreadPool( const std::size_t thread_count )
+{
+    const auto worker_count { std::max( thread_count, 1uz ) };
+
+    m_queues.reserve( worker_count );
+    for ( auto worker_idx { 0uz }; worker_idx < worker_count; ++worker_idx )
+    {
+        m_queues.push_back( std::make_unique<worker_queue_t>( ) );
+    }
+
+    m_workers.reserve( worker_count );
+    for ( auto worker_idx { 0uz }; worker_idx < worker_count; ++worker_idx )
+    {
+        m_workers.emplace_back( [ this, worker_idx ]( const std::stop_token stop_token )
+                                {
+                                    run_worker( stop_token, worker_idx );
+                                } );
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool( )
+{
+    for ( auto& worker : m_workers )
+    {
+        worker.request_stop( );
+    }
+
+    m_workers.clear( );
+}
+
+void
+WorkStealingThreadPool::submit( task_type&& task )
+{
+    const auto queue_idx { current_pool == this ? current_worker_idx
+                                                : m_next_external_queue_idx.fetch_add( 1, std::memory_order_relaxed ) %
+                                                  std::size( m_queues ) };
+
+    {
+        auto& queue { *m_queues[ queue_idx ] };
+        const std::lock_guard lock { queue.mutex };
+        queue.tasks.push_back( std::move( task ) );
+
+        // Counted under the mutex of the queue, which a worker has to take to pop the task,
+        // so that neither count gets decremented ahead of its increment, and only once the
+        // task is in, so that a failed push leaves both counts as they were.
+        m_pending_task_count.fetch_add( 1 );
+
+        // Pairs with the increment of m_sleeping_worker_count by a worker that is about to
+        // sleep: either that worker sees the queued task or this thread sees the sleeper.
+        m_queued_task_count.fetch_add( 1 );
+    }
+
+    if ( m_sleeping_worker_count.load( ) > 0 )
+    {
+        {
+            const std::lock_guard lock { m_idle_mutex };
+        }
+
+        m_idle_cv.notify_one( );
+    }
+}
+
+void
+WorkStealingThreadPool::wait( ) const noexcept
+{
+    for ( auto pending_task_count { m_pending_task_count.load( ) };
+          pending_task_count != 0;
+          pending_task_count = m_pending_task_count.load( ) )
+    {
+        m_pending_task_count.wait( pending_task_count );
+    }
+}
+
+[[ nodiscard ]] std::size_t
+WorkStealingThreadPool::get_thread_count( ) const noexcept
+{
+    return std::size( m_workers );
+}
+
+void
+WorkStealingThreadPool::run_worker( const std::stop_token stop_token, const std::size_t worker_idx )
+{
+    current_pool = this;
+    current_worker_idx = worker_idx;
+
+    task_type task { };
+
+    while ( stop_token.stop_requested( ) == false )
+    {
+        if ( try_pop( worker_idx, task ) || try_steal( worker_idx, task ) )
+        {
+            task( );
+            task = nullptr;
+
+            if ( m_pending_task_count.fetch_sub( 1 ) == 1 )
+            {
+                m_pending_task_count.notify_all( );
+            }
+
+            continue;
+        }
+
+        bool is_work_available { };
+
+        for ( auto spin_idx { 0uz }; spin_idx < idle_spin_count && is_work_available == false; ++spin_idx )
+        {
+            std::this_thread::yield( );
+            is_work_available = m_queued_task_count.load( std::memory_order_relaxed ) > 0;
+        }
+
+        if ( is_work_available )
+        {
+            continue;
+        }
+
+        m_sleeping_worker_count.fetch_add( 1 );
+
+        {
+            std::unique_lock lock { m_idle_mutex };
+            m_idle_cv.wait( lock, stop_token, [ this ] { return m_queued_task_count.load( ) > 0; } );
+        }
+
+        m_sleeping_worker_count.fetch_sub( 1 );
+    }
+
+    current_pool = nullptr;
+}
+
+[[ nodiscard ]] bool
+WorkStealingThreadPool::try_pop( const std::size_t worker_idx, task_type& task_OUT )
+{
+    auto& queue { *m_queues[ worker_idx ] };
+    const std::lock_guard lock { queue.mutex };
+
+    if ( std::empty( queue.tasks ) )
+    {
+        return false;
+    }
+
+    task_OUT = std::move( queue.tasks.back( ) );
+    queue.tasks.pop_back( );
+    m_queued_task_count.fetch_sub( 1 );
+
+    return true;
+}
+
+[[ nodiscard ]] bool
+WorkStealingThreadPool::try_steal( const std::size_t thief_worker_idx, task_type& task_OUT )
+{
+    const auto queue_count { std::size( m_queues ) };
+
+    for ( auto offset { 1uz }; offset < queue_count; ++offset )
+    {
+        auto& queue { *m_queues[ ( thief_worker_idx + offset ) % queue_count ] };
+        const std::unique_lock lock { queue.mutex, std::try_to_lock };
+
+        if ( lock.owns_lock( ) == false || std::empty( queue.tasks ) )
+        {
+            continue;
+        }
+
+        task_OUT = std::move( queue.tasks.front( ) );
+        queue.tasks.pop_front( );
+        m_queued_task_count.fetch_sub( 1 );
+
+        return true;
+    }
+
+    return false;
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <stop_token>
+#include <cstddef>
+
+
+namespace simple_network_simulation::util
+{
+
+// A fixed-size pool of threads, each owning a deque of tasks. A worker pushes the
+// tasks it submits to the back of its own deque and pops them from there (LIFO, so
+// a task that resubmits itself keeps running hot in the cache), while idle workers
+// steal from the front of the others' deques (FIFO, the oldest work first).
+class WorkStealingThreadPool
+{
+public:
+    using task_type = std::move_only_function<void ( )>;
+
+    explicit
+    WorkStealingThreadPool( const std::size_t thread_count = std::thread::hardware_concurrency( ) );
+
+    WorkStealingThreadPool( const WorkStealingThreadPool& ) = delete;
+    WorkStealingThreadPool& operator=( const WorkStealingThreadPool& ) = delete;
+
+    ~WorkStealingThreadPool( );
+
+    // Callable from any thread, including the workers of the pool.
+    void
+    submit( task_type&& task );
+
+    // Blocks until every submitted task, including the ones submitted by tasks, has run.
+    void
+    wait( ) const noexcept;
+
+    [[ nodiscard ]] std::size_t
+    get_thread_count( ) const noexcept;
+
+private:
+    struct alignas( 64 ) worker_queue_t
+    {
+        std::mutex mutex;
+        std::deque<task_type> tasks;
+    };
+
+    void
+    run_worker( const std::stop_token stop_token, const std::size_t worker_idx );
+
+    [[ nodiscard ]] bool
+    try_pop( const std::size_t worker_idx, task_type& task_OUT );
+
+    [[ nodiscard ]] bool
+    try_steal( const std::size_t thief_worker_idx, task_type& task_OUT );
+
+    std::vector< std::unique_ptr<worker_queue_t> > m_queues;
+    alignas( 64 ) std::atomic<std::size_t> m_queued_task_count { };
+    alignas( 64 ) std::atomic<std::size_t> m_pending_task_count { };
+    alignas( 64 ) std::atomic<std::size_t> m_sleeping_worker_count { };
+    std::atomic<std::size_t> m_next_external_queue_idx { };
+    std::mutex m_idle_mutex;
+    std::condition_variable_any m_idle_cv;
+    std::vector<std::jthread> m_workers;
+};
+
+}
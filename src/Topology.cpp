@@ -0,0 +1,203 @@
+#include "Topology.hpp"
+#include <array>
+#include <chrono>
+#include <utility>
+#include <optional>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include "BidirectionalMultimessageSimulation.hpp"
+
+
+using std::uint8_t;
+using std::uint32_t;
+using std::size_t;
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+constinit auto configured_node_count { default_node_count };
+constinit auto configured_processes_per_node { default_processes_per_node };
+constinit std::optional<topology_t> configured_topology { };
+
+constexpr uint32_t first_node_first_port_num { 5001 };
+constexpr uint32_t ports_per_node_range { 2000 };
+constexpr uint32_t max_node_count { ( std::numeric_limits<uint32_t>::max( ) - first_node_first_port_num ) /
+                                    ports_per_node_range + 1 };
+
+using std::chrono_literals::operator""ms;
+
+// Indexed by the parity of the node index and then by the parity of the process index.
+constexpr std::array< std::array<std::chrono::milliseconds, 2>, 2 > application_layer_default_delays { {
+    { 450ms, 500ms },
+    { 550ms, 440ms }
+} };
+
+constexpr std::array transport_to_layer_default_delays   { 990ms, 1010ms };
+constexpr std::array transport_from_layer_default_delays { 1110ms, 1070ms };
+
+constexpr std::array<uint8_t, 5> protocol1_request_payloads { 0b0000'0000, 0b0000'0001, 0b0000'0010,
+                                                              0b0000'0011, 0b0000'0111 };
+
+constexpr std::array< std::pair<uint8_t, uint8_t>, 4 > protocol1_response_payloads { {
+    { 0b0000'0000, 0b1001'1000 },
+    { 0b0000'0001, 0b1010'1000 },
+    { 0b0000'0010, 0b1011'1000 },
+    { 0b0000'0011, 0b1111'1000 }
+} };
+
+constexpr std::array<uint8_t, 5> protocol2_request_payloads { 0b1010'1010, 0b1010'1011, 0b1010'1100,
+                                                              0b1010'1101, 0b1010'1111 };
+
+constexpr std::array< std::pair<uint8_t, uint8_t>, 4 > protocol2_response_payloads { {
+    { 0b1010'1010, 0b0100'0000 },
+    { 0b1010'1011, 0b1000'0001 },
+    { 0b1010'1100, 0b1100'0010 },
+    { 0b1010'1101, 0b1110'0011 }
+} };
+
+// Generated at compile time, so that the built-in dialogues cost nothing to set up.
+constexpr std::array builtin_protocols { make_application_protocol( protocol1_request_payloads,
+                                                                    protocol1_response_payloads,
+                                                                    0b1001'1111,
+                                                                    0b1001'1111 ),
+                                         make_application_protocol( protocol2_request_payloads,
+                                                                    protocol2_response_payloads,
+                                                                    0b1000'1111,
+                                                                    0b1000'1111 ) };
+
+static_assert( builtin_protocols[ 0 ].request_payloads[ max_request_count - 1 ] == 0b0000'0111 );
+static_assert( builtin_protocols[ 0 ].response_payloads[ 0b0000'0011 ] == 0b1111'1000 );
+static_assert( builtin_protocols[ 1 ].response_payloads[ 0b1010'1111 ] == 0b1000'1111 );
+
+}
+
+
+[[ nodiscard ]] std::errc
+validate_node_count( const uint32_t node_count ) noexcept
+{
+    if ( node_count < 2 || node_count % 2 != 0 )
+    {
+        return std::errc::argument_out_of_domain;
+    }
+
+    if ( node_count > max_node_count )
+    {
+        return std::errc::value_too_large;
+    }
+
+    return std::errc { };
+}
+
+[[ nodiscard ]] std::errc
+validate_processes_per_node( const uint32_t processes_per_node ) noexcept
+{
+    if ( processes_per_node < 1 )
+    {
+        return std::errc::argument_out_of_domain;
+    }
+
+    if ( processes_per_node > max_processes_per_node || processes_per_node > ports_per_node_range )
+    {
+        return std::errc::value_too_large;
+    }
+
+    return std::errc { };
+}
+
+void
+set_node_count( const uint32_t node_count ) noexcept
+{
+    configured_node_count = node_count;
+}
+
+void
+set_processes_per_node( const uint32_t processes_per_node ) noexcept
+{
+    configured_processes_per_node = processes_per_node;
+}
+
+void
+set_topology( topology_t&& topology )
+{
+    configured_topology = std::move( topology );
+}
+
+[[ nodiscard ]] topology_t
+generate_topology( const uint32_t node_count, const uint32_t processes_per_node )
+{
+    topology_t topology { };
+
+    topology.nodes.reserve( node_count );
+    topology.processes.reserve( size_t { node_count } * processes_per_node );
+    topology.connections.reserve( size_t { node_count / 2 } * processes_per_node );
+    topology.protocols.assign( std::cbegin( builtin_protocols ), std::cend( builtin_protocols ) );
+
+    for ( auto node_idx { 0u }; node_idx < node_count; ++node_idx )
+    {
+        const auto node_parity { node_idx % 2 };
+
+        node_t node { };
+        node.node_num = node_idx + 1;
+        node.first_process_idx = node_idx * processes_per_node;
+        node.process_count = processes_per_node;
+        node.first_port_num = first_node_first_port_num + node_idx * ports_per_node_range;
+        node.transport_to_channel_delay = transport_to_layer_default_delays[ node_parity ];
+        node.transport_from_channel_delay = transport_from_layer_default_delays[ node_parity ];
+        topology.nodes.push_back( node );
+
+        for ( auto process_idx { 0u }; process_idx < processes_per_node; ++process_idx )
+        {
+            process_spec_t process { };
+            process.node_idx = node_idx;
+            process.process_num = process_idx + 1;
+            process.port_num = node.first_port_num + process_idx;
+            process.application_delay = application_layer_default_delays[ node_parity ][ process_idx % 2 ];
+            topology.processes.push_back( process );
+        }
+    }
+
+    for ( auto node_idx { 0u }; node_idx < node_count; node_idx += 2 )
+    {
+        const auto& initiating_node { topology.nodes[ node_idx ] };
+        const auto& responding_node { topology.nodes[ node_idx + 1 ] };
+
+        for ( auto process_idx { 0u }; process_idx < processes_per_node; ++process_idx )
+        {
+            connection_spec_t connection { };
+            connection.initiator_process_idx = initiating_node.first_process_idx + process_idx;
+            connection.responder_process_idx = responding_node.first_process_idx +
+                                               ( processes_per_node - 1 - process_idx );
+            connection.protocol_idx = process_idx % static_cast<uint32_t>( std::size( builtin_protocols ) );
+            topology.connections.push_back( connection );
+        }
+    }
+
+    return topology;
+}
+
+[[ nodiscard ]] topology_t
+generate_topology( )
+{
+    if ( configured_topology.has_value( ) )
+    {
+        return *configured_topology;
+    }
+
+    return generate_topology( configured_node_count, configured_processes_per_node );
+}
+
+[[ nodiscard ]] std::size_t
+get_memory_footprint( const topology_t& topology ) noexcept
+{
+    return sizeof( topology ) +
+           topology.nodes.capacity( ) * sizeof( node_t ) +
+           topology.processes.capacity( ) * sizeof( process_spec_t ) +
+           topology.connections.capacity( ) * sizeof( connection_spec_t ) +
+           topology.protocols.capacity( ) * sizeof( application_protocol_t );
+}
+
+}
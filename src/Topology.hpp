@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <array>
+#include <span>
+#include <ranges>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <system_error>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace simple_network_simulation
+{
+
+inline constexpr std::size_t payload_value_count { std::size_t { std::numeric_limits<std::uint8_t>::max( ) } + 1 };
+inline constexpr std::size_t max_request_count { payload_value_count };
+
+// The dialogue held over a connection: the opening process sends the request payloads
+// in order (repeating the last one), the accepting process answers each request with
+// the matching response (or with the default one), and the opening process closes the
+// connection once it receives the closing payload. Both are laid out as dense tables,
+// so that either process finds its next payload with a single lookup.
+struct [[ nodiscard ]] application_protocol_t
+{
+    // Indexed by the request counter, with the last request filling the rest.
+    std::array<std::uint8_t, max_request_count> request_payloads;
+    // Indexed by the payload of the received request.
+    std::array<std::uint8_t, payload_value_count> response_payloads;
+    std::uint32_t request_count;
+    std::uint8_t closing_payload;
+};
+
+// Builds the tables of a protocol out of its requests (of which there must be at least
+// one and at most max_request_count), the pairs of a request and its response (where
+// the first pair of a request wins), and the response to the requests without a pair.
+[[ nodiscard ]] constexpr application_protocol_t
+make_application_protocol( const std::span<const std::uint8_t> request_payloads,
+                           const std::span<const std::pair<std::uint8_t, std::uint8_t>> response_payloads,
+                           const std::uint8_t default_response_payload, const std::uint8_t closing_payload ) noexcept
+{
+    application_protocol_t protocol { };
+    const auto request_count { std::min( std::size( request_payloads ), max_request_count ) };
+
+    for ( auto request_idx { 0uz }; request_idx < max_request_count; ++request_idx )
+    {
+        protocol.request_payloads[ request_idx ] = request_payloads[ std::min( request_idx, request_count - 1 ) ];
+    }
+
+    protocol.response_payloads.fill( default_response_payload );
+
+    for ( const auto& [ request_payload, response_payload ] : response_payloads | std::views::reverse )
+    {
+        protocol.response_payloads[ request_payload ] = response_payload;
+    }
+
+    protocol.request_count = static_cast<std::uint32_t>( request_count );
+    protocol.closing_payload = closing_payload;
+
+    return protocol;
+}
+
+// The ports of the processes of a node are numbered consecutively starting from
+// first_port_num, so a port number maps to the port index carried by the segments.
+struct [[ nodiscard ]] node_t
+{
+    std::uint32_t node_num;
+    std::uint32_t first_process_idx;
+    std::uint32_t process_count;
+    std::uint32_t first_port_num;
+    std::chrono::milliseconds transport_to_channel_delay;
+    std::chrono::milliseconds transport_from_channel_delay;
+};
+
+struct [[ nodiscard ]] process_spec_t
+{
+    std::uint32_t node_idx;
+    std::uint32_t process_num;
+    std::uint32_t port_num;
+    std::chrono::milliseconds application_delay;
+};
+
+struct [[ nodiscard ]] connection_spec_t
+{
+    std::uint32_t initiator_process_idx;
+    std::uint32_t responder_process_idx;
+    std::uint32_t protocol_idx;
+};
+
+struct [[ nodiscard ]] topology_t
+{
+    std::vector<node_t> nodes;
+    std::vector<process_spec_t> processes;
+    std::vector<connection_spec_t> connections;
+    std::vector<application_protocol_t> protocols;
+};
+
+inline constexpr std::uint32_t default_node_count { 2 };
+inline constexpr std::uint32_t default_processes_per_node { 2 };
+
+[[ nodiscard ]] std::errc
+validate_node_count( const std::uint32_t node_count ) noexcept;
+
+[[ nodiscard ]] std::errc
+validate_processes_per_node( const std::uint32_t processes_per_node ) noexcept;
+
+void
+set_node_count( const std::uint32_t node_count ) noexcept;
+
+void
+set_processes_per_node( const std::uint32_t processes_per_node ) noexcept;
+
+// Lays out the nodes in pairs (node1 with node2, node3 with node4, ...) and connects
+// the i-th process of the first node of each pair with the i-th last process of the
+// second one, which for the default dimensions yields the original 4 processes across
+// 2 nodes with their original ports, delays and dialogues.
+[[ nodiscard ]] topology_t
+generate_topology( const std::uint32_t node_count, const std::uint32_t processes_per_node );
+
+[[ nodiscard ]] topology_t
+generate_topology( );
+
+// Makes generate_topology( ) return the given topology, e.g. that of a loaded scenario,
+// instead of one of the configured dimensions.
+void
+set_topology( topology_t&& topology );
+
+[[ nodiscard ]] std::size_t
+get_memory_footprint( const topology_t& topology ) noexcept;
+
+}
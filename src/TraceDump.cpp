@@ -0,0 +1,191 @@
+
+#include <string_view>
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <stdexcept>
+#include <exception>
+#include <utility>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstddef>
+#include <fmt/core.h>
+#include "BidirectionalMultimessageSimulation.hpp"
+#include "BinaryTrace.hpp"
+
+
+namespace sns = simple_network_simulation;
+
+namespace
+{
+
+using std::string_view_literals::operator""sv;
+
+constexpr auto tool_name { "sns-trace-dump"sv };
+
+struct thread_record_t
+{
+    sns::trace_record_t record;
+    std::uint32_t thread_ordinal;
+};
+
+struct trace_t
+{
+    sns::trace_file_header_t header;
+    std::vector<thread_record_t> records;
+    std::uint32_t thread_count;
+};
+
+[[ nodiscard ]] std::string_view
+get_event_name( const sns::trace_event_t event ) noexcept
+{
+    switch ( event )
+    {
+        case sns::trace_event_t::segment_encoded:         return "encoded"sv;
+        case sns::trace_event_t::segment_entered_channel: return "entered channel"sv;
+        case sns::trace_event_t::segment_left_channel:    return "left channel"sv;
+        case sns::trace_event_t::segment_decoded:         return "decoded"sv;
+        default:                                          return "unknown"sv;
+    }
+}
+
+[[ nodiscard ]] std::string_view
+get_detail_name( const sns::trace_record_t& record ) noexcept
+{
+    switch ( record.event )
+    {
+        case sns::trace_event_t::segment_entered_channel:
+        case sns::trace_event_t::segment_left_channel:
+            return record.detail == std::to_underlying( sns::channel_direction_t::forward ) ? "forward"sv
+                                                                                            : "backward"sv;
+        case sns::trace_event_t::segment_decoded:
+            switch ( static_cast<sns::segment_integrity_t>( record.detail ) )
+            {
+                case sns::segment_integrity_t::intact:    return "intact"sv;
+                case sns::segment_integrity_t::corrected: return "corrected"sv;
+                case sns::segment_integrity_t::corrupt:   return "corrupt"sv;
+                default:                                  return "unknown"sv;
+            }
+        case sns::trace_event_t::segment_encoded:
+        default:
+            return "-"sv;
+    }
+}
+
+// Reads the regions of the trace and merges the records of all the threads by their
+// wall-clock time; the records of a thread are in order within its regions already.
+[[ nodiscard ]] trace_t
+read_trace( const char* const path )
+{
+    std::ifstream file { path, std::ios::binary };
+    file.exceptions( std::ios::failbit | std::ios::badbit );
+
+    trace_t trace { };
+    file.read( reinterpret_cast<char*>( &trace.header ), sizeof( trace.header ) );
+
+    if ( trace.header.magic != sns::trace_file_header_t::expected_magic )
+    {
+        throw std::runtime_error { "not a binary trace of the simulator" };
+    }
+
+    if ( trace.header.version != sns::trace_file_header_t::current_version ||
+         trace.header.record_size != sizeof( sns::trace_record_t ) ||
+         trace.header.records_per_region != sns::BinaryTraceWriter::records_per_region )
+    {
+        throw std::runtime_error { "unsupported version of the trace format" };
+    }
+
+    std::vector<sns::trace_record_t> region_records( sns::BinaryTraceWriter::records_per_region );
+
+    for ( auto region_idx { 0u }; region_idx < trace.header.region_count; ++region_idx )
+    {
+        sns::trace_region_header_t region_header;
+        file.read( reinterpret_cast<char*>( &region_header ), sizeof( region_header ) );
+        file.read( reinterpret_cast<char*>( std::data( region_records ) ),
+                   static_cast<std::streamsize>( sizeof( sns::trace_record_t ) * std::size( region_records ) ) );
+
+        const auto record_count { std::min( region_header.record_count, sns::BinaryTraceWriter::records_per_region ) };
+
+        for ( const auto& record : std::span { std::data( region_records ), record_count } )
+        {
+            trace.records.emplace_back( record, region_header.thread_ordinal );
+        }
+
+        trace.thread_count = std::max( trace.thread_count, region_header.thread_ordinal + 1 );
+    }
+
+    std::ranges::stable_sort( trace.records, { }, [ ]( const auto& thread_record ) noexcept
+                                                  { return thread_record.record.wall_time_ns; } );
+
+    return trace;
+}
+
+void
+dump_trace( const trace_t& trace )
+{
+    const auto segment_bit_count { std::clamp( trace.header.segment_bit_count, 1u, 64u ) };
+    const auto segment_bit_mask { segment_bit_count == 64 ? ~std::uint64_t { 0 }
+                                                          : ( std::uint64_t { 1 } << segment_bit_count ) - 1 };
+
+    fmt::print( "{:>14} {:>16} {:>6} {:>10} {:>6}  {:<15} {:<9} {}\n",
+                "wall time (ns)", "sim. time (ns)", "thread", "connection", "node", "event", "detail", "segment" );
+
+    std::array<std::uint64_t, 4> event_counts { };
+    auto corrupt_count { 0uz };
+
+    for ( const auto& [ record, thread_ordinal ] : trace.records )
+    {
+        const auto node { record.node_num == 0 ? fmt::format( "{:>6}", "chan" ) : fmt::format( "{:>6}", record.node_num ) };
+
+        fmt::print( "{:>14} {:>16} {:>6} {:>10} {}  {:<15} {:<9} {:0{}b}\n",
+                    record.wall_time_ns, record.simulated_time_ns, thread_ordinal, record.connection_num, node,
+                    get_event_name( record.event ), get_detail_name( record ),
+                    record.segment_bits & segment_bit_mask, segment_bit_count );
+
+        if ( const auto event_idx { std::to_underlying( record.event ) }; event_idx < std::size( event_counts ) )
+        {
+            ++event_counts[ event_idx ];
+        }
+
+        if ( record.event == sns::trace_event_t::segment_decoded &&
+             record.detail == std::to_underlying( sns::segment_integrity_t::corrupt ) )
+        {
+            ++corrupt_count;
+        }
+    }
+
+    fmt::print( "\n{} records from {} threads: {} encoded, {} entered the channel, {} left it, {} decoded "
+                "({} of them corrupt); {} dropped for want of space in the file\n",
+                std::size( trace.records ), trace.thread_count, event_counts[ 0 ], event_counts[ 1 ],
+                event_counts[ 2 ], event_counts[ 3 ], corrupt_count, trace.header.dropped_record_count );
+}
+
+}
+
+
+int main( const int argc, const char* const* const argv )
+{
+    if ( argc != 2 )
+    {
+        fmt::print( stderr, "Usage: {} FILE\nPrint the binary trace recorded by the simulator's --trace-file.\n",
+                    tool_name );
+
+        return EXIT_FAILURE;
+    }
+
+    try
+    {
+        dump_trace( read_trace( argv[ 1 ] ) );
+    }
+    catch ( const std::exception& ex )
+    {
+        fmt::print( stderr, "{}: {}: {}\n", tool_name, argv[ 1 ], ex.what( ) );
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
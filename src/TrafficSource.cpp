@@ -0,0 +1,212 @@
+#include "TrafficSource.hpp"
+#include <array>
+#include <string_view>
+#include <charconv>
+#include <expected>
+#include <system_error>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include <cstdint>
+#include "ChannelFaults.hpp"
+
+
+using std::uint32_t;
+using std::uint64_t;
+
+namespace simple_network_simulation
+{
+
+namespace
+{
+
+using std::string_view_literals::operator""sv;
+
+// Indexed by traffic_pattern_t.
+constexpr std::array traffic_pattern_names { "cbr"sv, "poisson"sv, "onoff"sv };
+
+constexpr std::chrono::duration<double> default_mean_on_duration { 0.010 };
+constexpr std::chrono::duration<double> default_mean_off_duration { 0.090 };
+
+// The channel streams of a connection are selected by its incarnation in the upper half
+// of the stream number, which never gets anywhere near this one.
+constexpr uint64_t traffic_stream_tag { uint64_t { 0xFFFF'FFFF } << 32 };
+
+constinit traffic_model_t configured_traffic_model { traffic_pattern_t::poisson, 0.0,
+                                                     default_mean_on_duration, default_mean_off_duration };
+
+[[ nodiscard ]] std::expected<double, std::errc>
+parse_positive_number( const std::string_view text ) noexcept
+{
+    const auto text_end { std::data( text ) + std::size( text ) };
+    double value { };
+
+    if ( const auto [ ptr, ec ] { std::from_chars( std::data( text ), text_end, value ) };
+         ec != std::errc { } || ptr != text_end )
+    {
+        return std::unexpected { ec != std::errc { } ? ec : std::errc::invalid_argument };
+    }
+
+    if ( ( value > 0.0 && std::isfinite( value ) ) == false )
+    {
+        return std::unexpected { std::errc::argument_out_of_domain };
+    }
+
+    return value;
+}
+
+}
+
+
+[[ nodiscard ]] std::expected<traffic_model_t, std::errc>
+parse_traffic_model( std::string_view specification ) noexcept
+{
+    traffic_model_t model { traffic_pattern_t::poisson, 0.0, default_mean_on_duration, default_mean_off_duration };
+
+    while ( std::empty( specification ) == false )
+    {
+        const auto separator_pos { specification.find( ',' ) };
+        const auto pair { specification.substr( 0, separator_pos ) };
+        specification.remove_prefix( separator_pos == std::string_view::npos ? std::size( specification )
+                                                                             : separator_pos + 1 );
+
+        const auto equals_sign_pos { pair.find( '=' ) };
+
+        if ( equals_sign_pos == std::string_view::npos )
+        {
+            return std::unexpected { std::errc::invalid_argument };
+        }
+
+        const auto key { pair.substr( 0, equals_sign_pos ) };
+        const auto value_text { pair.substr( equals_sign_pos + 1 ) };
+
+        if ( key == "source"sv )
+        {
+            const auto it { std::ranges::find( traffic_pattern_names, value_text ) };
+
+            if ( it == std::cend( traffic_pattern_names ) )
+            {
+                return std::unexpected { std::errc::invalid_argument };
+            }
+
+            model.pattern = static_cast<traffic_pattern_t>( std::distance( std::cbegin( traffic_pattern_names ), it ) );
+
+            continue;
+        }
+
+        const auto value { parse_positive_number( value_text ) };
+
+        if ( value.has_value( ) == false )
+        {
+            return std::unexpected { value.error( ) };
+        }
+
+        if ( key == "rate"sv )
+        {
+            model.message_rate = *value;
+        }
+        else if ( key == "on"sv )
+        {
+            model.mean_on_duration = std::chrono::duration<double, std::milli> { *value };
+        }
+        else if ( key == "off"sv )
+        {
+            model.mean_off_duration = std::chrono::duration<double, std::milli> { *value };
+        }
+        else
+        {
+            return std::unexpected { std::errc::invalid_argument };
+        }
+    }
+
+    // There is no sensible default for the rate, which is what the benchmark is run for.
+    if ( model.message_rate == 0.0 )
+    {
+        return std::unexpected { std::errc::invalid_argument };
+    }
+
+    return model;
+}
+
+void
+set_traffic_model( const traffic_model_t& model ) noexcept
+{
+    configured_traffic_model = model;
+}
+
+[[ nodiscard ]] const traffic_model_t&
+get_traffic_model( ) noexcept
+{
+    return configured_traffic_model;
+}
+
+[[ nodiscard ]] std::string_view
+get_traffic_pattern_name( const traffic_pattern_t pattern ) noexcept
+{
+    return traffic_pattern_names[ std::to_underlying( pattern ) ];
+}
+
+TrafficSource::TrafficSource( const traffic_model_t& model, const uint32_t connection_idx )
+    : m_model { model },
+      m_generator { get_random_seed( ), traffic_stream_tag | connection_idx },
+      m_interval { 1.0 / model.message_rate },
+      m_send_time { },
+      m_on_period_end { }
+{
+    if ( m_model.pattern != traffic_pattern_t::poisson )
+    {
+        m_send_time = -sample_uniform( ) * m_interval;
+    }
+
+    if ( m_model.pattern == traffic_pattern_t::on_off )
+    {
+        m_on_period_end = sample_exponential( m_model.mean_on_duration.count( ) );
+    }
+}
+
+[[ nodiscard ]] std::chrono::nanoseconds
+TrafficSource::get_next_send_time( ) noexcept
+{
+    switch ( m_model.pattern )
+    {
+        case traffic_pattern_t::constant_bit_rate:
+            m_send_time += m_interval;
+            break;
+
+        case traffic_pattern_t::poisson:
+            m_send_time += sample_exponential( m_interval );
+            break;
+
+        case traffic_pattern_t::on_off:
+            m_send_time += m_interval;
+
+            // The off periods skip the source ahead to the start of the next on period,
+            // whose first message goes out at once.
+            while ( m_send_time >= m_on_period_end )
+            {
+                m_send_time = m_on_period_end + sample_exponential( m_model.mean_off_duration.count( ) );
+                m_on_period_end = m_send_time + sample_exponential( m_model.mean_on_duration.count( ) );
+            }
+
+            break;
+
+        default:
+            break;
+    }
+
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::duration<double> { m_send_time } );
+}
+
+[[ nodiscard ]] double
+TrafficSource::sample_uniform( ) noexcept
+{
+    return ( static_cast<double>( m_generator( ) ) + 0.5 ) * 0x1p-32;
+}
+
+[[ nodiscard ]] double
+TrafficSource::sample_exponential( const double mean ) noexcept
+{
+    return -std::log( sample_uniform( ) ) * mean;
+}
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <string_view>
+#include <expected>
+#include <system_error>
+#include <cstdint>
+#include "Random.hpp"
+
+
+namespace simple_network_simulation
+{
+
+enum class traffic_pattern_t : std::uint8_t
+{
+    constant_bit_rate,  // a message every 1 / rate seconds
+    poisson,            // exponentially distributed gaps of 1 / rate seconds on average
+    on_off              // a message every 1 / rate seconds during on periods, none during off periods
+};
+
+// The schedule on which the opening process of every connection sends its requests in
+// the open-loop benchmark, whether or not the responses to the previous ones are back.
+// The on and off periods last for exponentially distributed times of the given means.
+struct [[ nodiscard ]] traffic_model_t
+{
+    traffic_pattern_t pattern;
+    double message_rate;    // messages per second of each connection (while on)
+    std::chrono::duration<double> mean_on_duration;
+    std::chrono::duration<double> mean_off_duration;
+};
+
+// Parses a comma-separated list of KEY=VALUE pairs such as "source=poisson,rate=20000",
+// with the keys source (cbr, poisson or onoff), rate (in messages per second), and on
+// and off (the mean durations of the periods of onoff, in milliseconds). The source
+// defaults to poisson, and the periods to 10 ms on and 90 ms off.
+[[ nodiscard ]] std::expected<traffic_model_t, std::errc>
+parse_traffic_model( const std::string_view specification ) noexcept;
+
+void
+set_traffic_model( const traffic_model_t& model ) noexcept;
+
+[[ nodiscard ]] const traffic_model_t&
+get_traffic_model( ) noexcept;
+
+[[ nodiscard ]] std::string_view
+get_traffic_pattern_name( const traffic_pattern_t pattern ) noexcept;
+
+// The send times of the requests of a connection, as offsets from the start of the run.
+// They are drawn from a random stream keyed on the seed of the run and selected by the
+// connection, so they only depend on the model, the seed and the connection and never
+// on when the requests actually manage to go out. A constant rate is given a random
+// phase so that the connections do not all send at the same instants.
+class TrafficSource
+{
+public:
+    TrafficSource( const traffic_model_t& model, const std::uint32_t connection_idx );
+
+    [[ nodiscard ]] std::chrono::nanoseconds
+    get_next_send_time( ) noexcept;
+
+private:
+    [[ nodiscard ]] double
+    sample_uniform( ) noexcept;
+
+    [[ nodiscard ]] double
+    sample_exponential( const double mean ) noexcept;
+
+    traffic_model_t m_model;
+    util::Philox4x32 m_generator;
+    double m_interval;          // in seconds, as the times below
+    double m_send_time;
+    double m_on_period_end;
+};
+
+}